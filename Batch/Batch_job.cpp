@@ -0,0 +1,288 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Batch_job.h>
+#include <Availability_grid.h>
+#include <Path_planner.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+Batch_job::Batch_job() : width(0), height(0), board_set(false)
+{
+}
+
+Batch_job::~Batch_job()
+{
+}
+
+bool Batch_job::read(std::istream& input)
+{
+    width = 0;
+    height = 0;
+    board_set = false;
+    blocked_rectangles.clear();
+    nets.clear();
+
+    // The halo radius used by the widget
+    size_t halo_radius = 1;
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line))
+    {
+        line_number++;
+
+        // Remove comments
+        const size_t comment_position = line.find('#');
+        if (comment_position != std::string::npos)
+        {
+            line.erase(comment_position);
+        }
+
+        std::istringstream line_stream(line);
+        std::string command;
+        if (not (line_stream >> command))
+        {
+            // Empty line
+            continue;
+        }
+
+        // Read all numbers after the command
+        std::vector<size_t> numbers;
+        std::string name;
+        if (command == "net" && not (line_stream >> name))
+        {
+            std::cerr << "ERROR: Line " << line_number << ": Net name missing" << std::endl;
+            return false;
+        }
+        std::string argument;
+        while (line_stream >> argument)
+        {
+            std::istringstream argument_stream(argument);
+            size_t number;
+            if (argument[0] == '-' || not (argument_stream >> number) || not argument_stream.eof())
+            {
+                std::cerr << "ERROR: Line " << line_number << ": Invalid number '" << argument << "'" << std::endl;
+                return false;
+            }
+            numbers.push_back(number);
+        }
+
+        if (command != "board" && not board_set)
+        {
+            std::cerr << "ERROR: Line " << line_number << ": The board must be set first" << std::endl;
+            return false;
+        }
+
+        if (command == "board" && numbers.size() == 2 && not board_set)
+        {
+            // The points on the board are stored as 32 bit coordinates
+            if (numbers[0] > std::numeric_limits<uint32_t>::max() || numbers[1] > std::numeric_limits<uint32_t>::max())
+            {
+                std::cerr << "ERROR: Line " << line_number << ": The board is too large" << std::endl;
+                return false;
+            }
+            width = numbers[0];
+            height = numbers[1];
+            board_set = true;
+        }
+        else if (command == "block" && numbers.size() == 2)
+        {
+            if (not check_point(numbers[0], numbers[1], line_number))
+            {
+                return false;
+            }
+            blocked_rectangles.push_back(Coord_rectangle_2D(numbers[0], numbers[1], numbers[0], numbers[1]));
+        }
+        else if (command == "block" && numbers.size() == 4)
+        {
+            // Check the corners before they are narrowed to 32 bit coordinates
+            if (not check_point(numbers[0], numbers[1], line_number) ||
+                not check_point(numbers[2], numbers[3], line_number))
+            {
+                return false;
+            }
+            const Coord_rectangle_2D rectangle(numbers[0], numbers[1], numbers[2], numbers[3]);
+            if (rectangle.is_empty())
+            {
+                std::cerr << "ERROR: Line " << line_number << ": Invalid rectangle" << std::endl;
+                return false;
+            }
+            blocked_rectangles.push_back(rectangle);
+        }
+        else if (command == "halo" && numbers.size() == 1)
+        {
+            if (not check_halo_radius(numbers[0], line_number))
+            {
+                return false;
+            }
+            halo_radius = numbers[0];
+        }
+        else if (command == "net" && (numbers.size() == 4 || numbers.size() == 5))
+        {
+            // Check the end points before they are narrowed to 32 bit coordinates
+            if (not check_point(numbers[0], numbers[1], line_number) ||
+                not check_point(numbers[2], numbers[3], line_number) ||
+                (numbers.size() == 5 && not check_halo_radius(numbers[4], line_number)))
+            {
+                return false;
+            }
+            Net net;
+            net.name = name;
+            net.start = Coord_point_2D(numbers[0], numbers[1]);
+            net.end = Coord_point_2D(numbers[2], numbers[3]);
+            net.halo_radius = numbers.size() == 5 ? numbers[4] : halo_radius;
+            nets.push_back(net);
+        }
+        else
+        {
+            std::cerr << "ERROR: Line " << line_number << ": Unknown command or wrong number of arguments: " << command
+                      << std::endl;
+            return false;
+        }
+    }
+
+    if (not board_set)
+    {
+        std::cerr << "ERROR: No board in batch job" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+size_t Batch_job::get_width() const
+{
+    return width;
+}
+
+size_t Batch_job::get_height() const
+{
+    return height;
+}
+
+const std::vector<Coord_rectangle_2D>& Batch_job::get_blocked_rectangles() const
+{
+    return blocked_rectangles;
+}
+
+const std::vector<Batch_job::Net>& Batch_job::get_nets() const
+{
+    return nets;
+}
+
+std::shared_ptr<Availability_grid> Batch_job::create_availability_grid() const
+{
+    std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(width, height);
+
+    for (const Coord_rectangle_2D& rectangle : blocked_rectangles)
+    {
+        for (size_t y = rectangle.get_min_y(); y <= rectangle.get_max_y(); y++)
+        {
+            for (size_t x = rectangle.get_min_x(); x <= rectangle.get_max_x(); x++)
+            {
+                availability_grid->set_blocked(x, y);
+            }
+        }
+    }
+
+    return availability_grid;
+}
+
+void Batch_job::route(Path_planner& path_planner, std::vector<Net_result>& results) const
+{
+    results.clear();
+    results.reserve(nets.size());
+
+    for (const Net& net : nets)
+    {
+        Net_result result;
+
+        const auto start_time = std::chrono::steady_clock::now();
+        result.path_found = path_planner.get_path(net.start, net.end, result.path);
+        if (result.path_found)
+        {
+            // Commit the path like the widget does, later nets can not cross it or its halo
+            path_planner.commit_path(result.path, net.halo_radius);
+        }
+        else
+        {
+            result.path.clear();
+        }
+        const auto end_time = std::chrono::steady_clock::now();
+        result.time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+        results.push_back(result);
+    }
+}
+
+void Batch_job::write_results(std::ostream& output, const std::vector<Net_result>& results) const
+{
+    size_t number_of_found_paths = 0;
+    double total_time_ms = 0;
+
+    // One line per net: name, found or failed, time in ms, number of points and the points
+    for (size_t i = 0; i < nets.size() && i < results.size(); i++)
+    {
+        const Net_result& result = results[i];
+        output << nets[i].name << " " << (result.path_found ? "found" : "failed") << " " << result.time_ms << " ms "
+               << result.path.size();
+        for (const Coord_point_2D& point : result.path)
+        {
+            output << " " << point.get_x() << "," << point.get_y();
+        }
+        output << "\n";
+
+        number_of_found_paths += result.path_found ? 1 : 0;
+        total_time_ms += result.time_ms;
+    }
+
+    output << "# " << number_of_found_paths << " of " << results.size() << " nets routed in " << total_time_ms
+           << " ms";
+    if (total_time_ms > 0)
+    {
+        output << ", " << results.size() / (total_time_ms / 1000.0) << " nets/s";
+    }
+    output << std::endl;
+}
+
+bool Batch_job::check_point(const size_t x, const size_t y, const size_t line_number) const
+{
+    if (x >= width || y >= height)
+    {
+        std::cerr << "ERROR: Line " << line_number << ": Point (x, y): (" << x << ", " << y << ") is outside the board"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Batch_job::check_halo_radius(const size_t halo_radius, const size_t line_number) const
+{
+    if (halo_radius >= std::max(width, height))
+    {
+        std::cerr << "ERROR: Line " << line_number << ": Halo radius " << halo_radius << " is larger than the board"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_BATCH_BATCH_JOB_H_
+#define LINE_ROUTER_BATCH_BATCH_JOB_H_
+
+#include <Availability_grid.h>
+#include <Path_planner.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A batch job is a board and an ordered list of nets that are routed without any UI. It is read from a text file with
+// one command per line. Empty lines and everything after a # are ignored.
+//
+//   board <width> <height>                  The size of the board. Must come before all other commands.
+//   block <x> <y>                           Block a point.
+//   block <min_x> <min_y> <max_x> <max_y>   Block a rectangle, both corners included.
+//   halo <radius>                           The halo radius of the following nets, 1 if not given. A radius must be
+//                                           smaller than the larger of the board width and height.
+//   net <name> <x> <y> <x> <y> [radius]     A net from start point to end point with an optional halo radius.
+//
+// The nets are routed in the order they are listed. Like in the Line_router_paint_widget every found path is committed
+// to the path planner with its halo before the next net is routed, and a net without a path leaves the board as it is.
+class Batch_job
+{
+public:
+    struct Net
+    {
+        std::string name;
+        Coord_point_2D start;
+        Coord_point_2D end;
+        size_t halo_radius;
+    };
+
+    struct Net_result
+    {
+        bool path_found;
+        std::vector<Coord_point_2D> path;
+        // Time to find and commit the path
+        double time_ms;
+    };
+
+    Batch_job();
+    virtual ~Batch_job();
+
+    // Read a job from input. Errors are printed with their line number and false is returned.
+    bool read(std::istream& input);
+
+    size_t get_width() const;
+    size_t get_height() const;
+    const std::vector<Coord_rectangle_2D>& get_blocked_rectangles() const;
+    const std::vector<Net>& get_nets() const;
+
+    // Create the availability grid of the board with all blocked rectangles set
+    std::shared_ptr<Availability_grid> create_availability_grid() const;
+
+    // Route all nets in order with path_planner, which must use an availability grid of the board. The result of every
+    // net is put in results in the same order as the nets.
+    void route(Path_planner& path_planner, std::vector<Net_result>& results) const;
+
+    // Write one line per net with its result, time and path followed by a summary line
+    void write_results(std::ostream& output, const std::vector<Net_result>& results) const;
+
+private:
+    size_t width;
+    size_t height;
+    bool board_set;
+
+    std::vector<Coord_rectangle_2D> blocked_rectangles;
+    std::vector<Net> nets;
+
+    // Check that the point is on the board, print an error if not. The coordinates are checked as read, i.e. before
+    // they are narrowed to the 32 bit coordinates of Coord_point_2D
+    bool check_point(const size_t x, const size_t y, const size_t line_number) const;
+
+    // Check that the halo radius is smaller than the board, print an error if not. A larger halo would block the whole
+    // board anyway.
+    bool check_halo_radius(const size_t halo_radius, const size_t line_number) const;
+};
+
+#endif // LINE_ROUTER_BATCH_BATCH_JOB_H_
@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Moving_ai_map.h>
+#include <Availability_grid.h>
+
+// Standard library headers
+#include <cstddef>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+Moving_ai_map::Moving_ai_map() : width(0), height(0)
+{
+}
+
+Moving_ai_map::~Moving_ai_map()
+{
+}
+
+bool Moving_ai_map::read(std::istream& input)
+{
+    width = 0;
+    height = 0;
+    availability_grid.reset();
+
+    size_t new_width = 0;
+    size_t new_height = 0;
+
+    // Read the header until the map line
+    std::string line;
+    size_t line_number = 0;
+    bool map_found = false;
+    while (not map_found && std::getline(input, line))
+    {
+        line_number++;
+
+        std::istringstream line_stream(line);
+        std::string keyword;
+        if (not (line_stream >> keyword))
+        {
+            continue;
+        }
+
+        std::string value;
+        if (keyword == "map")
+        {
+            map_found = true;
+        }
+        else if (keyword == "type" && line_stream >> value)
+        {
+            if (value != "octile")
+            {
+                std::cerr << "ERROR: Line " << line_number << ": Unsupported map type '" << value << "'" << std::endl;
+                return false;
+            }
+        }
+        else if ((keyword == "height" && line_stream >> new_height) || (keyword == "width" && line_stream >> new_width))
+        {
+            continue;
+        }
+        else
+        {
+            std::cerr << "ERROR: Line " << line_number << ": Invalid map header: " << line << std::endl;
+            return false;
+        }
+    }
+
+    if (not map_found || new_width == 0 || new_height == 0)
+    {
+        std::cerr << "ERROR: The map header must have a width, a height and a map line" << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<Availability_grid> new_availability_grid = std::make_shared<Availability_grid>(new_width,
+                                                                                                    new_height);
+
+    for (size_t y = 0; y < new_height; y++)
+    {
+        line_number++;
+        if (not std::getline(input, line))
+        {
+            std::cerr << "ERROR: The map has " << y << " rows, expected " << new_height << std::endl;
+            return false;
+        }
+
+        // Maps written on Windows have carriage returns
+        if (not line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.size() != new_width)
+        {
+            std::cerr << "ERROR: Line " << line_number << ": The row has " << line.size() << " points, expected "
+                      << new_width << std::endl;
+            return false;
+        }
+
+        for (size_t x = 0; x < new_width; x++)
+        {
+            const char point = line[x];
+            if (point != '.' && point != 'G' && point != 'S')
+            {
+                new_availability_grid->set_blocked(x, y);
+            }
+        }
+    }
+
+    width = new_width;
+    height = new_height;
+    availability_grid = new_availability_grid;
+
+    return true;
+}
+
+size_t Moving_ai_map::get_width() const
+{
+    return width;
+}
+
+size_t Moving_ai_map::get_height() const
+{
+    return height;
+}
+
+std::shared_ptr<Availability_grid> Moving_ai_map::get_availability_grid() const
+{
+    return availability_grid;
+}
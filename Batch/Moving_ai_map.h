@@ -0,0 +1,50 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_BATCH_MOVING_AI_MAP_H_
+#define LINE_ROUTER_BATCH_MOVING_AI_MAP_H_
+
+#include <Availability_grid.h>
+
+// Standard library headers
+#include <cstddef>
+#include <istream>
+#include <memory>
+
+// A map in the Moving AI grid map format (.map), used by the standard path finding benchmark corpora. The file has a
+// header followed by one line of characters per row
+//
+//   type octile
+//   height <height>
+//   width <width>
+//   map
+//   <height lines of width characters>
+//
+// The points '.', 'G' and 'S' are available, all other points ('@', 'O', 'T', 'W') are blocked.
+class Moving_ai_map
+{
+public:
+    Moving_ai_map();
+    virtual ~Moving_ai_map();
+
+    // Read a map from input. Errors are printed with their line number and false is returned.
+    bool read(std::istream& input);
+
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Get the availability grid of the map. It is null until a map has been read.
+    std::shared_ptr<Availability_grid> get_availability_grid() const;
+
+private:
+    size_t width;
+    size_t height;
+    std::shared_ptr<Availability_grid> availability_grid;
+};
+
+#endif // LINE_ROUTER_BATCH_MOVING_AI_MAP_H_
@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Moving_ai_scenario.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+Moving_ai_scenario::Moving_ai_scenario()
+{
+}
+
+Moving_ai_scenario::~Moving_ai_scenario()
+{
+}
+
+bool Moving_ai_scenario::read(std::istream& input)
+{
+    queries.clear();
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line))
+    {
+        line_number++;
+
+        std::istringstream line_stream(line);
+        std::string first_word;
+        if (not (line_stream >> first_word))
+        {
+            // Empty line
+            continue;
+        }
+
+        if (first_word == "version")
+        {
+            if (line_number != 1)
+            {
+                std::cerr << "ERROR: Line " << line_number << ": The version must be on the first line" << std::endl;
+                return false;
+            }
+            continue;
+        }
+
+        Query query;
+        size_t start_x;
+        size_t start_y;
+        size_t goal_x;
+        size_t goal_y;
+        std::istringstream bucket_stream(first_word);
+        std::string rest;
+        if (not (bucket_stream >> query.bucket) || not bucket_stream.eof() ||
+            not (line_stream >> query.map_name >> query.map_width >> query.map_height >> start_x >> start_y >> goal_x
+                             >> goal_y >> query.optimal_length) ||
+            line_stream >> rest)
+        {
+            std::cerr << "ERROR: Line " << line_number << ": Invalid query: " << line << std::endl;
+            return false;
+        }
+
+        if (start_x >= query.map_width || start_y >= query.map_height || goal_x >= query.map_width ||
+            goal_y >= query.map_height)
+        {
+            std::cerr << "ERROR: Line " << line_number << ": Point outside the map" << std::endl;
+            return false;
+        }
+
+        query.start = Coord_point_2D(start_x, start_y);
+        query.goal = Coord_point_2D(goal_x, goal_y);
+        queries.push_back(query);
+    }
+
+    return true;
+}
+
+const std::vector<Moving_ai_scenario::Query>& Moving_ai_scenario::get_queries() const
+{
+    return queries;
+}
+
+std::vector<std::string> Moving_ai_scenario::get_map_names() const
+{
+    std::vector<std::string> map_names;
+    for (const Query& query : queries)
+    {
+        if (std::find(map_names.begin(), map_names.end(), query.map_name) == map_names.end())
+        {
+            map_names.push_back(query.map_name);
+        }
+    }
+
+    return map_names;
+}
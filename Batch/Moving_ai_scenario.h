@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_BATCH_MOVING_AI_SCENARIO_H_
+#define LINE_ROUTER_BATCH_MOVING_AI_SCENARIO_H_
+
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// A scenario in the Moving AI scenario format (.scen). The file starts with an optional version line followed by one
+// query per line
+//
+//   version 1
+//   <bucket> <map file> <map width> <map height> <start x> <start y> <goal x> <goal y> <optimal length>
+//
+// The optimal length is the cost of the shortest path with horizontal and vertical moves costing 1 and diagonal moves
+// costing sqrt(2). The queries are grouped in buckets of similar optimal length.
+class Moving_ai_scenario
+{
+public:
+    struct Query
+    {
+        size_t bucket;
+        std::string map_name;
+        size_t map_width;
+        size_t map_height;
+        Coord_point_2D start;
+        Coord_point_2D goal;
+        double optimal_length;
+    };
+
+    Moving_ai_scenario();
+    virtual ~Moving_ai_scenario();
+
+    // Read a scenario from input. Errors are printed with their line number and false is returned.
+    bool read(std::istream& input);
+
+    const std::vector<Query>& get_queries() const;
+
+    // Get the names of the maps used by the queries in the order they are first used
+    std::vector<std::string> get_map_names() const;
+
+private:
+    std::vector<Query> queries;
+};
+
+#endif // LINE_ROUTER_BATCH_MOVING_AI_SCENARIO_H_
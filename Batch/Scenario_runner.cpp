@@ -0,0 +1,191 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Scenario_runner.h>
+#include <Availability_grid.h>
+#include <Moving_ai_scenario.h>
+#include <Path_planner.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Get the nearest rank percentile of sorted values
+double get_percentile(const std::vector<double>& sorted_values, const double percentile)
+{
+    if (sorted_values.empty())
+    {
+        return 0;
+    }
+
+    const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted_values.size()));
+    return sorted_values[rank > 0 ? rank - 1 : 0];
+}
+
+} // namespace
+
+Scenario_runner::Scenario_runner(Path_planner& path_planner) : path_planner(path_planner)
+{
+}
+
+Scenario_runner::~Scenario_runner()
+{
+}
+
+bool Scenario_runner::run(const std::vector<Moving_ai_scenario::Query>& queries,
+                          const Maps& maps,
+                          std::vector<Query_result>& results)
+{
+    results.clear();
+    results.reserve(queries.size());
+
+    // The expansions are taken from the search statistics
+    path_planner.set_search_statistics_enabled(true);
+
+    std::shared_ptr<Availability_grid> current_map;
+    std::vector<Coord_point_2D> path;
+    for (const Moving_ai_scenario::Query& query : queries)
+    {
+        const Maps::const_iterator map = maps.find(query.map_name);
+        if (map == maps.end() || not map->second)
+        {
+            std::cerr << "ERROR: Map " << query.map_name << " is not loaded" << std::endl;
+            return false;
+        }
+
+        if (map->second != current_map)
+        {
+            if (map->second->get_width() != query.map_width || map->second->get_height() != query.map_height)
+            {
+                std::cerr << "ERROR: Map " << query.map_name << " is " << map->second->get_width() << " x "
+                          << map->second->get_height() << ", the scenario expects " << query.map_width << " x "
+                          << query.map_height << std::endl;
+                return false;
+            }
+
+            current_map = map->second;
+            path_planner.set_availability_grid(current_map);
+        }
+
+        Query_result result;
+
+        const auto start_time = std::chrono::steady_clock::now();
+        result.path_found = path_planner.get_path(query.start, query.goal, path);
+        const auto end_time = std::chrono::steady_clock::now();
+
+        result.time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        result.expansions = path_planner.get_search_statistics().number_of_expanded_points;
+        result.path_cost = result.path_found ? calculate_path_cost(path) : 0;
+
+        results.push_back(result);
+    }
+
+    return true;
+}
+
+void Scenario_runner::get_bucket_statistics(const std::vector<Moving_ai_scenario::Query>& queries,
+                                            const std::vector<Query_result>& results,
+                                            std::vector<Bucket_statistics>& statistics)
+{
+    statistics.clear();
+
+    // The indexes of the queries of every bucket
+    std::map<size_t, std::vector<size_t>> buckets;
+    for (size_t i = 0; i < queries.size() && i < results.size(); i++)
+    {
+        buckets[queries[i].bucket].push_back(i);
+    }
+
+    for (const std::pair<const size_t, std::vector<size_t>>& bucket : buckets)
+    {
+        Bucket_statistics bucket_statistics = {bucket.first, bucket.second.size(), 0, 0, 0, 0, 0, 0};
+
+        std::vector<double> times_ms;
+        double total_expansions = 0;
+        double total_suboptimality = 0;
+        for (const size_t i : bucket.second)
+        {
+            const Query_result& result = results[i];
+            times_ms.push_back(result.time_ms);
+            total_expansions += result.expansions;
+
+            if (result.path_found)
+            {
+                // A query from a point to itself has an optimal length of zero
+                const double optimal_length = queries[i].optimal_length;
+                const double suboptimality = optimal_length > 0 ? result.path_cost / optimal_length : 1;
+                bucket_statistics.number_of_paths_found++;
+                total_suboptimality += suboptimality;
+                bucket_statistics.max_suboptimality = std::max(bucket_statistics.max_suboptimality, suboptimality);
+            }
+        }
+
+        std::sort(times_ms.begin(), times_ms.end());
+        bucket_statistics.median_time_ms = get_percentile(times_ms, 50);
+        bucket_statistics.p99_time_ms = get_percentile(times_ms, 99);
+        bucket_statistics.mean_expansions = total_expansions / bucket.second.size();
+        if (bucket_statistics.number_of_paths_found > 0)
+        {
+            bucket_statistics.mean_suboptimality = total_suboptimality / bucket_statistics.number_of_paths_found;
+        }
+
+        statistics.push_back(bucket_statistics);
+    }
+}
+
+void Scenario_runner::write_bucket_statistics(std::ostream& output, const std::vector<Bucket_statistics>& statistics)
+{
+    output << "# bucket queries found median_ms p99_ms mean_expansions mean_suboptimality max_suboptimality\n";
+
+    size_t number_of_queries = 0;
+    size_t number_of_paths_found = 0;
+    for (const Bucket_statistics& bucket_statistics : statistics)
+    {
+        output << bucket_statistics.bucket << " " << bucket_statistics.number_of_queries << " "
+               << bucket_statistics.number_of_paths_found << " " << bucket_statistics.median_time_ms << " "
+               << bucket_statistics.p99_time_ms << " " << bucket_statistics.mean_expansions << " "
+               << bucket_statistics.mean_suboptimality << " " << bucket_statistics.max_suboptimality << "\n";
+
+        number_of_queries += bucket_statistics.number_of_queries;
+        number_of_paths_found += bucket_statistics.number_of_paths_found;
+    }
+
+    output << "# " << number_of_paths_found << " of " << number_of_queries << " queries found a path in "
+           << statistics.size() << " buckets" << std::endl;
+}
+
+double Scenario_runner::calculate_path_cost(const std::vector<Coord_point_2D>& path)
+{
+    const double diagonal_cost = std::sqrt(2.0);
+
+    double path_cost = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        const size_t dx = path[i].get_x() > path[i-1].get_x() ? path[i].get_x() - path[i-1].get_x()
+                                                              : path[i-1].get_x() - path[i].get_x();
+        const size_t dy = path[i].get_y() > path[i-1].get_y() ? path[i].get_y() - path[i-1].get_y()
+                                                              : path[i-1].get_y() - path[i].get_y();
+
+        // Octile distance between the points
+        path_cost += std::max(dx, dy) - std::min(dx, dy) + diagonal_cost * std::min(dx, dy);
+    }
+
+    return path_cost;
+}
@@ -0,0 +1,83 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_BATCH_SCENARIO_RUNNER_H_
+#define LINE_ROUTER_BATCH_SCENARIO_RUNNER_H_
+
+#include <Availability_grid.h>
+#include <Moving_ai_scenario.h>
+#include <Path_planner.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Runs the queries of a Moving AI scenario against a Path_planner and summarizes the results per bucket. Nothing is
+// committed, every query is routed on the map as it was loaded. The search statistics of the path planner are enabled
+// by run.
+class Scenario_runner
+{
+public:
+    struct Query_result
+    {
+        bool path_found;
+        double time_ms;
+        // Number of points expanded by the search, see Search_statistics. Zero if the statistics are not compiled in.
+        size_t expansions;
+        // Cost of the found path with the scenario metric, see calculate_path_cost
+        double path_cost;
+    };
+
+    struct Bucket_statistics
+    {
+        size_t bucket;
+        size_t number_of_queries;
+        size_t number_of_paths_found;
+        double median_time_ms;
+        double p99_time_ms;
+        double mean_expansions;
+        // Path cost divided by the optimal length of the scenario, over the found paths
+        double mean_suboptimality;
+        double max_suboptimality;
+    };
+
+    typedef std::map<std::string, std::shared_ptr<Availability_grid>> Maps;
+
+    Scenario_runner(Path_planner& path_planner);
+    virtual ~Scenario_runner();
+
+    // Run all queries in order. The availability grid of the path planner is set to the map of every query, all maps
+    // used by the queries must be in maps. The result of every query is put in results in the same order as the
+    // queries. Returns false if a map is missing or has another size than the query.
+    bool run(const std::vector<Moving_ai_scenario::Query>& queries,
+             const Maps& maps,
+             std::vector<Query_result>& results);
+
+    // Summarize the results per bucket, sorted by bucket
+    static void get_bucket_statistics(const std::vector<Moving_ai_scenario::Query>& queries,
+                                      const std::vector<Query_result>& results,
+                                      std::vector<Bucket_statistics>& statistics);
+
+    // Write one line per bucket followed by a summary line
+    static void write_bucket_statistics(std::ostream& output, const std::vector<Bucket_statistics>& statistics);
+
+    // Get the cost of a path with horizontal and vertical moves costing 1 and diagonal moves costing sqrt(2), which is
+    // the metric of the optimal lengths in the scenario files. Consecutive points may be further apart than one move,
+    // like the jump points of JPS, as long as they are on a horizontal, vertical or diagonal line.
+    static double calculate_path_cost(const std::vector<Coord_point_2D>& path);
+
+private:
+    Path_planner& path_planner;
+};
+
+#endif // LINE_ROUTER_BATCH_SCENARIO_RUNNER_H_
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Batch_job.h>
+#include <A_star_planner.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(Batch_job, Read)
+{
+    std::istringstream input("# A small board\n"
+                             "board 20 10\n"
+                             "\n"
+                             "block 3 4          # a point\n"
+                             "block 5 0 6 9\n"
+                             "net a 0 0 19 9\n"
+                             "halo 2\n"
+                             "net b 1 1 2 2 0\n"
+                             "net c 1 2 3 3\n");
+
+    Batch_job batch_job;
+    ASSERT_TRUE(batch_job.read(input));
+
+    EXPECT_EQ(batch_job.get_width(),  size_t(20));
+    EXPECT_EQ(batch_job.get_height(), size_t(10));
+
+    ASSERT_EQ(batch_job.get_blocked_rectangles().size(), size_t(2));
+    EXPECT_EQ(batch_job.get_blocked_rectangles().at(0), Coord_rectangle_2D(3, 4, 3, 4));
+    EXPECT_EQ(batch_job.get_blocked_rectangles().at(1), Coord_rectangle_2D(5, 0, 6, 9));
+
+    ASSERT_EQ(batch_job.get_nets().size(), size_t(3));
+    EXPECT_EQ(batch_job.get_nets().at(0).name, "a");
+    EXPECT_EQ(batch_job.get_nets().at(0).start, Coord_point_2D(0, 0));
+    EXPECT_EQ(batch_job.get_nets().at(0).end,   Coord_point_2D(19, 9));
+    EXPECT_EQ(batch_job.get_nets().at(0).halo_radius, size_t(1));
+    EXPECT_EQ(batch_job.get_nets().at(1).halo_radius, size_t(0));
+    EXPECT_EQ(batch_job.get_nets().at(2).halo_radius, size_t(2));
+
+    const std::shared_ptr<Availability_grid> availability_grid = batch_job.create_availability_grid();
+    EXPECT_FALSE(availability_grid->is_available(3, 4));
+    EXPECT_FALSE(availability_grid->is_available(6, 9));
+    EXPECT_TRUE(availability_grid->is_available(7, 9));
+}
+
+TEST(Batch_job, Read_errors)
+{
+    const std::vector<std::string> inputs = {"block 1 1\n",                  // No board
+                                             "board 10 10\nblock 10 0\n",    // Outside the board
+                                             "board 10 10\nblock 5 5 4 4\n", // Empty rectangle
+                                             "board 10 10\nnet a 0 0 1\n",   // Missing coordinate
+                                             "board 10 10\nnet a 0 0 -1 1\n",// Negative coordinate
+                                             "board 10 10\nroute 0 0 1 1\n", // Unknown command
+                                             // Coordinates that wrap around to the board when narrowed to 32 bits
+                                             "board 10 10\nblock 4294967297 0\n",
+                                             "board 10 10\nblock 4294967296 0 1 1\n",
+                                             "board 10 10\nnet a 0 4294967296 1 1\n",
+                                             "board 4294967296 1\n",         // Board too large
+                                             // Halo radius larger than the board, also one that wraps around when
+                                             // the limits of the halo are added
+                                             "board 10 5\nhalo 10\n",
+                                             "board 10 10\nnet a 0 0 1 1 18446744073709551615\n",
+                                             ""};                            // Empty job
+
+    for (const std::string& input : inputs)
+    {
+        std::istringstream input_stream(input);
+        Batch_job batch_job;
+        EXPECT_FALSE(batch_job.read(input_stream)) << input;
+    }
+}
+
+// The nets are committed in order with their halo, like in the Line router
+TEST(Batch_job, Route_with_commit)
+{
+    std::istringstream input("board 30 30\n"
+                             "net horizontal 0 15 29 15\n"
+                             "net crossing 15 0 15 29\n"
+                             "net above 0 0 29 0\n");
+
+    Batch_job batch_job;
+    ASSERT_TRUE(batch_job.read(input));
+
+    A_star_planner a_star_planner(batch_job.create_availability_grid());
+    std::vector<Batch_job::Net_result> results;
+    batch_job.route(a_star_planner, results);
+
+    ASSERT_EQ(results.size(), size_t(3));
+    EXPECT_TRUE(results.at(0).path_found);
+    EXPECT_EQ(results.at(0).path.size(), size_t(30));
+    EXPECT_FALSE(results.at(1).path_found);
+    EXPECT_TRUE(results.at(1).path.empty());
+    EXPECT_TRUE(results.at(2).path_found);
+
+    // The halo of the first net is blocked
+    EXPECT_FALSE(a_star_planner.get_availability_grid()->is_available(10, 14));
+    EXPECT_FALSE(a_star_planner.get_availability_grid()->is_available(10, 16));
+    EXPECT_TRUE(a_star_planner.get_availability_grid()->is_available(10, 17));
+
+    std::ostringstream output;
+    batch_job.write_results(output, results);
+    const std::string result_text = output.str();
+    EXPECT_NE(result_text.find("horizontal found"), std::string::npos);
+    EXPECT_NE(result_text.find("crossing failed"), std::string::npos);
+    EXPECT_NE(result_text.find(" 0,15 1,15 "), std::string::npos);
+    EXPECT_NE(result_text.find("2 of 3 nets routed"), std::string::npos);
+}
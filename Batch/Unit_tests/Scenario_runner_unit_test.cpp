@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Moving_ai_map.h>
+#include <Moving_ai_scenario.h>
+#include <Scenario_runner.h>
+#include <A_star_planner.h>
+#include <JPS_planner.h>
+#include <Coord_point_2D.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// A 6 x 4 map with a wall that has an opening at the bottom
+const char* const map_text = "type octile\n"
+                             "height 4\n"
+                             "width 6\n"
+                             "map\n"
+                             "..@...\n"
+                             "..@.T.\n"
+                             "..@...\n"
+                             "......\n";
+
+} // namespace
+
+TEST(Moving_ai_map, Read)
+{
+    std::istringstream input(map_text);
+
+    Moving_ai_map map;
+    ASSERT_TRUE(map.read(input));
+    EXPECT_EQ(map.get_width(),  size_t(6));
+    EXPECT_EQ(map.get_height(), size_t(4));
+
+    const std::shared_ptr<Availability_grid> availability_grid = map.get_availability_grid();
+    ASSERT_TRUE(availability_grid != nullptr);
+    EXPECT_TRUE(availability_grid->is_available(0, 0));
+    EXPECT_FALSE(availability_grid->is_available(2, 0));
+    EXPECT_FALSE(availability_grid->is_available(2, 2));
+    EXPECT_TRUE(availability_grid->is_available(2, 3));
+    EXPECT_FALSE(availability_grid->is_available(4, 1));
+    EXPECT_TRUE(availability_grid->is_available(5, 3));
+}
+
+TEST(Moving_ai_map, Read_errors)
+{
+    Moving_ai_map map;
+
+    std::istringstream short_row("type octile\nheight 2\nwidth 3\nmap\n...\n..\n");
+    EXPECT_FALSE(map.read(short_row));
+
+    std::istringstream missing_row("type octile\nheight 2\nwidth 3\nmap\n...\n");
+    EXPECT_FALSE(map.read(missing_row));
+
+    std::istringstream missing_width("type octile\nheight 2\nmap\n...\n...\n");
+    EXPECT_FALSE(map.read(missing_width));
+
+    std::istringstream wrong_type("type hexagon\nheight 1\nwidth 1\nmap\n.\n");
+    EXPECT_FALSE(map.read(wrong_type));
+    EXPECT_TRUE(map.get_availability_grid() == nullptr);
+}
+
+TEST(Moving_ai_scenario, Read)
+{
+    std::istringstream input("version 1\n"
+                             "0\tmaps/test.map\t6\t4\t0\t0\t1\t1\t1.41421356\n"
+                             "1\tmaps/test.map\t6\t4\t0\t0\t5\t0\t7.82842712\n"
+                             "1\tother.map\t6\t4\t5\t3\t0\t0\t5.82842712\n");
+
+    Moving_ai_scenario scenario;
+    ASSERT_TRUE(scenario.read(input));
+
+    const std::vector<Moving_ai_scenario::Query>& queries = scenario.get_queries();
+    ASSERT_EQ(queries.size(), size_t(3));
+    EXPECT_EQ(queries.at(1).bucket, size_t(1));
+    EXPECT_EQ(queries.at(1).map_name, "maps/test.map");
+    EXPECT_EQ(queries.at(1).map_width, size_t(6));
+    EXPECT_EQ(queries.at(1).map_height, size_t(4));
+    EXPECT_EQ(queries.at(1).start, Coord_point_2D(0, 0));
+    EXPECT_EQ(queries.at(1).goal, Coord_point_2D(5, 0));
+    EXPECT_DOUBLE_EQ(queries.at(1).optimal_length, 7.82842712);
+
+    const std::vector<std::string> map_names = scenario.get_map_names();
+    ASSERT_EQ(map_names.size(), size_t(2));
+    EXPECT_EQ(map_names.at(0), "maps/test.map");
+    EXPECT_EQ(map_names.at(1), "other.map");
+
+    std::istringstream outside_map("0 test.map 6 4 0 0 6 0 6\n");
+    EXPECT_FALSE(scenario.read(outside_map));
+
+    std::istringstream missing_length("0 test.map 6 4 0 0 5 0\n");
+    EXPECT_FALSE(scenario.read(missing_length));
+}
+
+TEST(Scenario_runner, Calculate_path_cost)
+{
+    // Single moves and jump points on straight and diagonal lines
+    const std::vector<Coord_point_2D> path = {Coord_point_2D(0, 0), Coord_point_2D(1, 1), Coord_point_2D(4, 1),
+                                              Coord_point_2D(2, 3)};
+    EXPECT_NEAR(Scenario_runner::calculate_path_cost(path), 3 + 3 * std::sqrt(2.0), 1e-9);
+    EXPECT_DOUBLE_EQ(Scenario_runner::calculate_path_cost(std::vector<Coord_point_2D>()), 0);
+}
+
+TEST(Scenario_runner, Run)
+{
+    std::istringstream map_input(map_text);
+    Moving_ai_map map;
+    ASSERT_TRUE(map.read(map_input));
+
+    // Around the wall through the opening at the bottom. The optimal length follows the Moving AI rules where a
+    // diagonal move needs both of its horizontal and vertical neighbors, while the planner only needs one of them and
+    // finds a cheaper path around the corners of the wall.
+    std::istringstream scenario_input("version 1\n"
+                                      "0 test.map 6 4 0 0 1 0 1\n"
+                                      "0 test.map 6 4 0 0 0 0 0\n"
+                                      "1 test.map 6 4 0 0 5 0 9.82842712\n"
+                                      "1 test.map 6 4 0 0 4 1 1\n");
+    Moving_ai_scenario scenario;
+    ASSERT_TRUE(scenario.read(scenario_input));
+
+    Scenario_runner::Maps maps;
+    maps["test.map"] = map.get_availability_grid();
+
+    A_star_planner a_star_planner(1, 1);
+    Scenario_runner scenario_runner(a_star_planner);
+    std::vector<Scenario_runner::Query_result> results;
+    ASSERT_TRUE(scenario_runner.run(scenario.get_queries(), maps, results));
+    ASSERT_EQ(results.size(), size_t(4));
+    EXPECT_EQ(a_star_planner.get_availability_grid(), map.get_availability_grid());
+
+    EXPECT_TRUE(results.at(0).path_found);
+    EXPECT_DOUBLE_EQ(results.at(0).path_cost, 1);
+    EXPECT_EQ(results.at(0).expansions > 0, search_statistics_compiled_in);
+    EXPECT_TRUE(results.at(1).path_found);
+    EXPECT_DOUBLE_EQ(results.at(1).path_cost, 0);
+    EXPECT_TRUE(results.at(2).path_found);
+    EXPECT_NEAR(results.at(2).path_cost, 3 + 4 * std::sqrt(2.0), 1e-6);
+    // The goal is blocked
+    EXPECT_FALSE(results.at(3).path_found);
+
+    std::vector<Scenario_runner::Bucket_statistics> statistics;
+    Scenario_runner::get_bucket_statistics(scenario.get_queries(), results, statistics);
+    ASSERT_EQ(statistics.size(), size_t(2));
+    EXPECT_EQ(statistics.at(0).bucket, size_t(0));
+    EXPECT_EQ(statistics.at(0).number_of_queries, size_t(2));
+    EXPECT_EQ(statistics.at(0).number_of_paths_found, size_t(2));
+    EXPECT_DOUBLE_EQ(statistics.at(0).mean_suboptimality, 1);
+    EXPECT_LT(statistics.at(1).mean_suboptimality, 1);
+    EXPECT_EQ(statistics.at(1).number_of_queries, size_t(2));
+    EXPECT_EQ(statistics.at(1).number_of_paths_found, size_t(1));
+    EXPECT_GE(statistics.at(1).p99_time_ms, statistics.at(1).median_time_ms);
+
+    std::ostringstream output;
+    Scenario_runner::write_bucket_statistics(output, statistics);
+    EXPECT_NE(output.str().find("# 3 of 4 queries found a path in 2 buckets"), std::string::npos);
+
+    // The same scenario with JPS
+    JPS_planner jps_planner(1, 1);
+    Scenario_runner jps_scenario_runner(jps_planner);
+    ASSERT_TRUE(jps_scenario_runner.run(scenario.get_queries(), maps, results));
+    EXPECT_TRUE(results.at(2).path_found);
+    EXPECT_LT(results.at(2).path_cost, 9.82842712);
+}
+
+TEST(Scenario_runner, Run_errors)
+{
+    std::istringstream map_input(map_text);
+    Moving_ai_map map;
+    ASSERT_TRUE(map.read(map_input));
+
+    std::istringstream scenario_input("0 test.map 7 4 0 0 1 0 1\n");
+    Moving_ai_scenario scenario;
+    ASSERT_TRUE(scenario.read(scenario_input));
+
+    A_star_planner a_star_planner(1, 1);
+    Scenario_runner scenario_runner(a_star_planner);
+    std::vector<Scenario_runner::Query_result> results;
+
+    // Missing map
+    Scenario_runner::Maps maps;
+    EXPECT_FALSE(scenario_runner.run(scenario.get_queries(), maps, results));
+
+    // Wrong map size
+    maps["test.map"] = map.get_availability_grid();
+    EXPECT_FALSE(scenario_runner.run(scenario.get_queries(), maps, results));
+}
@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <A_star_planner.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Measures the latency of a short route (three points) in the middle of grids of increasing size. Since the search
+// state is stamped per query the latency should stay flat when the grid grows.
+// Usage: a_star_planner_benchmark [max_grid_width]
+// The default maximum grid width is 8192. The search state is 13 bytes per point, three uint32_t and one uint8_t, or 16
+// bytes per point with LINE_ROUTER_SEARCH_STATE_RECORDS, see Search_state_grid. A 16384 x 16384 grid then needs around
+// 3.5 GB of memory, or 4.3 GB with the records.
+int main(int argc, char** argv)
+{
+    size_t max_grid_width = 8192;
+    if (argc > 1)
+    {
+        max_grid_width = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    const size_t number_of_queries = 10000;
+
+    std::cout << std::setw(12) << "Grid size" << std::setw(20) << "Short route [us]" << std::endl;
+
+    for (size_t grid_width = 64; grid_width <= max_grid_width; grid_width *= 2)
+    {
+        A_star_planner a_star_planner(grid_width, grid_width);
+
+        const Coord_point_2D start(grid_width/2, grid_width/2);
+        const Coord_point_2D end(grid_width/2 + 2, grid_width/2);
+
+        std::vector<Coord_point_2D> path;
+
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        for (size_t query = 0; query < number_of_queries; query++)
+        {
+            if (not a_star_planner.get_path(start, end, path))
+            {
+                std::cerr << "ERROR: Failed to find a path" << std::endl;
+                return 1;
+            }
+        }
+        const std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+
+        const double total_time = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+
+        std::cout << std::setw(5) << grid_width << " x " << std::setw(5) << grid_width
+                  << std::setw(18) << std::fixed << std::setprecision(3) << total_time / number_of_queries
+                  << std::endl;
+    }
+
+    return 0;
+}
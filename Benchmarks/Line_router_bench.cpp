@@ -0,0 +1,675 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <A_star_planner.h>
+#include <A_star_planner_factory.h>
+#include <A_star_planner_pool.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Flat_grid_2D.h>
+#include <Flat_point_2D.h>
+#include <Grid_layout.h>
+#include <Grid_width.h>
+#include <Search_state_grid.h>
+
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Microbenchmarks of the hot paths of the path planner, run with Google benchmark. The grid benchmarks take the grid
+// width as the first argument and the obstacle density in percent as the second argument.
+// Usage: line_router_bench [--max_grid_width=<width>] [Google benchmark flags, e.g. --benchmark_filter=<regex>]
+// The default maximum grid width is 4096. A 16384 x 16384 planner needs around 3.6 GB of memory.
+// The cache misses are counted with the hardware counters of the CPU where Linux makes them available, see
+// Cache_miss_counter.
+namespace
+{
+
+// Exposes the protected hot paths of A_star_planner to the benchmarks
+class Bench_a_star_planner : public A_star_planner
+{
+public:
+    Bench_a_star_planner(const size_t width, const size_t height) : A_star_planner(width, height)
+    {
+    }
+
+    using A_star_planner::Neighbors;
+    using A_star_planner::get_neighbors;
+    using A_star_planner::calculate_cheapest_cost_to_target;
+    using A_star_planner::reconstruct_path;
+};
+
+// Counts the hardware cache misses and cache references of the benchmark thread with perf_event_open. The counters are
+// not available on all systems, e.g. not on other platforms than Linux, in most virtual machines or with a restrictive
+// /proc/sys/kernel/perf_event_paranoid, and then nothing is counted.
+class Cache_miss_counter
+{
+public:
+    Cache_miss_counter() : miss_fd(-1), reference_fd(-1)
+    {
+#ifdef __linux__
+        miss_fd = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+        reference_fd = open_counter(PERF_COUNT_HW_CACHE_REFERENCES);
+#endif
+    }
+
+    ~Cache_miss_counter()
+    {
+#ifdef __linux__
+        for (const int fd : {miss_fd, reference_fd})
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    bool is_available() const
+    {
+        return miss_fd >= 0 && reference_fd >= 0;
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        if (is_available())
+        {
+            ioctl(miss_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(reference_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(miss_fd, PERF_EVENT_IOC_ENABLE, 0);
+            ioctl(reference_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stop counting and add the cache misses per item and the cache miss rate to the benchmark results
+    void stop(benchmark::State& state, const size_t number_of_items)
+    {
+#ifdef __linux__
+        if (is_available())
+        {
+            ioctl(miss_fd, PERF_EVENT_IOC_DISABLE, 0);
+            ioctl(reference_fd, PERF_EVENT_IOC_DISABLE, 0);
+            const double misses = read_counter(miss_fd);
+            const double references = read_counter(reference_fd);
+            state.counters["cache_misses"] = number_of_items > 0 ? misses / number_of_items : 0.0;
+            state.counters["cache_miss_rate"] = references > 0 ? misses / references : 0.0;
+        }
+#else
+        (void)state;
+        (void)number_of_items;
+#endif
+    }
+
+private:
+    int miss_fd;
+    int reference_fd;
+
+#ifdef __linux__
+    static int open_counter(const uint64_t config)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    static double read_counter(const int fd)
+    {
+        uint64_t count = 0;
+        return read(fd, &count, sizeof(count)) == sizeof(count) ? static_cast<double>(count) : 0.0;
+    }
+#endif
+};
+
+// The same seed is used for all runs so that the obstacles, and thereby the results, can be compared between builds
+const uint32_t random_seed = 2019;
+
+// Number of random points used by the point benchmarks
+const size_t number_of_random_points = 4096;
+
+size_t max_grid_width = 4096;
+
+// A planner with random obstacles. The planner is kept between the runs of a benchmark since it is expensive to create
+// for large grids. Only one planner is kept at a time to limit the memory usage.
+struct Planner_setup
+{
+    size_t width;
+    size_t density;
+    std::unique_ptr<Bench_a_star_planner> planner;
+};
+
+Planner_setup planner_setup = {0, 0, nullptr};
+
+// Get a width x width planner where density percent of the points are blocked and the end point (width - 1, width - 1)
+// can be reached from the start point (0, 0).
+Bench_a_star_planner& get_planner(const size_t width, const size_t density)
+{
+    if (planner_setup.planner && planner_setup.width == width && planner_setup.density == density)
+    {
+        return *planner_setup.planner;
+    }
+
+    // Release the old planner before creating the new one
+    planner_setup.planner.reset();
+    planner_setup.planner.reset(new Bench_a_star_planner(width, width));
+    planner_setup.width = width;
+    planner_setup.density = density;
+
+    Availability_grid& availability_grid = *planner_setup.planner->get_availability_grid();
+    std::mt19937 random_generator(random_seed);
+    std::uniform_int_distribution<size_t> percent_distribution(0, 99);
+    for (size_t y = 0; y < width; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            if (percent_distribution(random_generator) < density)
+            {
+                availability_grid.set_blocked(x, y);
+            }
+        }
+    }
+
+    // Uniformly placed obstacles do not leave a path between the corners at 40 percent density, since the diagonal
+    // moves need an available horizontal or vertical neighbor. Clear a random staircase from the start point to the end
+    // point so that all densities have a path.
+    std::uniform_int_distribution<size_t> step_distribution(0, 1);
+    size_t x = 0;
+    size_t y = 0;
+    availability_grid.set_available(x, y);
+    while (x < width - 1 || y < width - 1)
+    {
+        if (y == width - 1 || (x < width - 1 && step_distribution(random_generator) == 0))
+        {
+            x++;
+        }
+        else
+        {
+            y++;
+        }
+        availability_grid.set_available(x, y);
+    }
+
+    return *planner_setup.planner;
+}
+
+// Get random points inside a width x width grid
+std::vector<Coord_point_2D> get_random_points(const size_t width)
+{
+    std::mt19937 random_generator(random_seed);
+    std::uniform_int_distribution<size_t> coordinate_distribution(0, width - 1);
+
+    std::vector<Coord_point_2D> points;
+    points.reserve(number_of_random_points);
+    for (size_t point_number = 0; point_number < number_of_random_points; point_number++)
+    {
+        const size_t x = coordinate_distribution(random_generator);
+        const size_t y = coordinate_distribution(random_generator);
+        points.push_back(Coord_point_2D(x, y));
+    }
+
+    return points;
+}
+
+void bench_get_neighbors(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Bench_a_star_planner& planner = get_planner(width, state.range(1));
+
+    std::vector<Flat_point_2D> points;
+    for (const Coord_point_2D& point : get_random_points(width))
+    {
+        points.push_back(Flat_point_2D(point, width));
+    }
+
+    Bench_a_star_planner::Neighbors neighbors;
+    for (auto _ : state)
+    {
+        for (const Flat_point_2D& point : points)
+        {
+            benchmark::DoNotOptimize(planner.get_neighbors(point, neighbors));
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+void bench_calculate_cheapest_cost_to_target(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Bench_a_star_planner& planner = get_planner(width, 0);
+
+    const std::vector<Coord_point_2D> points = get_random_points(width);
+    const Coord_point_2D target(width - 1, width - 1);
+
+    for (auto _ : state)
+    {
+        for (const Coord_point_2D& point : points)
+        {
+            benchmark::DoNotOptimize(planner.calculate_cheapest_cost_to_target(point, target));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+// Route from corner to corner and count the points popped by the search
+void bench_get_path(benchmark::State& state, const A_star_planner::Cost_mode cost_mode)
+{
+    const size_t width = state.range(0);
+    Bench_a_star_planner& planner = get_planner(width, state.range(1));
+    planner.set_cost_mode(cost_mode);
+
+    const Coord_point_2D start(0, 0);
+    const Coord_point_2D end(width - 1, width - 1);
+    std::vector<Coord_point_2D> path;
+
+    Cache_miss_counter cache_miss_counter;
+    cache_miss_counter.start();
+    for (auto _ : state)
+    {
+        if (not planner.get_path(start, end, path))
+        {
+            state.SkipWithError("No path found");
+            break;
+        }
+    }
+    cache_miss_counter.stop(state, state.iterations() * planner.get_number_of_heap_pops());
+
+    state.counters["path_length"] = path.size();
+    state.counters["expansions"] = planner.get_number_of_heap_pops();
+    planner.set_cost_mode(A_star_planner::Cost_mode::floating_point);
+
+    // The search state layouts are chosen at compile time, the label tells the results of the layouts apart
+    state.SetLabel(std::string(Search_state_grid::get_layout_name()) + ", " +
+                   Search_state_grid::get_grid_layout_name());
+}
+
+// Route from corner to corner with the planner of the A_star_planner_factory for the width, i.e. a Fixed_width for the
+// board width and a Power_of_two_width for the power of two widths, or with the A_star_planner and its runtime width
+void bench_get_path_width_policy(benchmark::State& state, const bool use_factory)
+{
+    const size_t width = state.range(0);
+    Bench_a_star_planner& bench_planner = get_planner(width, state.range(1));
+    const std::unique_ptr<A_star_planner> factory_planner = use_factory ? A_star_planner_factory::create(
+                                                          bench_planner.get_availability_grid(),
+                                                          A_star_planner_factory::Connectivity_type::eight_connected)
+                                                                        : nullptr;
+    A_star_planner& planner = use_factory ? *factory_planner : bench_planner;
+
+    const Coord_point_2D start(0, 0);
+    const Coord_point_2D end(width - 1, width - 1);
+    std::vector<Coord_point_2D> path;
+
+    for (auto _ : state)
+    {
+        if (not planner.get_path(start, end, path))
+        {
+            state.SkipWithError("No path found");
+            break;
+        }
+    }
+
+    state.counters["expansions"] = planner.get_number_of_heap_pops();
+}
+
+// A pool with one planner per hardware thread for the board of get_planner, and routes between random available points
+// that can reach each other. The pool is kept between the runs of a benchmark and is created by the first thread of a
+// run that asks for it.
+struct Pool_setup
+{
+    size_t width;
+    size_t density;
+    std::unique_ptr<A_star_planner_pool> pool;
+    std::vector<std::pair<Coord_point_2D, Coord_point_2D>> routes;
+};
+
+std::mutex pool_setup_mutex;
+Pool_setup pool_setup = {0, 0, nullptr, {}};
+
+Pool_setup& get_pool_setup(const size_t width, const size_t density)
+{
+    std::lock_guard<std::mutex> lock(pool_setup_mutex);
+    if (pool_setup.pool && pool_setup.width == width && pool_setup.density == density)
+    {
+        return pool_setup;
+    }
+
+    pool_setup.pool.reset();
+    const std::shared_ptr<Availability_grid> availability_grid = get_planner(width, density).get_availability_grid();
+
+    // The component index is only used to pick the routes, the board is left as the other benchmarks use it
+    availability_grid->set_component_index_enabled(true);
+    const std::vector<Coord_point_2D> points = get_random_points(width);
+    pool_setup.routes.clear();
+    for (size_t point_number = 0; point_number + 1 < points.size(); point_number += 2)
+    {
+        const Coord_point_2D& start = points.at(point_number);
+        const Coord_point_2D& end = points.at(point_number + 1);
+        if (availability_grid->is_available(start) && availability_grid->is_reachable(start, end))
+        {
+            pool_setup.routes.push_back(std::make_pair(start, end));
+        }
+    }
+    availability_grid->set_component_index_enabled(false);
+
+    const size_t number_of_planners = std::max(1u, std::thread::hardware_concurrency());
+    pool_setup.pool.reset(new A_star_planner_pool(availability_grid, number_of_planners));
+    pool_setup.width = width;
+    pool_setup.density = density;
+    return pool_setup;
+}
+
+// Route between random points on several threads at the same time with an A_star_planner_pool. The threads start at
+// different routes.
+void bench_get_path_pool(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Pool_setup& setup = get_pool_setup(width, state.range(1));
+    const size_t first_route = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    std::vector<Coord_point_2D> path;
+    size_t number_of_routes = 0;
+    for (auto _ : state)
+    {
+        const std::pair<Coord_point_2D, Coord_point_2D>& route = setup.routes.at((first_route + number_of_routes) %
+                                                                                 setup.routes.size());
+        if (not setup.pool->get_path(route.first, route.second, path))
+        {
+            state.SkipWithError("No path found");
+            break;
+        }
+        number_of_routes++;
+    }
+
+    state.SetItemsProcessed(number_of_routes);
+}
+
+void bench_reconstruct_path(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Bench_a_star_planner& planner = get_planner(width, state.range(1));
+
+    // The search state of the last query is used to reconstruct the path
+    const Coord_point_2D start(0, 0);
+    const Coord_point_2D end(width - 1, width - 1);
+    std::vector<Coord_point_2D> path;
+    if (not planner.get_path(start, end, path))
+    {
+        state.SkipWithError("No path found");
+        return;
+    }
+
+    const Flat_point_2D flat_end(end, width);
+    for (auto _ : state)
+    {
+        planner.reconstruct_path(start, flat_end, path);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * path.size());
+}
+
+void bench_flat_grid_fill(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Flat_grid_2D<uint32_t> flat_grid(width, width, 0);
+
+    uint32_t value = 0;
+    for (auto _ : state)
+    {
+        flat_grid.fill(value++);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * width * width * sizeof(uint32_t));
+}
+
+void bench_flat_grid_get(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    const Flat_grid_2D<uint32_t> flat_grid(width, width, 1);
+    const std::vector<Coord_point_2D> points = get_random_points(width);
+
+    for (auto _ : state)
+    {
+        uint32_t sum = 0;
+        for (const Coord_point_2D& point : points)
+        {
+            sum += flat_grid.get(point);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+void bench_flat_grid_set(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    Flat_grid_2D<uint32_t> flat_grid(width, width, 0);
+    const std::vector<Coord_point_2D> points = get_random_points(width);
+
+    uint32_t value = 0;
+    for (auto _ : state)
+    {
+        for (const Coord_point_2D& point : points)
+        {
+            flat_grid.set(point, value);
+        }
+        value++;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+// Read the 3 x 3 neighborhoods of random points, as when a point is expanded by the planners, from a grid with the
+// layout. Besides the hardware counters, the number of distinct 64 byte cache lines and 4 KB pages that a neighborhood
+// covers are counted from the storage indices of the layout, assuming that the grid starts at a page. The pages tell
+// how many TLB entries are needed.
+template<typename Layout>
+void bench_flat_grid_neighborhood(benchmark::State& state)
+{
+    const size_t width = state.range(0);
+    const Flat_grid_2D<uint32_t, Runtime_width, Layout> flat_grid(width, width, 1);
+
+    std::vector<size_t> flat_indices;
+    for (const Coord_point_2D& point : get_random_points(width))
+    {
+        const size_t x = std::min(std::max(point.get_x(), size_t(1)), width - 2);
+        const size_t y = std::min(std::max(point.get_y(), size_t(1)), width - 2);
+        flat_indices.push_back(x + y * width);
+    }
+
+    Cache_miss_counter cache_miss_counter;
+    cache_miss_counter.start();
+    for (auto _ : state)
+    {
+        uint32_t sum = 0;
+        for (const size_t flat_index : flat_indices)
+        {
+            for (size_t row_start = flat_index - width - 1; row_start <= flat_index + width - 1; row_start += width)
+            {
+                sum += flat_grid.get(row_start) + flat_grid.get(row_start + 1) + flat_grid.get(row_start + 2);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    cache_miss_counter.stop(state, state.iterations() * flat_indices.size());
+
+    const Runtime_width grid_width(width);
+    const Layout layout(width, width);
+    size_t number_of_cache_lines = 0;
+    size_t number_of_pages = 0;
+    for (const size_t flat_index : flat_indices)
+    {
+        std::vector<size_t> cache_lines;
+        std::vector<size_t> pages;
+        for (size_t row_start = flat_index - width - 1; row_start <= flat_index + width - 1; row_start += width)
+        {
+            for (size_t neighbor_index = row_start; neighbor_index < row_start + 3; neighbor_index++)
+            {
+                const size_t byte_offset = layout.get_storage_index(neighbor_index, grid_width) * sizeof(uint32_t);
+                cache_lines.push_back(byte_offset / 64);
+                pages.push_back(byte_offset / 4096);
+            }
+        }
+        std::sort(cache_lines.begin(), cache_lines.end());
+        std::sort(pages.begin(), pages.end());
+        number_of_cache_lines += std::unique(cache_lines.begin(), cache_lines.end()) - cache_lines.begin();
+        number_of_pages += std::unique(pages.begin(), pages.end()) - pages.begin();
+    }
+
+    state.counters["cache_lines"] = static_cast<double>(number_of_cache_lines) / flat_indices.size();
+    state.counters["pages"] = static_cast<double>(number_of_pages) / flat_indices.size();
+    state.SetItemsProcessed(state.iterations() * flat_indices.size());
+    state.SetLabel(Layout::get_name());
+}
+
+// Add the grid widths 64, 256, 1024, ... up to max_grid_width
+void add_grid_widths(benchmark::internal::Benchmark* benchmark)
+{
+    for (size_t width = 64; width <= max_grid_width; width *= 4)
+    {
+        benchmark->Arg(width);
+    }
+}
+
+// Add the grid widths combined with the obstacle densities 0, 10, 20, 30 and 40 percent
+void add_grid_widths_and_densities(benchmark::internal::Benchmark* benchmark)
+{
+    for (size_t width = 64; width <= max_grid_width; width *= 4)
+    {
+        for (size_t density = 0; density <= 40; density += 10)
+        {
+            benchmark->Args({static_cast<int64_t>(width), static_cast<int64_t>(density)});
+        }
+    }
+}
+
+// Add the board width and the closest power of two width combined with the obstacle densities 0, 20 and 40 percent
+void add_board_widths_and_densities(benchmark::internal::Benchmark* benchmark)
+{
+    for (const size_t width : {A_star_planner_factory::fixed_board_width, size_t(512)})
+    {
+        for (size_t density = 0; density <= 40; density += 20)
+        {
+            benchmark->Args({static_cast<int64_t>(width), static_cast<int64_t>(density)});
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // Remove the own arguments before passing the rest to Google benchmark
+    const char max_grid_width_flag[] = "--max_grid_width=";
+    int number_of_arguments = 1;
+    for (int argument = 1; argument < argc; argument++)
+    {
+        if (std::strncmp(argv[argument], max_grid_width_flag, sizeof(max_grid_width_flag) - 1) == 0)
+        {
+            max_grid_width = std::strtoul(argv[argument] + sizeof(max_grid_width_flag) - 1, nullptr, 10);
+        }
+        else
+        {
+            argv[number_of_arguments++] = argv[argument];
+        }
+    }
+    argc = number_of_arguments;
+
+    if (max_grid_width < 64)
+    {
+        std::cout << "ERROR: The maximum grid width must be at least 64" << std::endl;
+        return 1;
+    }
+
+    if (not Cache_miss_counter().is_available())
+    {
+        std::cout << "WARNING: The hardware cache counters are not available, only the cache lines are reported"
+                  << std::endl;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RegisterBenchmark("get_neighbors", bench_get_neighbors)->Apply(add_grid_widths_and_densities);
+    benchmark::RegisterBenchmark("calculate_cheapest_cost_to_target",
+                                 bench_calculate_cheapest_cost_to_target)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("reconstruct_path", bench_reconstruct_path)->Apply(add_grid_widths_and_densities);
+    benchmark::RegisterBenchmark("get_path/floating_point", bench_get_path,
+                                 A_star_planner::Cost_mode::floating_point)
+                                                                        ->Apply(add_grid_widths_and_densities)
+                                                                        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("get_path/fixed_point_octile", bench_get_path,
+                                 A_star_planner::Cost_mode::fixed_point_octile)
+                                                                        ->Apply(add_grid_widths_and_densities)
+                                                                        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("get_path/runtime_width", bench_get_path_width_policy, false)
+                                                                        ->Apply(add_board_widths_and_densities)
+                                                                        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("get_path/width_policy", bench_get_path_width_policy, true)
+                                                                        ->Apply(add_board_widths_and_densities)
+                                                                        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("get_path/pool", bench_get_path_pool)
+                                                                        ->Args({600, 20})
+                                                                        ->Args({1024, 20})
+                                                                        ->ThreadRange(1, std::max(1u,
+                                                                                 std::thread::hardware_concurrency()))
+                                                                        ->UseRealTime()
+                                                                        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("Flat_grid_2D/fill", bench_flat_grid_fill)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/get", bench_flat_grid_get)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/set", bench_flat_grid_set)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/neighborhood/checked_row_major",
+                                 bench_flat_grid_neighborhood<Checked_row_major>)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/neighborhood/unchecked_row_major",
+                                 bench_flat_grid_neighborhood<Unchecked_row_major>)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/neighborhood/tiled_8x8",
+                                 bench_flat_grid_neighborhood<Tiled<8>>)->Apply(add_grid_widths);
+    benchmark::RegisterBenchmark("Flat_grid_2D/neighborhood/tiled_16x16",
+                                 bench_flat_grid_neighborhood<Tiled<16>>)->Apply(add_grid_widths);
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
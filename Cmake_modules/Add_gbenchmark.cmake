@@ -0,0 +1,33 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+#
+#  Created on: Apr 21, 2019
+#      Author: Jakob Almqvist
+#
+#  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# function ADD_GBENCHMARK
+# Will generate a Google benchmark target. It requires Ext/Google_benchmark which should set
+# GBENCHMARK_FOUND: TRUE if Google benchmark is available
+# GBENCHMARK_LIBS: Google benchmark libraries
+# GBENCHMARK_INCLUDE_DIRS: Google benchmark include directory
+# The benchmark is not added as a test since it takes long time to run and only prints timing results.
+#
+# Input arguments:
+# NAME - String with a name for the benchmark
+# SRC  - List of source files to be linked with target
+# ARGN - List of libraries to be linked with target
+function(ADD_GBENCHMARK NAME SRC)
+
+    # Generate benchmark executable from SRC with name NAME
+    add_executable(${NAME} ${SRC})
+
+    # Link with Google benchmark and libraries listed in ARGN
+    target_link_libraries(${NAME} ${ARGN}
+                                  ${GBENCHMARK_LIBS})
+
+    # Set Google benchmark include directories for benchmark
+    target_include_directories(${NAME} PRIVATE ${GBENCHMARK_INCLUDE_DIRS})
+
+endfunction()
@@ -0,0 +1,174 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Bit_grid_2D.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+Bit_grid_2D::Bit_grid_2D(const size_t width, const size_t height, const bool initial_value) : width(0),
+                                                                                              height(0),
+                                                                                              words_per_row(0)
+{
+    resize(width, height, initial_value);
+}
+
+Bit_grid_2D::~Bit_grid_2D()
+{
+}
+
+void Bit_grid_2D::fill(const bool value)
+{
+    for (size_t padded_y = 1; padded_y <= height; padded_y++)
+    {
+        const size_t row_start = padded_y * words_per_row;
+        for (size_t word = 0; word < words_per_row; word++)
+        {
+            words[row_start + word] = value ? row_mask[word] : 0;
+        }
+    }
+}
+
+void Bit_grid_2D::resize(const size_t width, const size_t height, const bool value)
+{
+    // One border bit on each side and one extra word per row
+    const size_t new_words_per_row = (width + 2 + 63) / 64 + 1;
+
+    std::vector<uint64_t> new_words((height + 2) * new_words_per_row, 0);
+    std::vector<uint64_t> new_row_mask(new_words_per_row, 0);
+    for (size_t padded_x = 1; padded_x <= width; padded_x++)
+    {
+        new_row_mask[padded_x >> 6] |= uint64_t(1) << (padded_x & 63);
+    }
+
+    // Copy the rows that are kept and set the rest of the points to value. The border bits stay zero.
+    for (size_t padded_y = 1; padded_y <= height; padded_y++)
+    {
+        const size_t row_start = padded_y * new_words_per_row;
+        for (size_t word = 0; word < new_words_per_row; word++)
+        {
+            uint64_t new_word = value ? new_row_mask[word] : 0;
+            if (padded_y <= this->height && word < words_per_row)
+            {
+                // Bits inside both the old and the new grid are taken from the old grid
+                const uint64_t keep_mask = new_row_mask[word] & row_mask[word];
+                new_word = (new_word & ~keep_mask) | (words[padded_y * words_per_row + word] & keep_mask);
+            }
+            new_words[row_start + word] = new_word;
+        }
+    }
+
+    this->width = width;
+    this->height = height;
+    words_per_row = new_words_per_row;
+    words.swap(new_words);
+    row_mask.swap(new_row_mask);
+}
+
+Coord_rectangle_2D Bit_grid_2D::clear_dilated(const std::vector<Coord_point_2D>& points, const size_t radius)
+{
+    Coord_rectangle_2D bounding_rectangle;
+    for (const Coord_point_2D& point : points)
+    {
+        check_range(point.get_x(), point.get_y());
+        bounding_rectangle.add(point);
+    }
+
+    if (bounding_rectangle.is_empty())
+    {
+        return bounding_rectangle;
+    }
+
+    // A radius past the grid clears the same points as one that just reaches across it. Clamp it so the number of
+    // dilation steps is bounded and the limits below can not wrap around.
+    const size_t dilation_radius = std::min(radius, std::max(width, height));
+
+    // The rectangle of the dilated points, clamped to the grid
+    const size_t min_x = bounding_rectangle.get_min_x() > dilation_radius ?
+                         bounding_rectangle.get_min_x() - dilation_radius : 0;
+    const size_t min_y = bounding_rectangle.get_min_y() > dilation_radius ?
+                         bounding_rectangle.get_min_y() - dilation_radius : 0;
+    const size_t max_x = width - 1 - bounding_rectangle.get_max_x() > dilation_radius ?
+                         bounding_rectangle.get_max_x() + dilation_radius : width - 1;
+    const size_t max_y = height - 1 - bounding_rectangle.get_max_y() > dilation_radius ?
+                         bounding_rectangle.get_max_y() + dilation_radius : height - 1;
+    const Coord_rectangle_2D dirty_rectangle(min_x, min_y, max_x, max_y);
+
+    // Only the words that hold the dirty points are used. A bit is moved out of these words by the dilation only if
+    // its point is outside the grid, so it can be dropped.
+    const size_t first_word = (min_x + 1) >> 6;
+    const size_t number_of_words = ((max_x + 1) >> 6) - first_word + 1;
+    const size_t first_row = bounding_rectangle.get_min_y();
+    const size_t number_of_rows = bounding_rectangle.get_height();
+
+    // Set the bits of the points, one row of words per row of the bounding rectangle
+    std::vector<uint64_t> point_rows(number_of_rows * number_of_words, 0);
+    for (const Coord_point_2D& point : points)
+    {
+        const size_t padded_x = point.get_x() + 1;
+        point_rows[(point.get_y() - first_row) * number_of_words + (padded_x >> 6) - first_word] |=
+                                                                                      uint64_t(1) << (padded_x & 63);
+    }
+
+    // Dilate every row horizontally by one point per step. The bits shifted across a word boundary are carried over
+    // from the word to the left and to the right.
+    std::vector<uint64_t> row(number_of_words);
+    for (size_t step = 0; step < dilation_radius; step++)
+    {
+        for (size_t row_number = 0; row_number < number_of_rows; row_number++)
+        {
+            uint64_t* const words_of_row = &point_rows[row_number * number_of_words];
+            row.assign(words_of_row, words_of_row + number_of_words);
+            for (size_t word = 0; word < number_of_words; word++)
+            {
+                const uint64_t left_carry  = word > 0 ? row[word-1] >> 63 : 0;
+                const uint64_t right_carry = word + 1 < number_of_words ? row[word+1] << 63 : 0;
+                words_of_row[word] = row[word] | (row[word] << 1) | (row[word] >> 1) | left_carry | right_carry;
+            }
+        }
+    }
+
+    // Dilate vertically by ORing the rows within radius and clear the result in the grid. The border bits may be
+    // cleared too, they are always zero anyway.
+    for (size_t y = min_y; y <= max_y; y++)
+    {
+        const size_t first_source_row = y > first_row + dilation_radius ? y - dilation_radius - first_row : 0;
+        const size_t last_source_row = y + dilation_radius - first_row < number_of_rows ?
+                                       y + dilation_radius - first_row : number_of_rows - 1;
+        row.assign(number_of_words, 0);
+        for (size_t source_row = first_source_row; source_row <= last_source_row; source_row++)
+        {
+            for (size_t word = 0; word < number_of_words; word++)
+            {
+                row[word] |= point_rows[source_row * number_of_words + word];
+            }
+        }
+
+        uint64_t* const grid_words = &words[(y + 1) * words_per_row + first_word];
+        for (size_t word = 0; word < number_of_words; word++)
+        {
+            grid_words[word] &= ~row[word];
+        }
+    }
+
+    return dirty_rectangle;
+}
+
+void Bit_grid_2D::check_range(const size_t x, const size_t y) const
+{
+    if (x >= width || y >= height)
+    {
+        throw std::out_of_range("Bit_grid_2D: Point out of range");
+    }
+}
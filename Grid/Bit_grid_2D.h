@@ -0,0 +1,141 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_GRID_BIT_GRID_2D_H_
+#define LINE_ROUTER_GRID_BIT_GRID_2D_H_
+
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A two dimensional (2D) grid of bits with dimensions width x height. The rows are packed into 64 bit words and are
+// surrounded by a one point wide border that is always zero. Point (x, y) is stored as bit x+1 of row y+1.
+// The border makes it possible to read the 3 x 3 block of bits around any point inside the grid without checking if
+// the neighbors are outside the grid, see get_neighbor_mask. Every row also has one extra word at the end so that three
+// bits can be read from any bit position with shifts only.
+// The get and set functions throw a std::out_of_range exception if trying to set or get points that are out of bounds.
+class Bit_grid_2D
+{
+public:
+    // The bit of each neighbor in the mask returned by get_neighbor_mask
+    enum Neighbor_bit
+    {
+        left_bit        = 0,
+        up_bit          = 1,
+        right_bit       = 2,
+        down_bit        = 3,
+        upper_left_bit  = 4,
+        upper_right_bit = 5,
+        lower_right_bit = 6,
+        lower_left_bit  = 7
+    };
+
+    // Creates a width x height grid with an initial value set to all points
+    Bit_grid_2D(const size_t width, const size_t height, const bool initial_value = false);
+    virtual ~Bit_grid_2D();
+
+    size_t get_width() const
+    {
+        return width;
+    }
+
+    size_t get_height() const
+    {
+        return height;
+    }
+
+    // Get the number of bytes allocated for the bits, including the border
+    size_t get_number_of_bytes() const
+    {
+        return (words.capacity() + row_mask.capacity()) * sizeof(uint64_t);
+    }
+
+    // Fill all grid points with value. The border is kept zero.
+    void fill(const bool value);
+
+    // Resize the grid. The points that are inside both the old and the new grid keep their values and the new points
+    // are set to value.
+    void resize(const size_t width, const size_t height, const bool value = false);
+
+    // Get value of point at coordinate x and y
+    bool get(const size_t x, const size_t y) const
+    {
+        check_range(x, y);
+        return (words[get_word_index(x+1, y+1)] >> ((x+1) & 63)) & 1;
+    }
+
+    // Set value of point at coordinate x and y
+    void set(const size_t x, const size_t y, const bool value)
+    {
+        check_range(x, y);
+        const uint64_t bit = uint64_t(1) << ((x+1) & 63);
+        uint64_t& word = words[get_word_index(x+1, y+1)];
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    // Clear the points and all points within radius of them (in x and y, i.e. a square around each point). The points
+    // are dilated with word-level shifts and ORs, so the cost is per row and word of the bounding rectangle instead of
+    // per point and neighbor. Returns the bounding rectangle of the cleared points clamped to the grid.
+    Coord_rectangle_2D clear_dilated(const std::vector<Coord_point_2D>& points, const size_t radius);
+
+    // Get the values of the eight neighbors of point x, y as a mask with one bit per neighbor, see Neighbor_bit.
+    // Neighbors outside the grid are zero. There are no range checks, x and y must be inside the grid.
+    uint8_t get_neighbor_mask(const size_t x, const size_t y) const
+    {
+        // Bits x, x+1 and x+2 of the row above, the row of the point and the row below are the bits of the points
+        // x-1, x and x+1
+        const uint64_t up   = get_three_bits(x, y);
+        const uint64_t row  = get_three_bits(x, y+1);
+        const uint64_t down = get_three_bits(x, y+2);
+
+        return static_cast<uint8_t>(( row         & 1)        |
+                                    ((up   >> 1)  & 1) << 1   |
+                                    ((row  >> 2)  & 1) << 2   |
+                                    ((down >> 1)  & 1) << 3   |
+                                    ( up          & 1) << 4   |
+                                    ((up   >> 2)  & 1) << 5   |
+                                    ((down >> 2)  & 1) << 6   |
+                                    ( down        & 1) << 7);
+    }
+
+private:
+    size_t width;
+    size_t height;
+
+    // Number of words of each row including the border and the extra word
+    size_t words_per_row;
+
+    // (height + 2) rows of words_per_row words
+    std::vector<uint64_t> words;
+
+    // The words of a row with all points inside the grid set, used by fill
+    std::vector<uint64_t> row_mask;
+
+    void check_range(const size_t x, const size_t y) const;
+
+    // Get the index of the word holding bit padded_x of row padded_y, where the coordinates include the border
+    size_t get_word_index(const size_t padded_x, const size_t padded_y) const
+    {
+        return padded_y * words_per_row + (padded_x >> 6);
+    }
+
+    // Get bits padded_x, padded_x+1 and padded_x+2 of row padded_y. The bits may be split across two words. The high
+    // word is shifted in two steps so that a shift of 64, which is undefined, is never done.
+    uint64_t get_three_bits(const size_t padded_x, const size_t padded_y) const
+    {
+        const size_t word_index = get_word_index(padded_x, padded_y);
+        const unsigned shift = padded_x & 63;
+        return ((words[word_index] >> shift) | ((words[word_index+1] << 1) << (63 - shift))) & 7;
+    }
+};
+
+#endif // LINE_ROUTER_GRID_BIT_GRID_2D_H_
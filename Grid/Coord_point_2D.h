@@ -13,39 +13,80 @@
 
 // Standard library headers
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
 // Need to forward declare this since Flat_point_2D is also dependent on Coord_point_2D
 class Flat_point_2D;
 
 // A 2D point coordinate class with coordinates x and y
+// The coordinates are stored as 32 bits and the class has no virtual functions, so a point is 8 bytes and trivially
+// copyable, e.g. a path of points is copied with memcpy. The constructors and getters take and return size_t so the
+// callers do not need to care about the storage. A coordinate must fit 32 bits, which it does on every grid a path
+// planner accepts since they are limited to 2^32 points, see Search_state_grid. The constructors throw a
+// std::out_of_range exception if a coordinate does not fit 32 bits.
 class Coord_point_2D
 {
 public:
-    Coord_point_2D();
-    Coord_point_2D(const size_t x, const size_t y);
+    constexpr Coord_point_2D() : x(0), y(0)
+    {
+    }
+
+    constexpr Coord_point_2D(const size_t x, const size_t y) : x(narrow(x)), y(narrow(y))
+    {
+    }
+
     // This constructor requires a division and a modulus operation
     Coord_point_2D(const Flat_point_2D& point, const size_t width);
 
-    virtual ~Coord_point_2D();
+    constexpr size_t get_x() const
+    {
+        return x;
+    }
 
-    size_t get_x() const;
-    size_t get_y() const;
+    constexpr size_t get_y() const
+    {
+        return y;
+    }
 
     // In a width x height grid that is build from a one dimensional (1D) array the flat index with the width coordinate
     // x and height coordinate y is defined as:
     // index = x + y * width
-    size_t get_flat_index(const size_t width) const;
+    constexpr size_t get_flat_index(const size_t width) const
+    {
+        return x + static_cast<size_t>(y) * width;
+    }
 
     // Compare operators
-    bool operator==(const Coord_point_2D& other_point) const;
-    bool operator!=(const Coord_point_2D& other_point) const;
+    constexpr bool operator==(const Coord_point_2D& other_point) const
+    {
+        return x == other_point.x && y == other_point.y;
+    }
+
+    constexpr bool operator!=(const Coord_point_2D& other_point) const
+    {
+        return not (*this == other_point);
+    }
 
 protected:
-    size_t x;
-    size_t y;
+    uint32_t x;
+    uint32_t y;
+
+private:
+    // Narrows a coordinate to 32 bits, throws if it does not fit
+    static constexpr uint32_t narrow(const size_t coordinate)
+    {
+        return coordinate <= std::numeric_limits<uint32_t>::max() ?
+               static_cast<uint32_t>(coordinate) : throw std::out_of_range("Coord_point_2D: Coordinate out of range");
+    }
 };
 
+static_assert(std::is_trivially_copyable<Coord_point_2D>::value, "Coord_point_2D must be trivially copyable");
+static_assert(sizeof(Coord_point_2D) == 8, "Coord_point_2D must be two 32 bit coordinates");
+
 // Prints the x and y coordinates to an std::ostream
 std::ostream& operator<<(std::ostream& os, const Coord_point_2D& point);
 
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Coord_rectangle_2D.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+
+Coord_rectangle_2D::Coord_rectangle_2D() : empty(true), min_x(0), min_y(0), max_x(0), max_y(0)
+{
+}
+
+Coord_rectangle_2D::Coord_rectangle_2D(const size_t min_x,
+                                       const size_t min_y,
+                                       const size_t max_x,
+                                       const size_t max_y) : empty(min_x > max_x || min_y > max_y),
+                                                             min_x(min_x),
+                                                             min_y(min_y),
+                                                             max_x(max_x),
+                                                             max_y(max_y)
+{
+}
+
+Coord_rectangle_2D::~Coord_rectangle_2D()
+{
+}
+
+bool Coord_rectangle_2D::is_empty() const
+{
+    return empty;
+}
+
+size_t Coord_rectangle_2D::get_min_x() const
+{
+    return min_x;
+}
+
+size_t Coord_rectangle_2D::get_min_y() const
+{
+    return min_y;
+}
+
+size_t Coord_rectangle_2D::get_max_x() const
+{
+    return max_x;
+}
+
+size_t Coord_rectangle_2D::get_max_y() const
+{
+    return max_y;
+}
+
+size_t Coord_rectangle_2D::get_width() const
+{
+    return empty ? 0 : max_x - min_x + 1;
+}
+
+size_t Coord_rectangle_2D::get_height() const
+{
+    return empty ? 0 : max_y - min_y + 1;
+}
+
+void Coord_rectangle_2D::add(const Coord_point_2D& point)
+{
+    add(Coord_rectangle_2D(point.get_x(), point.get_y(), point.get_x(), point.get_y()));
+}
+
+void Coord_rectangle_2D::add(const Coord_rectangle_2D& other_rectangle)
+{
+    if (other_rectangle.is_empty())
+    {
+        return;
+    }
+
+    if (empty)
+    {
+        *this = other_rectangle;
+        return;
+    }
+
+    min_x = other_rectangle.get_min_x() < min_x ? other_rectangle.get_min_x() : min_x;
+    min_y = other_rectangle.get_min_y() < min_y ? other_rectangle.get_min_y() : min_y;
+    max_x = other_rectangle.get_max_x() > max_x ? other_rectangle.get_max_x() : max_x;
+    max_y = other_rectangle.get_max_y() > max_y ? other_rectangle.get_max_y() : max_y;
+}
+
+bool Coord_rectangle_2D::operator==(const Coord_rectangle_2D& other_rectangle) const
+{
+    if (empty || other_rectangle.is_empty())
+    {
+        return empty == other_rectangle.is_empty();
+    }
+
+    return min_x == other_rectangle.get_min_x() && min_y == other_rectangle.get_min_y() &&
+           max_x == other_rectangle.get_max_x() && max_y == other_rectangle.get_max_y();
+}
+
+bool Coord_rectangle_2D::operator!=(const Coord_rectangle_2D& other_rectangle) const
+{
+    return not (*this == other_rectangle);
+}
+
+std::ostream& operator<<(std::ostream& os, const Coord_rectangle_2D& rectangle)
+{
+    if (rectangle.is_empty())
+    {
+        os << "(empty)";
+    }
+    else
+    {
+        os << "(x, y): (" << rectangle.get_min_x() << ", " << rectangle.get_min_y() << ") to (x, y): ("
+           << rectangle.get_max_x() << ", " << rectangle.get_max_y() << ")";
+    }
+    return os;
+}
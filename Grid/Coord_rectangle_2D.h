@@ -0,0 +1,63 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_GRID_COORD_RECTANGLE_2D_H_
+#define LINE_ROUTER_GRID_COORD_RECTANGLE_2D_H_
+
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <ostream>
+
+// An axis aligned rectangle of grid points. The minimum and maximum coordinates are both inside the rectangle. A
+// rectangle can be empty, i.e. contain no points, which is what the default constructor creates.
+class Coord_rectangle_2D
+{
+public:
+    // Creates an empty rectangle
+    Coord_rectangle_2D();
+    // Creates a rectangle from min_x, min_y to max_x, max_y, both included
+    Coord_rectangle_2D(const size_t min_x, const size_t min_y, const size_t max_x, const size_t max_y);
+
+    virtual ~Coord_rectangle_2D();
+
+    bool is_empty() const;
+
+    // The coordinates are only valid if the rectangle is not empty
+    size_t get_min_x() const;
+    size_t get_min_y() const;
+    size_t get_max_x() const;
+    size_t get_max_y() const;
+
+    // Number of points in x and y, zero if empty
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Grow the rectangle so that it contains the point
+    void add(const Coord_point_2D& point);
+
+    // Grow the rectangle so that it contains the other rectangle
+    void add(const Coord_rectangle_2D& other_rectangle);
+
+    // Compare operators, all empty rectangles are equal
+    bool operator==(const Coord_rectangle_2D& other_rectangle) const;
+    bool operator!=(const Coord_rectangle_2D& other_rectangle) const;
+
+protected:
+    bool empty;
+    size_t min_x;
+    size_t min_y;
+    size_t max_x;
+    size_t max_y;
+};
+
+// Prints the minimum and maximum coordinates to an std::ostream
+std::ostream& operator<<(std::ostream& os, const Coord_rectangle_2D& rectangle);
+
+#endif // LINE_ROUTER_GRID_COORD_RECTANGLE_2D_H_
@@ -11,6 +11,8 @@
 
 #include <Coord_point_2D.h>
 #include <Flat_point_2D.h>
+#include <Grid_layout.h>
+#include <Grid_width.h>
 
 // Standard library headers
 #include <cstddef>
@@ -22,16 +24,22 @@
 // coordinates
 // x = i % width
 // y = i / width
-// All get and set functions will throw an out of range exception from the std::vector if trying to set or get elements
-// that is out of bounds.
-template<typename T>
+// With the default Checked_row_major layout all get and set functions will throw an out of range exception from the
+// std::vector if trying to set or get elements that is out of bounds.
+// The conversions between coordinates and indices are done by the width policy, see Grid_width.h. A grid with a
+// Fixed_width or a Power_of_two_width throws if it is created or resized to a width that the policy does not support.
+// Where the elements are stored in the std::vector, and if the access is range checked, is decided by the layout
+// policy, see Grid_layout.h. The flat indices are the same for all layouts.
+template<typename T, typename Width_policy = Runtime_width, typename Layout = Checked_row_major>
 class Flat_grid_2D
 {
 public:
     // Creates a width x height grid with an initial value set to all points
     Flat_grid_2D(const size_t width, const size_t height, const T& initial_value = T()) :
-                                                                                       vec(width*height, initial_value),
-                                                                                       width(width),
+                                                                                       layout(width, height),
+                                                                                       vec(layout.get_storage_size(),
+                                                                                           initial_value),
+                                                                                       grid_width(width),
                                                                                        height(height)
     {
     }
@@ -42,7 +50,7 @@ public:
 
     size_t get_width() const
     {
-        return width;
+        return grid_width.get_width();
     }
 
     size_t get_height() const
@@ -59,30 +67,31 @@ public:
     // Resize and fill grid points with value
     void resize(const size_t width, const size_t height, const T& value = T())
     {
-        this->width = width;
+        grid_width = Width_policy(width);
+        layout = Layout(width, height);
         this->height = height;
-        vec.resize(width*height, value);
+        vec.resize(layout.get_storage_size(), value);
     }
 
     // Get value of element at flat_index
     T get(const size_t flat_index) const
     {
-        return vec.at(flat_index);
+        return Layout::get_element(vec, layout.get_storage_index(flat_index, grid_width));
     }
     // Get value of element at point
-    T get(const Flat_point_2D& point) const
+    T get(const Flat_point_2D point) const
     {
-        return vec.at(point.get_flat_index());
+        return get(point.get_flat_index());
     }
     // Set value of element at flat_index
     void set(const size_t flat_index, const T& value)
     {
-        vec.at(flat_index) = value;
+        Layout::get_element(vec, layout.get_storage_index(flat_index, grid_width)) = value;
     }
     // Set value of element at point
-    void set(const Flat_point_2D& point, const T& value)
+    void set(const Flat_point_2D point, const T& value)
     {
-        vec.at(point.get_flat_index()) = value;
+        set(point.get_flat_index(), value);
     }
 
     // Note that the functions below requires a division and a modulus operation
@@ -91,36 +100,57 @@ public:
     // y = index / width
     T get(const size_t x, const size_t y) const
     {
-        return vec.at(get_flat_index(x, y));
+        return Layout::get_element(vec, layout.get_storage_index(x, y, grid_width));
     }
     // Get value of element at coordinate point. The coordinates need to be converted as described above.
-    T get(const Coord_point_2D& point) const
+    T get(const Coord_point_2D point) const
     {
-        return vec.at(point.get_flat_index(width));
+        return get(point.get_x(), point.get_y());
     }
     // Set value of element at coordinate x and y. The coordinates need to be converted as described above.
     void set(const size_t x, const size_t y, const T& value)
     {
-        vec.at(get_flat_index(x, y)) = value;
+        Layout::get_element(vec, layout.get_storage_index(x, y, grid_width)) = value;
     }
     // Set value of element at coordinate point. The coordinates need to be converted as described above.
-    void set(const Coord_point_2D& point, const T& value)
+    void set(const Coord_point_2D point, const T& value)
     {
-        vec.at(point.get_flat_index(width)) = value;
+        set(point.get_x(), point.get_y(), value);
+    }
+
+    // Get the coordinates of the element at flat_index. The coordinates are converted as described above.
+    Coord_point_2D get_coord_point(const size_t flat_index) const
+    {
+        return Coord_point_2D(grid_width.get_x(flat_index), grid_width.get_y(flat_index));
+    }
+
+    // Index in the std::vector of the element at flat_index, calculated with another width policy for the same width,
+    // e.g. the one a path planner is specialized for. Grids of the same size and layout store a point at the same
+    // index, so it only needs to be calculated once to access all of them with get_stored and set_stored.
+    template<typename Other_width_policy>
+    size_t get_storage_index(const size_t flat_index, const Other_width_policy& other_grid_width) const
+    {
+        return layout.get_storage_index(flat_index, other_grid_width);
+    }
+
+    // Get value of element at storage_index, see get_storage_index
+    T get_stored(const size_t storage_index) const
+    {
+        return Layout::get_element(vec, storage_index);
+    }
+    // Set value of element at storage_index, see get_storage_index
+    void set_stored(const size_t storage_index, const T& value)
+    {
+        Layout::get_element(vec, storage_index) = value;
     }
 
 protected:
+    Layout layout;
     std::vector<T> vec;
 
 private:
-    size_t width;
+    Width_policy grid_width;
     size_t height;
-
-    // Convert x and y coordinates to flat_point. See class description.
-    size_t get_flat_index(const size_t x, const size_t y) const
-    {
-        return x + y * width;
-    }
 };
 
 #endif // LINE_ROUTER_GRID_FLAT_GRID_2D_H_
@@ -10,11 +10,14 @@
 #define LINE_ROUTER_GRID_FLAT_POINT_2D_H_
 
 #include <Coord_point_2D.h>
-#include <Flat_point_2D.h>
 
 // Standard library headers
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
 // Need to forward declare this since Coord_point_2D is also dependent on Flat_point_2D
 class Coord_point_2D;
@@ -22,36 +25,73 @@ class Coord_point_2D;
 // A two dimensional (2D) point that is built up from a one dimensional (1D) index. In a width x height grid with width
 // coordinate x and height coordinate y the index is defined as
 // flat_index = x + y*width
+// The flat index is stored as 32 bits and the class has no virtual functions, so a point is 4 bytes and trivially
+// copyable. The grids of the path planners have at most 2^32 points, see Search_state_grid and Coord_point_2D. The
+// constructors throw a std::out_of_range exception if the flat index does not fit 32 bits.
 class Flat_point_2D
 {
 public:
-    Flat_point_2D();
-    Flat_point_2D(const size_t flat_index);
+    constexpr Flat_point_2D() : flat_index(0)
+    {
+    }
+
+    constexpr Flat_point_2D(const size_t flat_index) : flat_index(narrow(flat_index))
+    {
+    }
+
     // These two constructors requires a multiplication and a addition operation
-    Flat_point_2D(const size_t x, const size_t y, const size_t width);
+    constexpr Flat_point_2D(const size_t x, const size_t y, const size_t width) : flat_index(narrow(x + y*width))
+    {
+    }
     Flat_point_2D(const Coord_point_2D& point, const size_t width);
 
-    virtual ~Flat_point_2D();
-
     // See class description
-    size_t get_flat_index() const;
+    constexpr size_t get_flat_index() const
+    {
+        return flat_index;
+    }
 
     // The x and y-coordinates iare calculated from the flat index as
     // x = flat_index % width
     // y = flat_index / width
     // where the width is the width of a grid where the point lives
-    size_t get_x(const size_t width) const;
-    size_t get_y(const size_t width) const;
+    constexpr size_t get_x(const size_t width) const
+    {
+        return flat_index % width;
+    }
+
+    constexpr size_t get_y(const size_t width) const
+    {
+        return flat_index / width;
+    }
+
+    constexpr bool operator==(const Flat_point_2D& other_point) const
+    {
+        return flat_index == other_point.flat_index;
+    }
 
-    bool operator==(const Flat_point_2D& other_point) const;
     // This operator is mainly used for sorting
-    bool operator<(const Flat_point_2D& other_point) const;
+    constexpr bool operator<(const Flat_point_2D& other_point) const
+    {
+        return flat_index < other_point.flat_index;
+    }
 
 protected:
     // See class description
-    size_t flat_index;
+    uint32_t flat_index;
+
+private:
+    // Narrows the flat index to 32 bits, throws if it does not fit
+    static constexpr uint32_t narrow(const size_t flat_index)
+    {
+        return flat_index <= std::numeric_limits<uint32_t>::max() ?
+               static_cast<uint32_t>(flat_index) : throw std::out_of_range("Flat_point_2D: Flat index out of range");
+    }
 };
 
+static_assert(std::is_trivially_copyable<Flat_point_2D>::value, "Flat_point_2D must be trivially copyable");
+static_assert(sizeof(Flat_point_2D) == 4, "Flat_point_2D must be a 32 bit flat index");
+
 // Prints the flat index to an std::ostream
 std::ostream& operator<<(std::ostream& os, const Flat_point_2D& point);
 
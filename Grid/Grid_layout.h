@@ -0,0 +1,179 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_GRID_GRID_LAYOUT_H_
+#define LINE_ROUTER_GRID_GRID_LAYOUT_H_
+
+// Standard library headers
+#include <cstddef>
+#include <vector>
+
+// The layout policies decide where the element of a point is stored in the std::vector of a Flat_grid_2D, and if the
+// access is range checked. The points are always addressed with the row major flat index, see Flat_point_2D, so the
+// layout can be changed without changing the code that uses the grid:
+// - Checked_row_major: The element of flat index i is stored in index i and std::vector::at throws if i is out of
+//   range. This is the default.
+// - Unchecked_row_major: As Checked_row_major but without the range check.
+// - Tiled<Tile_size>: The grid is split into Tile_size x Tile_size tiles that are stored one after the other, row by
+//   row, and the points of a tile are stored row by row within the tile. The neighbors of a point are then in the same
+//   tile, and mostly in the same cache lines, also when the grid is wide. Finding the tile needs the x and y
+//   coordinates, i.e. a division by the width unless the width policy avoids it, see Grid_width.h. The grid is padded
+//   to whole tiles and the access is not range checked, a flat index outside the grid gives undefined behavior.
+// A layout is created from the width and the height of the grid.
+
+class Checked_row_major
+{
+public:
+    Checked_row_major(const size_t width, const size_t height) : storage_size(width * height)
+    {
+    }
+
+    static const char* get_name()
+    {
+        return "checked row major";
+    }
+
+    // Number of elements to store for the grid
+    size_t get_storage_size() const
+    {
+        return storage_size;
+    }
+
+    // Index in the std::vector of the point at flat_index, or at x and y
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t flat_index, const Width_policy&) const
+    {
+        return flat_index;
+    }
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t x, const size_t y, const Width_policy& grid_width) const
+    {
+        return grid_width.get_flat_index(x, y);
+    }
+
+    // Element at storage_index, throws an out of range exception if it is outside the std::vector
+    template<typename T>
+    static T& get_element(std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec.at(storage_index);
+    }
+
+    template<typename T>
+    static const T& get_element(const std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec.at(storage_index);
+    }
+
+private:
+    size_t storage_size;
+};
+
+class Unchecked_row_major
+{
+public:
+    Unchecked_row_major(const size_t width, const size_t height) : storage_size(width * height)
+    {
+    }
+
+    static const char* get_name()
+    {
+        return "unchecked row major";
+    }
+
+    size_t get_storage_size() const
+    {
+        return storage_size;
+    }
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t flat_index, const Width_policy&) const
+    {
+        return flat_index;
+    }
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t x, const size_t y, const Width_policy& grid_width) const
+    {
+        return grid_width.get_flat_index(x, y);
+    }
+
+    template<typename T>
+    static T& get_element(std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec[storage_index];
+    }
+
+    template<typename T>
+    static const T& get_element(const std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec[storage_index];
+    }
+
+private:
+    size_t storage_size;
+};
+
+template<size_t Tile_size>
+class Tiled
+{
+    static_assert(Tile_size > 0 && (Tile_size & (Tile_size - 1)) == 0, "Tiled: Tile_size must be a power of two");
+
+public:
+    Tiled(const size_t width, const size_t height) : tiles_per_row((width + Tile_size - 1) / Tile_size),
+                                                     storage_size(tiles_per_row * Tile_size *
+                                                                  ((height + Tile_size - 1) / Tile_size) * Tile_size)
+    {
+    }
+
+    static const char* get_name()
+    {
+        return Tile_size == 8 ? "tiled 8x8" : Tile_size == 16 ? "tiled 16x16" : "tiled";
+    }
+
+    static constexpr size_t get_tile_size()
+    {
+        return Tile_size;
+    }
+
+    size_t get_storage_size() const
+    {
+        return storage_size;
+    }
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return get_storage_index(grid_width.get_x(flat_index), grid_width.get_y(flat_index), grid_width);
+    }
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t x, const size_t y, const Width_policy&) const
+    {
+        const size_t tile_index = (y / Tile_size) * tiles_per_row + x / Tile_size;
+        return tile_index * Tile_size * Tile_size + (y % Tile_size) * Tile_size + x % Tile_size;
+    }
+
+    template<typename T>
+    static T& get_element(std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec[storage_index];
+    }
+
+    template<typename T>
+    static const T& get_element(const std::vector<T>& vec, const size_t storage_index)
+    {
+        return vec[storage_index];
+    }
+
+private:
+    size_t tiles_per_row;
+    size_t storage_size;
+};
+
+#endif // LINE_ROUTER_GRID_GRID_LAYOUT_H_
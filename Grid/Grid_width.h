@@ -0,0 +1,154 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_GRID_GRID_WIDTH_H_
+#define LINE_ROUTER_GRID_GRID_WIDTH_H_
+
+// Standard library headers
+#include <cstddef>
+
+// The width policies convert between the x and y coordinates and the flat index of a point in a grid, see
+// Flat_point_2D. Going from a flat index to x and y is a modulus and a division by the width, which is slow when the
+// width is only known at runtime. The policies are template parameters of Flat_grid_2D and
+// A_star_planner_specialization so the conversions are inlined without any runtime branching:
+// - Runtime_width: Any width. A modulus and a division.
+// - Power_of_two_width: A width that is a power of two, known at runtime. A mask and a shift.
+// - Fixed_width<Width>: A width known at compile time, e.g. the 600 x 600 boards. The compiler turns the division into
+//   a multiplication and a shift, or a shift alone if Width is a power of two.
+// A policy is created from the runtime width. is_supported tells if a width can be used with a policy, the constructor
+// throws if it can not.
+
+class Runtime_width
+{
+public:
+    explicit Runtime_width(const size_t width) : width(width)
+    {
+    }
+
+    static bool is_supported(const size_t)
+    {
+        return true;
+    }
+
+    size_t get_width() const
+    {
+        return width;
+    }
+
+    size_t get_flat_index(const size_t x, const size_t y) const
+    {
+        return x + y * width;
+    }
+
+    size_t get_x(const size_t flat_index) const
+    {
+        return flat_index % width;
+    }
+
+    size_t get_y(const size_t flat_index) const
+    {
+        return flat_index / width;
+    }
+
+private:
+    size_t width;
+};
+
+class Power_of_two_width
+{
+public:
+    explicit Power_of_two_width(const size_t width) : shift(get_shift(width)), mask(width - 1)
+    {
+    }
+
+    static bool is_supported(const size_t width)
+    {
+        return width > 0 && (width & (width - 1)) == 0;
+    }
+
+    size_t get_width() const
+    {
+        return mask + 1;
+    }
+
+    size_t get_flat_index(const size_t x, const size_t y) const
+    {
+        return x + (y << shift);
+    }
+
+    size_t get_x(const size_t flat_index) const
+    {
+        return flat_index & mask;
+    }
+
+    size_t get_y(const size_t flat_index) const
+    {
+        return flat_index >> shift;
+    }
+
+private:
+    size_t shift;
+    size_t mask;
+
+    static size_t get_shift(const size_t width)
+    {
+        if (not is_supported(width))
+        {
+            throw "Power_of_two_width::Power_of_two_width: The width is not a power of two";
+        }
+
+        size_t shift = 0;
+        while ((size_t(1) << shift) < width)
+        {
+            shift++;
+        }
+        return shift;
+    }
+};
+
+template<size_t Width>
+class Fixed_width
+{
+    static_assert(Width > 0, "Fixed_width: Width must be at least one");
+
+public:
+    explicit Fixed_width(const size_t width)
+    {
+        if (not is_supported(width))
+        {
+            throw "Fixed_width::Fixed_width: The width does not match the fixed width";
+        }
+    }
+
+    static bool is_supported(const size_t width)
+    {
+        return width == Width;
+    }
+
+    static constexpr size_t get_width()
+    {
+        return Width;
+    }
+
+    static constexpr size_t get_flat_index(const size_t x, const size_t y)
+    {
+        return x + y * Width;
+    }
+
+    static constexpr size_t get_x(const size_t flat_index)
+    {
+        return flat_index % Width;
+    }
+
+    static constexpr size_t get_y(const size_t flat_index)
+    {
+        return flat_index / Width;
+    }
+};
+
+#endif // LINE_ROUTER_GRID_GRID_WIDTH_H_
@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <Bit_grid_2D.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Setup a grid and check that the width, height and initial values are set correctly and that a value is set
+// correctly
+TEST(Bit_grid_2D, Get_and_set)
+{
+    const size_t grid_width  = 130;
+    const size_t grid_height = 70;
+
+    Bit_grid_2D bit_grid(grid_width, grid_height, true);
+
+    EXPECT_EQ(bit_grid.get_width(),  grid_width);
+    EXPECT_EQ(bit_grid.get_height(), grid_height);
+
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        for (size_t x = 0; x < grid_width; x++)
+        {
+            EXPECT_TRUE(bit_grid.get(x, y));
+        }
+    }
+
+    bit_grid.set(63, 5, false);
+    EXPECT_FALSE(bit_grid.get(63, 5));
+    EXPECT_TRUE(bit_grid.get(62, 5));
+    EXPECT_TRUE(bit_grid.get(64, 5));
+    bit_grid.set(63, 5, true);
+    EXPECT_TRUE(bit_grid.get(63, 5));
+
+    bit_grid.fill(false);
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        for (size_t x = 0; x < grid_width; x++)
+        {
+            EXPECT_FALSE(bit_grid.get(x, y));
+        }
+    }
+
+    EXPECT_THROW(bit_grid.get(grid_width, 0), std::out_of_range);
+    EXPECT_THROW(bit_grid.set(0, grid_height, true), std::out_of_range);
+}
+
+// Check that the neighbor mask of every point matches the values of its neighbors, also across word boundaries and at
+// the border
+TEST(Bit_grid_2D, Neighbor_mask)
+{
+    const size_t grid_width  = 200;
+    const size_t grid_height = 20;
+
+    Bit_grid_2D bit_grid(grid_width, grid_height);
+
+    std::mt19937 random_generator(4711);
+    std::bernoulli_distribution random_value(0.5);
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        for (size_t x = 0; x < grid_width; x++)
+        {
+            bit_grid.set(x, y, random_value(random_generator));
+        }
+    }
+
+    // Neighbors in the order of Bit_grid_2D::Neighbor_bit
+    const int dx[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+    const int dy[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        for (size_t x = 0; x < grid_width; x++)
+        {
+            uint8_t expected_mask = 0;
+            for (size_t bit = 0; bit < 8; bit++)
+            {
+                const int neighbor_x = static_cast<int>(x) + dx[bit];
+                const int neighbor_y = static_cast<int>(y) + dy[bit];
+                if (neighbor_x >= 0 && neighbor_y >= 0 &&
+                    neighbor_x < static_cast<int>(grid_width) && neighbor_y < static_cast<int>(grid_height) &&
+                    bit_grid.get(neighbor_x, neighbor_y))
+                {
+                    expected_mask |= uint8_t(1) << bit;
+                }
+            }
+            ASSERT_EQ(bit_grid.get_neighbor_mask(x, y), expected_mask) << "x: " << x << " y: " << y;
+        }
+    }
+
+    // The border must stay blocked when the whole grid is filled
+    bit_grid.fill(true);
+    EXPECT_EQ(bit_grid.get_neighbor_mask(0, 0), uint8_t((1 << Bit_grid_2D::right_bit) |
+                                                        (1 << Bit_grid_2D::down_bit)  |
+                                                        (1 << Bit_grid_2D::lower_right_bit)));
+    EXPECT_EQ(bit_grid.get_neighbor_mask(grid_width-1, grid_height-1), uint8_t((1 << Bit_grid_2D::left_bit) |
+                                                                               (1 << Bit_grid_2D::up_bit)   |
+                                                                               (1 << Bit_grid_2D::upper_left_bit)));
+    EXPECT_EQ(bit_grid.get_neighbor_mask(63, 10), uint8_t(0xFF));
+}
+
+// Check that the points inside both the old and the new grid are kept when resizing
+TEST(Bit_grid_2D, Resize)
+{
+    Bit_grid_2D bit_grid(100, 10, true);
+    bit_grid.set(50, 5, false);
+    bit_grid.set(99, 9, false);
+
+    bit_grid.resize(60, 8, true);
+    EXPECT_EQ(bit_grid.get_width(),  size_t(60));
+    EXPECT_EQ(bit_grid.get_height(), size_t(8));
+    EXPECT_FALSE(bit_grid.get(50, 5));
+    EXPECT_TRUE(bit_grid.get(59, 7));
+
+    // The old points outside the smaller grid must not come back as the border
+    EXPECT_EQ(bit_grid.get_neighbor_mask(59, 7), uint8_t((1 << Bit_grid_2D::left_bit) |
+                                                         (1 << Bit_grid_2D::up_bit)   |
+                                                         (1 << Bit_grid_2D::upper_left_bit)));
+
+    bit_grid.resize(200, 12, false);
+    EXPECT_FALSE(bit_grid.get(50, 5));
+    EXPECT_TRUE(bit_grid.get(59, 7));
+    EXPECT_FALSE(bit_grid.get(60, 7));
+    EXPECT_FALSE(bit_grid.get(99, 9));
+    EXPECT_FALSE(bit_grid.get(199, 11));
+}
+
+// Clear random points with a halo and compare with clearing every point and neighbor one by one
+TEST(Bit_grid_2D, Clear_dilated)
+{
+    const size_t grid_width  = 150;
+    const size_t grid_height = 40;
+
+    std::mt19937 random_generator(4711);
+    std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+    std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+
+    for (size_t radius = 0; radius <= 3; radius++)
+    {
+        Bit_grid_2D bit_grid(grid_width, grid_height, true);
+        Bit_grid_2D expected_bit_grid(grid_width, grid_height, true);
+
+        std::vector<Coord_point_2D> points;
+        for (size_t i = 0; i < 30; i++)
+        {
+            points.push_back(Coord_point_2D(random_x(random_generator), random_y(random_generator)));
+        }
+        // Points at the corners and at the word boundaries
+        points.push_back(Coord_point_2D(0, 0));
+        points.push_back(Coord_point_2D(grid_width-1, grid_height-1));
+        points.push_back(Coord_point_2D(62, 20));
+        points.push_back(Coord_point_2D(127, 21));
+
+        Coord_rectangle_2D expected_rectangle;
+        for (const Coord_point_2D& point : points)
+        {
+            for (size_t y = point.get_y() > radius ? point.get_y() - radius : 0;
+                 y <= point.get_y() + radius && y < grid_height; y++)
+            {
+                for (size_t x = point.get_x() > radius ? point.get_x() - radius : 0;
+                     x <= point.get_x() + radius && x < grid_width; x++)
+                {
+                    expected_bit_grid.set(x, y, false);
+                    expected_rectangle.add(Coord_point_2D(x, y));
+                }
+            }
+        }
+
+        EXPECT_EQ(bit_grid.clear_dilated(points, radius), expected_rectangle);
+
+        for (size_t y = 0; y < grid_height; y++)
+        {
+            for (size_t x = 0; x < grid_width; x++)
+            {
+                ASSERT_EQ(bit_grid.get(x, y), expected_bit_grid.get(x, y)) << "x: " << x << " y: " << y
+                                                                           << " radius: " << radius;
+                ASSERT_EQ(bit_grid.get_neighbor_mask(x, y), expected_bit_grid.get_neighbor_mask(x, y));
+            }
+        }
+    }
+
+    // Nothing is cleared for an empty path
+    Bit_grid_2D bit_grid(10, 10, true);
+    EXPECT_TRUE(bit_grid.clear_dilated(std::vector<Coord_point_2D>(), 1).is_empty());
+    EXPECT_THROW(bit_grid.clear_dilated(std::vector<Coord_point_2D>(1, Coord_point_2D(10, 0)), 1), std::out_of_range);
+}
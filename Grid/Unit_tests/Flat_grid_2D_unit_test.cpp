@@ -14,6 +14,7 @@
 
 // Standard library headers
 #include <cstddef>
+#include <cstdint>
 
 // Setup a float grid and check that the width, height, initial values are set correctly
 // Also check that a value is set correctly
@@ -42,6 +43,113 @@ TEST(Flat_grid_2D, Float_grid)
     EXPECT_FLOAT_EQ(flat_grid.get(x, y), value);
 }
 
+// The points are constexpr, so a point and its flat index can be calculated at compile time. Also check that the
+// conversions between the points work on the largest coordinates of a 65536 x 65536 grid.
+TEST(Flat_grid_2D, Compact_points)
+{
+    constexpr size_t grid_width = 65536;
+    constexpr Coord_point_2D coord_point(65535, 65535);
+    static_assert(coord_point.get_flat_index(grid_width) == 65536ul * 65536ul - 1, "Wrong flat index");
+    constexpr Flat_point_2D flat_point(12, 34, grid_width);
+    static_assert(flat_point.get_x(grid_width) == 12 && flat_point.get_y(grid_width) == 34, "Wrong coordinates");
+
+    const Flat_point_2D last_point(coord_point, grid_width);
+    EXPECT_EQ(last_point.get_flat_index(), grid_width * grid_width - 1);
+    EXPECT_EQ(Coord_point_2D(last_point, grid_width), coord_point);
+
+    Flat_grid_2D<uint8_t> flat_grid(100, 100);
+    flat_grid.set(Flat_point_2D(99, 99, 100), 7);
+    EXPECT_EQ(flat_grid.get(Coord_point_2D(99, 99)), 7);
+}
+
+// The width policies convert between flat indices and coordinates in the same way
+TEST(Flat_grid_2D, Width_policies)
+{
+    const Runtime_width runtime_width(600);
+    const Fixed_width<600> fixed_width(600);
+    const Runtime_width runtime_power_of_two_width(1024);
+    const Power_of_two_width power_of_two_width(1024);
+    for (size_t flat_index = 0; flat_index < 600 * 1024; flat_index += 7)
+    {
+        EXPECT_EQ(fixed_width.get_x(flat_index), runtime_width.get_x(flat_index));
+        EXPECT_EQ(fixed_width.get_y(flat_index), runtime_width.get_y(flat_index));
+        EXPECT_EQ(power_of_two_width.get_x(flat_index), runtime_power_of_two_width.get_x(flat_index));
+        EXPECT_EQ(power_of_two_width.get_y(flat_index), runtime_power_of_two_width.get_y(flat_index));
+        EXPECT_EQ(power_of_two_width.get_flat_index(power_of_two_width.get_x(flat_index),
+                                                    power_of_two_width.get_y(flat_index)), flat_index);
+    }
+    EXPECT_EQ(power_of_two_width.get_width(), size_t(1024));
+
+    // A grid with a width policy throws if the width is not supported
+    Flat_grid_2D<float, Fixed_width<600>> fixed_grid(600, 600, 1.0f);
+    fixed_grid.set(Coord_point_2D(599, 599), 2.0f);
+    EXPECT_FLOAT_EQ(fixed_grid.get(fixed_grid.get_width() * fixed_grid.get_width() - 1), 2.0f);
+    EXPECT_EQ(fixed_grid.get_coord_point(600 * 12 + 34), Coord_point_2D(34, 12));
+    EXPECT_THROW(fixed_grid.resize(601, 600), const char*);
+    EXPECT_THROW((Flat_grid_2D<float, Power_of_two_width>(600, 600)), const char*);
+}
+
+// Set a value to every point of a width x height grid with the coordinates and check that the values are read back
+// from the same points with the flat indices
+template<typename Layout>
+void check_layout(const size_t width, const size_t height)
+{
+    Flat_grid_2D<uint32_t, Runtime_width, Layout> flat_grid(width, height, 0);
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            flat_grid.set(Coord_point_2D(x, y), static_cast<uint32_t>(x + y * width + 1));
+        }
+    }
+    for (size_t flat_index = 0; flat_index < width * height; flat_index++)
+    {
+        EXPECT_EQ(flat_grid.get(flat_index), flat_index + 1) << Layout::get_name();
+        EXPECT_EQ(flat_grid.get(Flat_point_2D(flat_index)), flat_index + 1) << Layout::get_name();
+    }
+    flat_grid.set(Flat_point_2D(width - 1, height - 1, width), 0);
+    EXPECT_EQ(flat_grid.get(width - 1, height - 1), uint32_t(0)) << Layout::get_name();
+}
+
+// All layouts store the points at the same flat indices. The tiled layouts are padded to whole tiles and keep the
+// neighbors of a point in the same tile.
+TEST(Flat_grid_2D, Layouts)
+{
+    check_layout<Checked_row_major>(37, 23);
+    check_layout<Unchecked_row_major>(37, 23);
+    check_layout<Tiled<8>>(37, 23);
+    check_layout<Tiled<16>>(37, 23);
+    check_layout<Tiled<8>>(64, 64);
+
+    const Runtime_width runtime_width(37);
+    const Tiled<8> tiled(37, 23);
+    EXPECT_EQ(tiled.get_storage_size(), size_t(40 * 24));
+    EXPECT_EQ(tiled.get_storage_index(runtime_width.get_flat_index(9, 1), runtime_width), size_t(64 + 8 + 1));
+    EXPECT_EQ(tiled.get_storage_index(10, 1, runtime_width), tiled.get_storage_index(9, 1, runtime_width) + 1);
+    EXPECT_EQ(tiled.get_storage_index(9, 2, runtime_width), tiled.get_storage_index(9, 1, runtime_width) + 8);
+    EXPECT_EQ(tiled.get_storage_index(0, 8, runtime_width), size_t(5 * 64));
+
+    // The storage index can be calculated with another width policy for the same width and used for all grids of the
+    // same size and layout
+    Flat_grid_2D<uint32_t, Runtime_width, Tiled<8>> tiled_grid(64, 40, 0);
+    Flat_grid_2D<uint8_t, Runtime_width, Tiled<8>> other_tiled_grid(64, 40, 0);
+    const Power_of_two_width power_of_two_width(64);
+    const size_t storage_index = tiled_grid.get_storage_index(64 * 17 + 9, power_of_two_width);
+    EXPECT_EQ(storage_index, tiled_grid.get_storage_index(64 * 17 + 9, Runtime_width(64)));
+    tiled_grid.set_stored(storage_index, 5);
+    other_tiled_grid.set_stored(storage_index, 6);
+    EXPECT_EQ(tiled_grid.get(9, 17), uint32_t(5));
+    EXPECT_EQ(other_tiled_grid.get(64 * 17 + 9), uint8_t(6));
+    EXPECT_EQ(tiled_grid.get_stored(storage_index), uint32_t(5));
+
+    // Only the checked layout throws when a point is out of range
+    Flat_grid_2D<float, Runtime_width, Checked_row_major> checked_grid(10, 10);
+    EXPECT_ANY_THROW(checked_grid.get(100));
+    Flat_grid_2D<float, Runtime_width, Unchecked_row_major> unchecked_grid(10, 10, 1.0f);
+    unchecked_grid.resize(20, 10, 1.0f);
+    EXPECT_FLOAT_EQ(unchecked_grid.get(199), 1.0f);
+}
+
 // Create a large grid (1 gigabyte) and see that all initial values are set correctly
 TEST(Flat_grid_2D, Large_int32_grid)
 {
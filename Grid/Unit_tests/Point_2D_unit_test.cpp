@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <Coord_point_2D.h>
+#include <Flat_point_2D.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// Convert between coordinates and flat indices and check that the points are the same
+TEST(Point_2D, Coord_and_flat_point)
+{
+    const size_t width = 130;
+
+    const Coord_point_2D coord_point(17, 42);
+    const Flat_point_2D flat_point(coord_point, width);
+    EXPECT_EQ(flat_point.get_flat_index(), size_t(17 + 42 * width));
+    EXPECT_EQ(flat_point, Flat_point_2D(17, 42, width));
+    EXPECT_EQ(Coord_point_2D(flat_point, width), coord_point);
+}
+
+// The largest values that fit 32 bits are stored as they are, one more throws instead of wrapping around
+TEST(Point_2D, Out_of_range)
+{
+    const size_t max_value = std::numeric_limits<uint32_t>::max();
+
+    EXPECT_EQ(Flat_point_2D(max_value).get_flat_index(), max_value);
+    EXPECT_THROW(Flat_point_2D(max_value + 1), std::out_of_range);
+    EXPECT_THROW(Flat_point_2D(0, max_value + 1, 1), std::out_of_range);
+    EXPECT_THROW(Flat_point_2D(Coord_point_2D(0, 1 << 16), size_t(1) << 16), std::out_of_range);
+
+    const Coord_point_2D coord_point(max_value, max_value);
+    EXPECT_EQ(coord_point.get_x(), max_value);
+    EXPECT_EQ(coord_point.get_y(), max_value);
+    EXPECT_THROW(Coord_point_2D(max_value + 1, 0), std::out_of_range);
+    EXPECT_THROW(Coord_point_2D(0, max_value + 1), std::out_of_range);
+}
@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Batch_job.h>
+#include <A_star_planner.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+// Route a batch job without any UI, see Batch_job for the file format
+// Usage: line_router_batch [--fixed_point] <job file> [<result file>]
+// The results are written to the result file, or to standard output if no result file is given.
+int main(int argc, char** argv)
+{
+    bool fixed_point = false;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--fixed_point") == 0)
+        {
+            fixed_point = true;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty() || files.size() > 2)
+    {
+        std::cout << "Usage: " << argv[0] << " [--fixed_point] <job file> [<result file>]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream job_file(files[0]);
+    if (not job_file)
+    {
+        std::cerr << "ERROR: Could not open " << files[0] << std::endl;
+        return 1;
+    }
+
+    Batch_job batch_job;
+    if (not batch_job.read(job_file))
+    {
+        return 1;
+    }
+
+    // Set up the path planner like the Line router does
+    const std::shared_ptr<Availability_grid> availability_grid = batch_job.create_availability_grid();
+    availability_grid->set_legal_move_cache_enabled(true);
+    availability_grid->set_component_index_enabled(true);
+    A_star_planner a_star_planner(availability_grid);
+    if (fixed_point)
+    {
+        a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+    }
+
+    std::vector<Batch_job::Net_result> results;
+    batch_job.route(a_star_planner, results);
+
+    std::ofstream result_file;
+    if (files.size() == 2)
+    {
+        result_file.open(files[1]);
+        if (not result_file)
+        {
+            std::cerr << "ERROR: Could not open " << files[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = files.size() == 2 ? result_file : std::cout;
+    output << std::setprecision(3) << std::fixed;
+    batch_job.write_results(output, results);
+
+    return 0;
+}
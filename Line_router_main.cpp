@@ -31,6 +31,12 @@ int main(int argc, char** argv)
     const size_t grid_height = 600;
     std::shared_ptr<Path_planner> path_planner = std::make_shared<A_star_planner>(grid_width, grid_height);
 
+    // Only the points around each routed line change, keep the legal moves of all points cached
+    path_planner->get_availability_grid()->set_legal_move_cache_enabled(true);
+
+    // Lines drawn into an area that has been closed off are rejected without searching
+    path_planner->get_availability_grid()->set_component_index_enabled(true);
+
     // Create the Line router window
     Line_router_window line_router_window(path_planner);
 
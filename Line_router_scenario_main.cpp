@@ -0,0 +1,177 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Moving_ai_map.h>
+#include <Moving_ai_scenario.h>
+#include <Scenario_runner.h>
+#include <A_star_planner.h>
+#include <JPS_planner.h>
+#include <Bidirectional_A_star_planner.h>
+#include <HPA_star_planner.h>
+#include <Path_planner.h>
+
+// Standard library headers
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Get the directory part of a file path, including the last slash
+std::string get_directory(const std::string& file_path)
+{
+    const size_t slash_position = file_path.find_last_of('/');
+    return slash_position == std::string::npos ? std::string() : file_path.substr(0, slash_position + 1);
+}
+
+// Load a map of the scenario. The map name is first looked up relative to the map directory and then by its file
+// name only, since the scenario files often have the map name relative to the root of the corpus.
+std::shared_ptr<Availability_grid> load_map(const std::string& map_directory, const std::string& map_name)
+{
+    const std::string file_name = map_name.substr(map_name.find_last_of('/') + 1);
+    for (const std::string& map_path : {map_directory + map_name, map_directory + file_name})
+    {
+        std::ifstream map_file(map_path);
+        if (map_file)
+        {
+            Moving_ai_map map;
+            if (not map.read(map_file))
+            {
+                std::cerr << "ERROR: Could not read " << map_path << std::endl;
+                return nullptr;
+            }
+            return map.get_availability_grid();
+        }
+    }
+
+    std::cerr << "ERROR: Could not find map " << map_name << " in " << map_directory << std::endl;
+    return nullptr;
+}
+
+} // namespace
+
+// Run all queries of a Moving AI scenario file and write the latency, expansions and suboptimality per bucket, see
+// Moving_ai_scenario and Scenario_runner.
+// Usage: line_router_scenarios [--fixed_point] [--jps | --bidirectional | --hpa] <scenario file> [<map directory>]
+// The JPS planner only uses the floating point costs. The HPA* planner builds its abstract graph in the first query on
+// every map.
+// The maps are looked up in the map directory, or in the directory of the scenario file if no map directory is given.
+int main(int argc, char** argv)
+{
+    bool fixed_point = false;
+    bool jps = false;
+    bool bidirectional = false;
+    bool hpa = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--fixed_point") == 0)
+        {
+            fixed_point = true;
+        }
+        else if (std::strcmp(argv[i], "--jps") == 0)
+        {
+            jps = true;
+        }
+        else if (std::strcmp(argv[i], "--bidirectional") == 0)
+        {
+            bidirectional = true;
+        }
+        else if (std::strcmp(argv[i], "--hpa") == 0)
+        {
+            hpa = true;
+        }
+        else
+        {
+            arguments.push_back(argv[i]);
+        }
+    }
+
+    if (arguments.empty() || arguments.size() > 2 || (fixed_point && jps) || (jps + bidirectional + hpa > 1))
+    {
+        std::cout << "Usage: " << argv[0] << " [--fixed_point] [--jps | --bidirectional | --hpa] <scenario file>"
+                  << " [<map directory>]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream scenario_file(arguments[0]);
+    if (not scenario_file)
+    {
+        std::cerr << "ERROR: Could not open " << arguments[0] << std::endl;
+        return 1;
+    }
+
+    Moving_ai_scenario scenario;
+    if (not scenario.read(scenario_file))
+    {
+        return 1;
+    }
+
+    const std::string map_directory = arguments.size() == 2 ? arguments[1] + "/" : get_directory(arguments[0]);
+    Scenario_runner::Maps maps;
+    for (const std::string& map_name : scenario.get_map_names())
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = load_map(map_directory, map_name);
+        if (not availability_grid)
+        {
+            return 1;
+        }
+        availability_grid->set_legal_move_cache_enabled(true);
+        maps[map_name] = availability_grid;
+    }
+
+    // The planner is created with the size of the first map and gets the map of every query from the runner
+    std::unique_ptr<A_star_planner> path_planner;
+    const size_t width = scenario.get_queries().empty() ? 1 : scenario.get_queries().front().map_width;
+    const size_t height = scenario.get_queries().empty() ? 1 : scenario.get_queries().front().map_height;
+    if (jps)
+    {
+        path_planner.reset(new JPS_planner(width, height));
+    }
+    else if (bidirectional)
+    {
+        path_planner.reset(new Bidirectional_A_star_planner(width, height));
+    }
+    else if (hpa)
+    {
+        path_planner.reset(new HPA_star_planner(width, height));
+    }
+    else
+    {
+        path_planner.reset(new A_star_planner(width, height));
+    }
+    if (fixed_point)
+    {
+        path_planner->set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+    }
+
+    Scenario_runner scenario_runner(*path_planner);
+    std::vector<Scenario_runner::Query_result> results;
+    if (not scenario_runner.run(scenario.get_queries(), maps, results))
+    {
+        return 1;
+    }
+
+    std::vector<Scenario_runner::Bucket_statistics> statistics;
+    Scenario_runner::get_bucket_statistics(scenario.get_queries(), results, statistics);
+
+    std::cout << std::setprecision(4) << std::fixed;
+    Scenario_runner::write_bucket_statistics(std::cout, statistics);
+
+    // The memory of the grids of the last map, the points to visit are not counted
+    std::cout << "Memory per point: " << path_planner->get_bytes_per_point() << " bytes ("
+              << path_planner->get_number_of_bytes() << " bytes for " << path_planner->get_width() << " x "
+              << path_planner->get_height() << " points)" << std::endl;
+
+    return 0;
+}
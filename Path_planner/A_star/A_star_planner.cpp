@@ -7,23 +7,116 @@
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include <A_star_planner.h>
+#include <A_star_planner_factory.h>
+#include <Connectivity.h>
+#include <Cost_model.h>
 #include <Cost_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Bucket_queue.h>
+#include <Indexed_d_ary_heap.h>
+#include <Legal_move_table.h>
+#include <Neighbor_mask_source.h>
 #include <Flat_point_2D.h>
+#include <Grid_width.h>
 
 // Standard library headers
 #include <vector>
-#include <queue>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cmath>
 #include <limits>
 #include <iostream>
 
+namespace
+{
+    // Add a point to the points to visit or lower its cost if it is already there. The heap supports decrease key
+    // while the bucket queue gets the point pushed again. The heap finds the point in its position map with the width
+    // policy of the search.
+    template<typename Width_policy>
+    void update_points_to_visit(Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit,
+                                const size_t flat_index,
+                                const float total_cost,
+                                const bool is_in_points_to_visit,
+                                const Width_policy& grid_width)
+    {
+        const Cost_point_2D cost_point(flat_index, total_cost);
+        if (is_in_points_to_visit)
+        {
+            points_to_visit.decrease_cost(cost_point, grid_width);
+        }
+        else
+        {
+            points_to_visit.push(cost_point, grid_width);
+        }
+    }
+
+    template<typename Width_policy>
+    void update_points_to_visit(Bucket_queue& points_to_visit,
+                                const size_t flat_index,
+                                const uint32_t total_cost,
+                                const bool,
+                                const Width_policy&)
+    {
+        points_to_visit.push(flat_index, total_cost);
+    }
+
+    // Get the flat index of the point with the lowest total cost
+    size_t get_cheapest_point_to_visit(const Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit)
+    {
+        return points_to_visit.top().get_flat_index();
+    }
+
+    size_t get_cheapest_point_to_visit(const Bucket_queue& points_to_visit)
+    {
+        return points_to_visit.top();
+    }
+
+    // Remove the point with the lowest total cost
+    template<typename Width_policy>
+    void pop_cheapest_point_to_visit(Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit,
+                                     const Width_policy& grid_width)
+    {
+        points_to_visit.pop(grid_width);
+    }
+
+    template<typename Width_policy>
+    void pop_cheapest_point_to_visit(Bucket_queue& points_to_visit, const Width_policy&)
+    {
+        points_to_visit.pop();
+    }
+
+    // Get the number of bytes of one entry in the points to visit
+    size_t get_bytes_per_entry(const Indexed_d_ary_heap<Search_state_grid, 4>&)
+    {
+        return sizeof(Cost_point_2D);
+    }
+
+    size_t get_bytes_per_entry(const Bucket_queue&)
+    {
+        return sizeof(uint32_t);
+    }
+
+    // Get the x and y distance between two points
+    size_t get_distance(const size_t a, const size_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+}
+
 A_star_planner::A_star_planner(std::shared_ptr<Availability_grid> availability_grid) :
                                                   availability_grid(availability_grid),
                                                   width(availability_grid->get_width()),
                                                   height(availability_grid->get_height()),
-                                                  path_cost_grid(width, height, std::numeric_limits<float>::infinity()),
-                                                  path_grid(width, height, 0)
+                                                  search_state_grid(width, height),
+                                                  points_to_visit(search_state_grid),
+                                                  cost_mode(Cost_mode::floating_point),
+                                                  // The total cost of a neighbor is at most two diagonal moves
+                                                  // above the cost of the current point, see Bucket_queue
+                                                  fixed_point_points_to_visit(
+                                                      2 * Fixed_point_octile_cost_model::get_diagonal_cost()),
+                                                  search_statistics_enabled(false),
+                                                  expansion_trace_enabled(false)
 {
 }
 
@@ -38,121 +131,335 @@ A_star_planner::~A_star_planner()
 
 bool A_star_planner::get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path)
 {
-    if (not availability_grid)
+    return plan_path<Runtime_width, Eight_connected>(start, end, path);
+}
+
+template<typename Width_policy, typename Connectivity>
+bool A_star_planner::plan_path(const Coord_point_2D& start,
+                               const Coord_point_2D& end,
+                               std::vector<Coord_point_2D>& path)
+{
+    const bool collect_statistics = is_collecting_search_statistics();
+    const bool instrumented = collect_statistics || is_recording_expansion_trace();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect_statistics);
+
+    if (not check_end_points(start, end))
     {
-        throw "A_star_planner::get_path: Availability grid not set";
+        return false;
     }
 
-    if (availability_grid->get_width() != width || availability_grid->get_height() != height)
+    // Clear the points to visit and their counters
+    points_to_visit.clear();
+    fixed_point_points_to_visit.clear();
+
+    if (start == end)
     {
-        // Availability grid has been altered outside of this class. Grid need to be resized
-        set_grid_size(availability_grid->get_width(), availability_grid->get_height());
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
     }
 
-    if (start.get_x() >= width || start.get_y() >= height)
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_reachable(start, end))
     {
-        std::cout << "WARNING: A_star_planner: Start point out of bounds" << std::endl;
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
         return false;
     }
 
-    if (end.get_x() >= width || end.get_y() >= height)
+    // Start a new query, this will mark all points as unvisited with an infinite path cost without touching the grid
+    search_state_grid.start_new_query();
+
+    if (collect_statistics)
     {
-        std::cout << "WARNING: A_star_planner: End point out of bounds" << std::endl;
-        return false;
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
     }
 
-    if (start == end)
+    // The mask source is picked once here so the search loop does not check for the legal move cache per expansion
+    const Width_policy grid_width(width);
+    const bool path_found = availability_grid->is_legal_move_cache_enabled()
+        ? search_with_cost_mode<Width_policy, Connectivity, Cached_neighbor_mask>(start, end, grid_width,
+                                                                                  instrumented, path)
+        : search_with_cost_mode<Width_policy, Connectivity, Bitboard_neighbor_mask>(start, end, grid_width,
+                                                                                    instrumented, path);
+
+    if (not path_found)
     {
-        // Already at end point from the beginning
-        path.push_back(start);
+        print_failure(start, end);
+    }
 
-        return true;
+    return path_found;
+}
+
+template<typename Width_policy, typename Connectivity, typename Mask_source>
+bool A_star_planner::search_with_cost_mode(const Coord_point_2D& start,
+                                           const Coord_point_2D& end,
+                                           const Width_policy& grid_width,
+                                           const bool instrumented,
+                                           std::vector<Coord_point_2D>& path)
+{
+    switch (cost_mode)
+    {
+        case Cost_mode::floating_point:
+            return instrumented
+                 ? search<Floating_point_cost_model, true, Width_policy, Connectivity, Mask_source>(
+                                                                  start, end, grid_width, points_to_visit, path)
+                 : search<Floating_point_cost_model, false, Width_policy, Connectivity, Mask_source>(
+                                                                  start, end, grid_width, points_to_visit, path);
+        case Cost_mode::fixed_point_octile:
+            return instrumented
+                 ? search<Fixed_point_octile_cost_model, true, Width_policy, Connectivity, Mask_source>(
+                                                      start, end, grid_width, fixed_point_points_to_visit, path)
+                 : search<Fixed_point_octile_cost_model, false, Width_policy, Connectivity, Mask_source>(
+                                                      start, end, grid_width, fixed_point_points_to_visit, path);
     }
+    return false;
+}
 
-    // Fill cost grid with infinite numbers, except for start point which should have zero cost.
-    // Path grid does not need to be reset since it will not be used until a path is found and it has been rebuild
-    path_cost_grid.fill(std::numeric_limits<float>::infinity());
-    path_cost_grid.set(start, 0);
+template<typename Cost_model, bool Instrumented, typename Width_policy, typename Connectivity, typename Mask_source,
+         typename Points_to_visit_type>
+bool A_star_planner::search(const Coord_point_2D& start,
+                            const Coord_point_2D& end,
+                            const Width_policy& grid_width,
+                            Points_to_visit_type& points_to_visit,
+                            std::vector<Coord_point_2D>& path)
+{
+    typedef typename Cost_model::Cost Cost;
 
-    // Clear the output path vector
-    path.clear();
+    // The counters and the trace are removed at compile time unless they are both requested and compiled in
+    const bool collect = Instrumented && search_statistics_compiled_in && search_statistics_enabled;
+    const bool trace = Instrumented && search_statistics_compiled_in && expansion_trace_enabled;
+    const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect);
+
+    const size_t start_index = grid_width.get_flat_index(start.get_x(), start.get_y());
+    const size_t end_index = grid_width.get_flat_index(end.get_x(), end.get_y());
+    const size_t end_x = end.get_x();
+    const size_t end_y = end.get_y();
+
+    // The start point has zero cost
+    search_state_grid.set(start_index, Cost(0), start_index, grid_width);
+
+    // Set start point total cost and add it to the points to visit
+    const Cost cheapest_cost_to_end_point = Connectivity::template get_cheapest_cost_to_target<Cost_model>(
+                                                                                 get_distance(start.get_x(), end_x),
+                                                                                 get_distance(start.get_y(), end_y));
+    update_points_to_visit(points_to_visit, start_index, cheapest_cost_to_end_point, false, grid_width);
 
-    // Set start point total cost and add it to the points to visit queue
-    const float cheapest_cost_to_end_point = calculate_cheapest_cost_to_target(start, end);
-    const Cost_point_2D start_point(start, width, cheapest_cost_to_end_point);
-    std::priority_queue<Cost_point_2D> points_to_visit;
-    points_to_visit.push(start_point);
+    if (collect)
+    {
+        search_statistics.number_of_visited_points = 1;
+        search_statistics.peak_points_to_visit = 1;
+    }
 
     // Initialize the neighbors array
     Neighbors neighbors;
 
+    bool path_found = false;
     while (points_to_visit.empty() == false)
     {
         // Pop the point which have the lowest total cost
-        const Flat_point_2D current_point = points_to_visit.top();
-        points_to_visit.pop();
+        const size_t current_index = get_cheapest_point_to_visit(points_to_visit);
+        pop_cheapest_point_to_visit(points_to_visit, grid_width);
 
-        if (Coord_point_2D(current_point, width) == end)
+        if (should_stop(points_to_visit.get_number_of_pops()))
         {
-            // End point reached, reconstruct the path
-            return reconstruct_path(start, current_point, path);
+            // Cancelled or out of time
+            break;
         }
 
-        // Path cost is the cost from start point to current point. It is often denoted by g. In this implementation
-        // the cost is set to the distance traveled in number of points. A diagonal move is counted as a distance of
-        // sqrt(1^2+1^2)~=1.4142136 points.
-        float path_cost_current_cell = path_cost_grid.get(current_point);
+        if (search_state_grid.is_closed(current_index, grid_width))
+        {
+            // An old entry of a point that has been pushed again with a lower cost, see Bucket_queue
+            if (collect)
+            {
+                search_statistics.number_of_stale_pops++;
+            }
+            continue;
+        }
+
+        // The path cost of the current point can not be lowered any more so it is closed
+        search_state_grid.set_closed(current_index, grid_width);
 
-        // Get the neighbors of the current cell
-        const size_t number_of_neighbors = get_neighbors(current_point, neighbors);
-        for (size_t neighbor_index = 0; neighbor_index < number_of_neighbors; neighbor_index++)
+        if (collect)
         {
-            const Flat_point_2D& neighbor_point = neighbors.at(neighbor_index).first;
-            const bool is_diagonal = neighbors.at(neighbor_index).second;
+            search_statistics.number_of_expanded_points++;
+        }
 
-            float path_cost = path_cost_current_cell;
-            if (is_diagonal)
+        if (trace)
+        {
+            // The path cost in units of a horizontal or vertical move
+            const float path_cost = static_cast<float>(search_state_grid.get_path_cost<Cost>(current_index)) /
+                                    static_cast<float>(Cost_model::get_straight_cost());
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index), path_cost};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        if (current_index == end_index)
+        {
+            // End point reached, reconstruct the path
+            const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect);
+            path_found = reconstruct_path(start, Flat_point_2D(current_index), path);
+            if (collect)
             {
-                // A diagonal move cost is set to sqrt(1^2 + 1^2) ~= 1.4142136 points
-                path_cost += 1.4142136;
+                search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
             }
-            else
+            break;
+        }
+
+        // Path cost is the cost from start point to current point. It is often denoted by g. In this implementation
+        // the cost is set to the distance traveled, see Cost_model.h for the cost of a move.
+        const Cost path_cost_current_point = search_state_grid.get_path_cost<Cost>(current_index, grid_width);
+
+        // Get the neighbors of the current point
+        const size_t number_of_neighbors = get_neighbors<Width_policy, Connectivity, Mask_source>(
+                                                                                         Flat_point_2D(current_index),
+                                                                                         grid_width,
+                                                                                         neighbors);
+        for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+        {
+            const size_t neighbor_index = neighbors.at(neighbor_number).first.get_flat_index();
+            const bool is_diagonal = neighbors.at(neighbor_number).second;
+
+            if (search_state_grid.is_closed(neighbor_index, grid_width))
             {
-                // A horizontal or vertical move is set to one
-                path_cost += 1;
+                // The cheapest path to a closed point has already been found
+                continue;
             }
 
-            if (path_cost < path_cost_grid.get(neighbor_point))
+            // A diagonal move has a different cost than a horizontal or vertical move
+            const Cost path_cost = path_cost_current_point + (is_diagonal ? Cost_model::get_diagonal_cost()
+                                                                          : Cost_model::get_straight_cost());
+
+            if (path_cost < search_state_grid.get_path_cost<Cost>(neighbor_index, grid_width))
             {
-                // If path cost is less than the current path cost for that point, update the path cost grid and path
-                // grid add this point to point_to_visit queue.
+                // If path cost is less than the current path cost for that point, update the path cost and previous
+                // point and add the point to the points to visit, or lower its cost if it is already there.
+                const bool is_in_points_to_visit = search_state_grid.is_visited(neighbor_index, grid_width);
 
                 // Estimate the cheapest cost to end point
-                const float cheapest_cost_to_end_point = calculate_cheapest_cost_to_target(
-                                                                                          Coord_point_2D(neighbor_point,
-                                                                                                         width),
-                                                                                                         end);
+                const Cost cheapest_cost_to_end_point = Connectivity::template get_cheapest_cost_to_target<Cost_model>(
+                                                               get_distance(grid_width.get_x(neighbor_index), end_x),
+                                                               get_distance(grid_width.get_y(neighbor_index), end_y));
 
                 // The total cost is the cheapest possible cost from start point to neighbor point plus the estimated
                 // cheapest cost to end point. A* function f = g + h.
-                const float total_cost = path_cost + cheapest_cost_to_end_point;
+                const Cost total_cost = path_cost + cheapest_cost_to_end_point;
 
-                // Add point to points_to_visit queue
-                const Cost_point_2D neighbor_cost_point(neighbor_point, total_cost);
-                points_to_visit.push(neighbor_cost_point);
+                // Update the search state with the path cost and set the previous point to current point
+                search_state_grid.set(neighbor_index, path_cost, current_index, grid_width);
 
-                // Update path cost grid with path cost
-                path_cost_grid.set(neighbor_point, path_cost);
+                update_points_to_visit(points_to_visit, neighbor_index, total_cost, is_in_points_to_visit, grid_width);
 
-                // Set path grid point to current point
-                path_grid.set(neighbor_point, current_point.get_flat_index());
+                if (collect)
+                {
+                    search_statistics.number_of_generated_points++;
+                    search_statistics.number_of_visited_points += is_in_points_to_visit ? 0 : 1;
+                    search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                                      points_to_visit.size());
+                }
             }
         }
     }
 
-    std::cout << "Failed to plan path from: " << start << " to " << end << std::endl;
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = points_to_visit.get_number_of_pushes();
+        search_statistics.number_of_heap_pops = points_to_visit.get_number_of_pops();
+        search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time) -
+                                           search_statistics.reconstruct_time_ms;
+        search_statistics.scratch_bytes_touched =
+                               search_statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point() +
+                               search_statistics.peak_points_to_visit * get_bytes_per_entry(points_to_visit);
+    }
 
-    return false;
+    return path_found;
+}
+
+void A_star_planner::set_search_statistics_enabled(const bool enabled)
+{
+    if (enabled && not search_statistics_compiled_in)
+    {
+        std::cerr << "WARNING: A_star_planner: Search statistics are not compiled in, see LINE_ROUTER_SEARCH_STATISTICS"
+                  << std::endl;
+    }
+
+    search_statistics_enabled = enabled;
+}
+
+bool A_star_planner::is_search_statistics_enabled() const
+{
+    return search_statistics_enabled;
+}
+
+const Search_statistics& A_star_planner::get_search_statistics() const
+{
+    return search_statistics;
+}
+
+void A_star_planner::set_expansion_trace_enabled(const bool enabled)
+{
+    if (enabled && not search_statistics_compiled_in)
+    {
+        std::cerr << "WARNING: A_star_planner: Expansion trace is not compiled in, see LINE_ROUTER_SEARCH_STATISTICS"
+                  << std::endl;
+    }
+
+    expansion_trace_enabled = enabled;
+    if (not enabled)
+    {
+        // Release the memory of the trace
+        Expansion_trace().swap(expansion_trace);
+    }
+}
+
+bool A_star_planner::is_expansion_trace_enabled() const
+{
+    return expansion_trace_enabled;
+}
+
+const Expansion_trace& A_star_planner::get_expansion_trace() const
+{
+    return expansion_trace;
+}
+
+A_star_planner::Cost_mode A_star_planner::get_cost_mode() const
+{
+    return cost_mode;
+}
+
+void A_star_planner::set_cost_mode(const Cost_mode cost_mode)
+{
+    this->cost_mode = cost_mode;
+}
+
+size_t A_star_planner::get_number_of_heap_pushes() const
+{
+    return points_to_visit.get_number_of_pushes() + fixed_point_points_to_visit.get_number_of_pushes();
+}
+
+size_t A_star_planner::get_number_of_heap_pops() const
+{
+    return points_to_visit.get_number_of_pops() + fixed_point_points_to_visit.get_number_of_pops();
+}
+
+size_t A_star_planner::get_number_of_bytes() const
+{
+    return availability_grid->get_number_of_bytes() + search_state_grid.get_number_of_bytes();
+}
+
+double A_star_planner::get_bytes_per_point() const
+{
+    if (width * height == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(get_number_of_bytes()) / static_cast<double>(width * height);
 }
 
 size_t A_star_planner::get_width() const
@@ -167,19 +474,20 @@ size_t A_star_planner::get_height() const
 
 void A_star_planner::set_grid_size(const size_t width, const size_t height)
 {
-    if (not availability_grid || (availability_grid->get_width() != width || availability_grid->get_height()))
+    if (not availability_grid)
     {
-        availability_grid->resize(width, height, true);
+        throw "A_star_planner::set_grid_size: Availability grid not set";
     }
 
-    if (path_cost_grid.get_width() != width || path_cost_grid.get_height() != height)
+    // Resizing the availability grid rebuilds its caches and counts as a change, so only resize it if the size differs
+    if (availability_grid->get_width() != width || availability_grid->get_height() != height)
     {
-        path_cost_grid.resize(width, height, std::numeric_limits<float>::infinity());
+        availability_grid->resize(width, height, true);
     }
 
-    if (path_grid.get_width() != width || path_grid.get_height() != height)
+    if (search_state_grid.get_width() != width || search_state_grid.get_height() != height)
     {
-        path_grid.resize(width, height, 0);
+        search_state_grid.resize(width, height);
     }
 
     this->width = width;
@@ -246,11 +554,68 @@ void A_star_planner::set_blocked(const Coord_point_2D& point)
     }
 }
 
+Coord_rectangle_2D A_star_planner::commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius)
+{
+    if (availability_grid)
+    {
+        return availability_grid->block_path(path, halo_radius);
+    }
+    else
+    {
+        throw "A_star_planner::commit_path: Availability grid not set when trying to commit path";
+    }
+}
+
+void A_star_planner::set_cancellation_token(const std::shared_ptr<const Cancellation_token> cancellation_token)
+{
+    this->cancellation_token = cancellation_token;
+}
+
+void A_star_planner::print_failure(const Coord_point_2D& start, const Coord_point_2D& end) const
+{
+    if (cancellation_token && cancellation_token->is_cancelled())
+    {
+        std::cerr << "Path planning cancelled from: " << start << " to " << end << std::endl;
+    }
+    else
+    {
+        std::cerr << "Failed to plan path from: " << start << " to " << end << std::endl;
+    }
+}
+
+bool A_star_planner::check_end_points(const Coord_point_2D& start, const Coord_point_2D& end)
+{
+    if (not availability_grid)
+    {
+        throw "A_star_planner::get_path: Availability grid not set";
+    }
+
+    if (availability_grid->get_width() != width || availability_grid->get_height() != height)
+    {
+        // Availability grid has been altered outside of this class. Grid need to be resized
+        set_grid_size(availability_grid->get_width(), availability_grid->get_height());
+    }
+
+    if (start.get_x() >= width || start.get_y() >= height)
+    {
+        std::cerr << "WARNING: A_star_planner: Start point out of bounds" << std::endl;
+        return false;
+    }
+
+    if (end.get_x() >= width || end.get_y() >= height)
+    {
+        std::cerr << "WARNING: A_star_planner: End point out of bounds" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool A_star_planner::reconstruct_path(const Coord_point_2D& start,
                                       const Flat_point_2D& end,
                                       std::vector<Coord_point_2D>& path_vector) const
 {
-    // This function will do a reverse search from end point to start point from the path grid
+    // This function will do a reverse search from end point to start point from the previous points
 
     // Clear the path vector
     path_vector.clear();
@@ -259,7 +624,7 @@ bool A_star_planner::reconstruct_path(const Coord_point_2D& start,
     path_vector.push_back(Coord_point_2D(end, width));
 
     // Get the next index to travel to
-    size_t next_index = path_grid.get(end);
+    size_t next_index = search_state_grid.get_previous(end.get_flat_index());
 
     // Continue to get the next index until we have reached the start cell. It shouldn't take more than width x height
     // iterations until the start point have been reached
@@ -269,13 +634,13 @@ bool A_star_planner::reconstruct_path(const Coord_point_2D& start,
     {
         number_of_iterations++;
         Coord_point_2D next_point(Flat_point_2D(next_index), width);
-        next_index = path_grid.get(next_index);
+        next_index = search_state_grid.get_previous(next_index);
         path_vector.push_back(next_point);
     }
 
     if (number_of_iterations >= max_iterations)
     {
-        std::cout << "ERROR: Maximum iterations to reconstruct the path from start to end reached" << std::endl;
+        std::cerr << "ERROR: Maximum iterations to reconstruct the path from start to end reached" << std::endl;
         return false;
     }
 
@@ -283,7 +648,7 @@ bool A_star_planner::reconstruct_path(const Coord_point_2D& start,
     Coord_point_2D last_point(Flat_point_2D(next_index), width);
     if (last_point != start)
     {
-        std::cout << "ERROR: Last point in reconstructed path is not the start point" << std::endl;
+        std::cerr << "ERROR: Last point in reconstructed path is not the start point" << std::endl;
         return false;
     }
 
@@ -298,135 +663,45 @@ bool A_star_planner::reconstruct_path(const Coord_point_2D& start,
 
 size_t A_star_planner::get_neighbors(const Flat_point_2D& point, Neighbors& neighbors) const
 {
-    size_t number_of_neighbors = 0;
-
-    // Get x and y coordinates
-    const size_t x = point.get_x(width);
-    const size_t y = point.get_y(width);
-
-    // Check if horizontal and vertical coordinates are within limits
-    const bool left_within_limits  = x > 0;
-    const bool right_within_limits = x < width - 1;
-    const bool up_within_limits    = y > 0;
-    const bool down_within_limits  = y < height - 1;
-
-    bool left_available = false;
-    bool up_available = false;
-    bool right_available = false;
-    bool down_available = false;
+    const Runtime_width grid_width(width);
+    return availability_grid->is_legal_move_cache_enabled()
+         ? get_neighbors<Runtime_width, Eight_connected, Cached_neighbor_mask>(point, grid_width, neighbors)
+         : get_neighbors<Runtime_width, Eight_connected, Bitboard_neighbor_mask>(point, grid_width, neighbors);
+}
 
+template<typename Width_policy, typename Connectivity, typename Mask_source>
+size_t A_star_planner::get_neighbors(const Flat_point_2D& point,
+                                     const Width_policy& grid_width,
+                                     Neighbors& neighbors) const
+{
     // This is the flat index of the point and will be in the center of its neighbors
     const size_t center_index = point.get_flat_index();
 
-    // Code below checks if neighbor is available and if so adds it to the neighbors array
-
-    // Left neighbor
-    Flat_point_2D left;
-    if (left_within_limits)
-    {
-        left_available = availability_grid->is_available(center_index-1);
-        if (left_available)
-        {
-            left = Flat_point_2D(center_index-1);
-            neighbors.at(number_of_neighbors).first = left;
-            neighbors.at(number_of_neighbors).second = false;
-            number_of_neighbors++;
-        }
-    }
-
-    // Up neighbor
-    Flat_point_2D up;
-    if (up_within_limits)
-    {
-        up_available = availability_grid->is_available(center_index-width);
-        if (up_available)
-        {
-            up = Flat_point_2D(center_index-width);
-            neighbors.at(number_of_neighbors).first = up;
-            neighbors.at(number_of_neighbors).second = false;
-            number_of_neighbors++;
-        }
-    }
-
-    // Right neighbor
-    Flat_point_2D right;
-    if (right_within_limits)
-    {
-        right_available = availability_grid->is_available(center_index+1);
-        if (right_available)
-        {
-            right = Flat_point_2D(center_index+1);
-            neighbors.at(number_of_neighbors).first = right;
-            neighbors.at(number_of_neighbors).second = false;
-            number_of_neighbors++;
-        }
-    }
-
-    // Down neighbor
-    Flat_point_2D down;
-    if (down_within_limits)
-    {
-        down_available = availability_grid->is_available(center_index+width);
-        if (down_available)
-        {
-            down = Flat_point_2D(center_index+width);
-            neighbors.at(number_of_neighbors).first = down;
-            neighbors.at(number_of_neighbors).second = false;
-            number_of_neighbors++;
-        }
-    }
-
-    // Diagonal neighbors
-
-    // Upper left neighbor
-    if (up_within_limits && left_within_limits)
-    {
-        if (availability_grid->is_available(center_index-width-1) && (up_available || left_available))
-        {
-            const Flat_point_2D upper_left(center_index-width-1);
-            neighbors.at(number_of_neighbors).first = upper_left;
-            neighbors.at(number_of_neighbors).second = true;
-            number_of_neighbors++;
-        }
-    }
-
-    // Upper right neighbor
-    if (up_within_limits && right_within_limits)
+    // The neighbor mask is read from the legal move cache or the bitboard, see Neighbor_mask_source.h. The legal moves
+    // of the connectivity for the mask are then looked up in a table.
+    const uint8_t mask = Mask_source::get_neighbor_mask(*availability_grid, center_index, grid_width);
+    const Legal_move_table::Legal_moves& legal_moves = Connectivity::get_legal_moves(mask);
+
+    // The flat index offset of each direction, in the order of Bit_grid_2D::Neighbor_bit. The unsigned wrap around
+    // gives the right index when the offset is added to the center index. The offsets are constants for a fixed width.
+    const size_t row_offset = grid_width.get_width();
+    const std::array<size_t, 8> offsets = {{size_t(0)-1,
+                                            size_t(0)-row_offset,
+                                            1,
+                                            row_offset,
+                                            size_t(0)-row_offset-1,
+                                            size_t(0)-row_offset+1,
+                                            row_offset+1,
+                                            row_offset-1}};
+
+    for (size_t move = 0; move < legal_moves.number_of_moves; move++)
     {
-        if (availability_grid->is_available(center_index-width+1) && (up_available || right_available))
-        {
-            const Flat_point_2D upper_right(center_index-width+1);
-            neighbors.at(number_of_neighbors).first = upper_right;
-            neighbors.at(number_of_neighbors).second = true;
-            number_of_neighbors++;
-        }
+        const uint8_t direction = legal_moves.directions[move];
+        neighbors[move].first = Flat_point_2D(center_index + offsets[direction]);
+        neighbors[move].second = Legal_move_table::is_diagonal(direction);
     }
 
-    // Down right neighbor
-    if (down_within_limits && right_within_limits)
-    {
-        if (availability_grid->is_available(center_index+width+1) && (down_available || right_available))
-        {
-            const Flat_point_2D lower_right(center_index+width+1);
-            neighbors.at(number_of_neighbors).first = lower_right;
-            neighbors.at(number_of_neighbors).second = true;
-            number_of_neighbors++;
-        }
-    }
-
-    // Down left neighbor
-    if (down_within_limits && left_within_limits)
-    {
-        if (availability_grid->is_available(center_index+width-1) && (down_available || left_available))
-        {
-            const Flat_point_2D lower_left(center_index+width-1);
-            neighbors.at(number_of_neighbors).first = lower_left;
-            neighbors.at(number_of_neighbors).second = true;
-            number_of_neighbors++;
-        }
-    }
-
-    return number_of_neighbors;
+    return legal_moves.number_of_moves;
 }
 
 float A_star_planner::calculate_cheapest_cost_to_target(const Coord_point_2D& point, const Coord_point_2D& target) const
@@ -442,3 +717,34 @@ float A_star_planner::calculate_cheapest_cost_to_target(const Coord_point_2D& po
 
     return std::sqrt(dx*dx + dy*dy);
 }
+
+// The policies of the specializations created by A_star_planner_factory, see A_star_planner_specialization. The
+// search is only defined in this file so plan_path is instantiated here for every pair of policies.
+typedef Fixed_width<A_star_planner_factory::fixed_board_width> Board_width;
+template bool A_star_planner::plan_path<Board_width, Four_connected>(const Coord_point_2D&,
+                                                                     const Coord_point_2D&,
+                                                                     std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Board_width, Eight_connected>(const Coord_point_2D&,
+                                                                      const Coord_point_2D&,
+                                                                      std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Board_width, Eight_connected_strict>(const Coord_point_2D&,
+                                                                             const Coord_point_2D&,
+                                                                             std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Power_of_two_width, Four_connected>(const Coord_point_2D&,
+                                                                            const Coord_point_2D&,
+                                                                            std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Power_of_two_width, Eight_connected>(const Coord_point_2D&,
+                                                                             const Coord_point_2D&,
+                                                                             std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Power_of_two_width, Eight_connected_strict>(const Coord_point_2D&,
+                                                                                    const Coord_point_2D&,
+                                                                                    std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Runtime_width, Four_connected>(const Coord_point_2D&,
+                                                                       const Coord_point_2D&,
+                                                                       std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Runtime_width, Eight_connected>(const Coord_point_2D&,
+                                                                        const Coord_point_2D&,
+                                                                        std::vector<Coord_point_2D>&);
+template bool A_star_planner::plan_path<Runtime_width, Eight_connected_strict>(const Coord_point_2D&,
+                                                                               const Coord_point_2D&,
+                                                                               std::vector<Coord_point_2D>&);
@@ -10,23 +10,51 @@
 #define LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_H_
 
 #include <Availability_grid.h>
+#include <Cancellation_token.h>
+#include <Connectivity.h>
 #include <Path_planner.h>
 #include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
 #include <Flat_point_2D.h>
 #include <Flat_grid_2D.h>
+#include <Grid_width.h>
+#include <Search_state_grid.h>
+#include <Search_statistics.h>
+#include <Expansion_trace.h>
+#include <Indexed_d_ary_heap.h>
+#include <Bucket_queue.h>
 
 // Standard library headers
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 // This class tries to find the route from start to end based on the search algorithm A*. It is designed to find the
 // path from the start point to the given end point which has the smallest cost. In this implementation the cost is the
 // coordinate distance traveled. For more information about the algorithm, see README.md in Line router application.
 // The Availability grid is a bool grid used to set available/blocked grid points and also defines the width and height
 // of the grid.
-// This class is intended to be accessed by one thread since it is not thread safe.
+// This class is intended to be accessed by one thread since it is not thread safe. The availability grid is the board
+// and it is only read by get_path, everything a query writes is scratch kept in the planner. Planners that share an
+// availability grid can therefore plan paths on different threads while the grid is not changed, see
+// A_star_planner_pool.
 class A_star_planner : public Path_planner
 {
 public:
+    // The cost model used by the search, see Cost_model.h
+    // floating_point:     Horizontal and vertical moves cost 1 and diagonal moves 1.4142136. The cheapest cost to the
+    //                     end point is the line-of-sight distance. A points to visit heap is used.
+    // fixed_point_octile: Horizontal and vertical moves cost 5 and diagonal moves 7. The cheapest cost to the end point
+    //                     is the octile distance. A bucket queue with O(1) push and pop is used and the results are
+    //                     bit-reproducible.
+    enum class Cost_mode
+    {
+        floating_point,
+        fixed_point_octile
+    };
+
     // Create an A_star_planner with an already existing availability grid. The availability grid must have been
     // initialized before calling this. The grid size will be fetched from the availability grid.
     A_star_planner(std::shared_ptr<Availability_grid> availability_grid);
@@ -61,24 +89,128 @@ public:
     // Set point to blocked, i.e. a path cannot pass through this point
     void set_blocked(const size_t x, size_t y) override;
     void set_blocked(const Coord_point_2D& point) override;
-
-private:
+    // Block a path and its halo, see Path_planner::commit_path
+    Coord_rectangle_2D commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius) override;
+
+    // Set a token that is polled from the search loop, see Path_planner::set_cancellation_token
+    void set_cancellation_token(const std::shared_ptr<const Cancellation_token> cancellation_token) override;
+
+    // Enable collecting search statistics, see Path_planner::set_search_statistics_enabled
+    void set_search_statistics_enabled(const bool enabled) override;
+    bool is_search_statistics_enabled() const override;
+    // Get the statistics of the last call to get_path, see Search_statistics
+    const Search_statistics& get_search_statistics() const override;
+
+    // Enable recording the expanded points, see Path_planner::set_expansion_trace_enabled
+    void set_expansion_trace_enabled(const bool enabled) override;
+    bool is_expansion_trace_enabled() const override;
+    // Get the points expanded by the last call to get_path, see Expansion_trace
+    const Expansion_trace& get_expansion_trace() const override;
+
+    // Get and set the cost model used by get_path. The default is Cost_mode::floating_point.
+    Cost_mode get_cost_mode() const;
+    void set_cost_mode(const Cost_mode cost_mode);
+
+    // Number of points pushed to and popped from the points to visit heap in the last call to get_path
+    virtual size_t get_number_of_heap_pushes() const;
+    virtual size_t get_number_of_heap_pops() const;
+
+    // Number of bytes allocated for the grids of the planner, i.e. the availability grid and the per point search
+    // state. The points to visit are not counted since they grow with the number of visited points.
+    virtual size_t get_number_of_bytes() const;
+    // The number of bytes divided by the number of points of the grid
+    double get_bytes_per_point() const;
+
+protected:
+    // The board, it can be shared with other planners
     std::shared_ptr<Availability_grid> availability_grid;
 
+    // The scratch of the queries, i.e. everything below, is only used by this planner
     size_t width;
     size_t height;
 
-    // This grid is used to keep track of the cost from start point to the the point in the grid. Start point has
-    // a cost of zero.
-    Flat_grid_2D<float> path_cost_grid;
-
-    // This grid consists of flattened grid indexes that points to a previous neighbor point visited. It is
-    // updated by the currently visited point that sets all its available neighbors to the currently visited flattened
-    // grid index. When the end point has been reached this grid can be used to backtrack the path to the start point.
-    Flat_grid_2D<size_t> path_grid;
-
-    // Reconstruct the path from start point to end point by using the path_grid. This should only be called once the
-    // end point is set in the path_grid.
+    // This grid keeps track of the cost from start point to the point and the previous point of the path for every
+    // visited point. The previous point is updated by the currently visited point that sets all its available neighbors
+    // to the currently visited flattened grid index. When the end point has been reached the previous points can be
+    // used to backtrack the path to the start point. The points are stamped per query so the grid does not need to be
+    // reset before each search, see Search_state_grid.
+    Search_state_grid search_state_grid;
+
+    // The points to visit sorted by their total cost f = g + h. The heap index of every point is stored in the
+    // search_state_grid so that the cost of a point already in the heap can be lowered instead of pushing it again.
+    // The search passes its width policy to the heap, so the position map is accessed like the rest of the search
+    // state.
+    typedef Indexed_d_ary_heap<Search_state_grid, 4> Points_to_visit;
+    Points_to_visit points_to_visit;
+
+    // The cost model and the points to visit used for the fixed point costs
+    Cost_mode cost_mode;
+    Bucket_queue fixed_point_points_to_visit;
+
+    // The token is polled every cancellation_poll_interval popped points, so the clock is not read for every point
+    static const size_t cancellation_poll_interval = 256;
+    std::shared_ptr<const Cancellation_token> cancellation_token;
+
+    // The statistics and the expanded points of the last query. They are only collected if enabled at runtime and
+    // compiled in.
+    bool search_statistics_enabled;
+    Search_statistics search_statistics;
+    bool expansion_trace_enabled;
+    Expansion_trace expansion_trace;
+
+    bool is_collecting_search_statistics() const
+    {
+        return search_statistics_compiled_in && search_statistics_enabled;
+    }
+
+    bool is_recording_expansion_trace() const
+    {
+        return search_statistics_compiled_in && expansion_trace_enabled;
+    }
+
+    // Check if the search should stop. number_of_pops is the number of popped points so far in the query.
+    bool should_stop(const size_t number_of_pops) const
+    {
+        return number_of_pops % cancellation_poll_interval == 0 && cancellation_token &&
+               cancellation_token->is_cancelled();
+    }
+
+    // Print why no path was found
+    void print_failure(const Coord_point_2D& start, const Coord_point_2D& end) const;
+
+    // Get a path from start to end with a width policy and a connectivity policy, see Grid_width.h and Connectivity.h.
+    // get_path uses the Runtime_width and Eight_connected. The width of the grid must be supported by the width policy.
+    // Only the policies used by A_star_planner_specialization are instantiated, see A_star_planner.cpp.
+    template<typename Width_policy, typename Connectivity>
+    bool plan_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path);
+
+    // Run the search of the cost mode, with or without instrumentation, and with a neighbor mask source, see
+    // Neighbor_mask_source.h. plan_path picks the mask source once per query.
+    template<typename Width_policy, typename Connectivity, typename Mask_source>
+    bool search_with_cost_mode(const Coord_point_2D& start,
+                               const Coord_point_2D& end,
+                               const Width_policy& grid_width,
+                               const bool instrumented,
+                               std::vector<Coord_point_2D>& path);
+
+    // The A* search from start to end for a cost model. The points to visit is either a heap or a bucket queue. The
+    // search statistics and the expansion trace are only collected in the instantiation with Instrumented set, so the
+    // search without them has no extra cost.
+    template<typename Cost_model, bool Instrumented, typename Width_policy, typename Connectivity, typename Mask_source,
+             typename Points_to_visit_type>
+    bool search(const Coord_point_2D& start,
+                const Coord_point_2D& end,
+                const Width_policy& grid_width,
+                Points_to_visit_type& points_to_visit,
+                std::vector<Coord_point_2D>& path);
+
+    // Check that the availability grid is set and that start and end points are within the grid. The search grids are
+    // resized if the availability grid has been altered outside of this class. Returns false if the points are out of
+    // bounds.
+    bool check_end_points(const Coord_point_2D& start, const Coord_point_2D& end);
+
+    // Reconstruct the path from start point to end point by using the previous points in the search_state_grid. This
+    // should only be called once the end point is set in the search_state_grid.
     bool reconstruct_path(const Coord_point_2D& start,
                           const Flat_point_2D& end,
                           std::vector<Coord_point_2D>& path_vector) const;
@@ -97,6 +229,11 @@ private:
     typedef std::array<std::pair<Flat_point_2D, bool>, 8> Neighbors;
     size_t get_neighbors(const Flat_point_2D& point, Neighbors& neighbors) const;
 
+    // Get the available neighbors with a width policy, a connectivity policy and a neighbor mask source. get_neighbors
+    // uses the Runtime_width and Eight_connected and picks the mask source on every call.
+    template<typename Width_policy, typename Connectivity, typename Mask_source>
+    size_t get_neighbors(const Flat_point_2D& point, const Width_policy& grid_width, Neighbors& neighbors) const;
+
     // Cheapest cost to target point is the cheapest cost of the path from point to the target point. It is often
     // denoted by h. In this implementation the cost is set to the line-of-sight distance from point to the target point
     // by the equation sqrt(dx^2 + dy^2), where dx is the difference in x-coordinate and dy is the difference in
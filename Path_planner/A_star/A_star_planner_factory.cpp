@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <A_star_planner_factory.h>
+#include <A_star_planner.h>
+#include <A_star_planner_specialization.h>
+#include <Availability_grid.h>
+#include <Connectivity.h>
+#include <Grid_width.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+
+// The constants are passed by reference in comparisons so they need a definition
+const size_t A_star_planner_factory::fixed_board_width;
+
+namespace
+{
+    // Create the specialization for the width of the availability grid
+    template<typename Connectivity>
+    std::unique_ptr<A_star_planner> create_for_width(std::shared_ptr<Availability_grid> availability_grid)
+    {
+        typedef Fixed_width<A_star_planner_factory::fixed_board_width> Board_width;
+
+        const size_t width = availability_grid->get_width();
+        if (Board_width::is_supported(width))
+        {
+            return std::unique_ptr<A_star_planner>(
+                                     new A_star_planner_specialization<Board_width, Connectivity>(availability_grid));
+        }
+        if (Power_of_two_width::is_supported(width))
+        {
+            return std::unique_ptr<A_star_planner>(
+                              new A_star_planner_specialization<Power_of_two_width, Connectivity>(availability_grid));
+        }
+        return std::unique_ptr<A_star_planner>(
+                                   new A_star_planner_specialization<Runtime_width, Connectivity>(availability_grid));
+    }
+}
+
+std::unique_ptr<A_star_planner> A_star_planner_factory::create(std::shared_ptr<Availability_grid> availability_grid,
+                                                               const Connectivity_type connectivity_type)
+{
+    if (not availability_grid)
+    {
+        throw "A_star_planner_factory::create: Availability grid not set";
+    }
+
+    switch (connectivity_type)
+    {
+        case Connectivity_type::four_connected:
+            return create_for_width<Four_connected>(availability_grid);
+        case Connectivity_type::eight_connected:
+            return create_for_width<Eight_connected>(availability_grid);
+        case Connectivity_type::eight_connected_strict:
+            return create_for_width<Eight_connected_strict>(availability_grid);
+    }
+
+    throw "A_star_planner_factory::create: Unknown connectivity";
+}
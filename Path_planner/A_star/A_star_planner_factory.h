@@ -0,0 +1,41 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_FACTORY_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_FACTORY_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+
+// Creates an A_star_planner_specialization for the width of an availability grid and a connectivity picked at
+// runtime. The grids that are fixed_board_width points wide get a Fixed_width, other widths that are a power of two a
+// Power_of_two_width and all other widths the Runtime_width.
+class A_star_planner_factory
+{
+public:
+    // The connectivity policies, see Connectivity.h
+    enum class Connectivity_type
+    {
+        four_connected,
+        eight_connected,
+        eight_connected_strict
+    };
+
+    // The width of the boards that get a compile time width
+    static const size_t fixed_board_width = 600;
+
+    // Create a planner for the availability grid. Throws if the availability grid is not set.
+    static std::unique_ptr<A_star_planner> create(std::shared_ptr<Availability_grid> availability_grid,
+                                                  const Connectivity_type connectivity_type);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_FACTORY_H_
@@ -0,0 +1,150 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <A_star_planner_pool.h>
+#include <A_star_planner.h>
+#include <A_star_planner_factory.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+A_star_planner_pool::Lease::Lease(A_star_planner_pool& pool, A_star_planner& planner) : pool(&pool), planner(&planner)
+{
+}
+
+A_star_planner_pool::Lease::Lease(Lease&& other) : pool(other.pool), planner(other.planner)
+{
+    other.pool = nullptr;
+    other.planner = nullptr;
+}
+
+A_star_planner_pool::Lease::~Lease()
+{
+    if (pool)
+    {
+        pool->give_back(*planner);
+    }
+}
+
+bool A_star_planner_pool::Lease::get_path(const Coord_point_2D& start,
+                                          const Coord_point_2D& end,
+                                          std::vector<Coord_point_2D>& path)
+{
+    return planner->get_path(start, end, path);
+}
+
+A_star_planner& A_star_planner_pool::Lease::get_planner() const
+{
+    return *planner;
+}
+
+A_star_planner_pool::A_star_planner_pool(std::shared_ptr<Availability_grid> availability_grid,
+                                         const size_t number_of_planners,
+                                         const Connectivity_type connectivity_type) :
+                                                                                availability_grid(availability_grid),
+                                                                                changing_availability_grid(false)
+{
+    if (not availability_grid)
+    {
+        throw "A_star_planner_pool::A_star_planner_pool: Availability grid not set";
+    }
+
+    if (number_of_planners == 0)
+    {
+        throw "A_star_planner_pool::A_star_planner_pool: The pool needs at least one planner";
+    }
+
+    for (size_t planner_number = 0; planner_number < number_of_planners; planner_number++)
+    {
+        planners.push_back(A_star_planner_factory::create(availability_grid, connectivity_type));
+        free_planners.push_back(planners.back().get());
+    }
+
+    // The queries only read the grid from now on
+    availability_grid->update_component_index();
+}
+
+A_star_planner_pool::~A_star_planner_pool()
+{
+}
+
+size_t A_star_planner_pool::get_number_of_planners() const
+{
+    return planners.size();
+}
+
+std::shared_ptr<const Availability_grid> A_star_planner_pool::get_availability_grid() const
+{
+    return availability_grid;
+}
+
+A_star_planner_pool::Lease A_star_planner_pool::lease()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    pool_changed.wait(lock, [this]()
+    {
+        return not free_planners.empty() && not changing_availability_grid;
+    });
+
+    A_star_planner& planner = *free_planners.back();
+    free_planners.pop_back();
+    return Lease(*this, planner);
+}
+
+bool A_star_planner_pool::get_path(const Coord_point_2D& start,
+                                   const Coord_point_2D& end,
+                                   std::vector<Coord_point_2D>& path)
+{
+    return lease().get_path(start, end, path);
+}
+
+void A_star_planner_pool::change_availability_grid(const std::function<void(Availability_grid&)>& change)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Wait for other changes to finish, then stop new leases and wait for the leased planners to be given back
+    pool_changed.wait(lock, [this]()
+    {
+        return not changing_availability_grid;
+    });
+    changing_availability_grid = true;
+    pool_changed.wait(lock, [this]()
+    {
+        return free_planners.size() == planners.size();
+    });
+
+    // No planner is leased and none can be leased while the lock is held, so the grid is changed under the lock. The
+    // waiting threads are woken up now so that they get the lock after the change, also if the change throws.
+    changing_availability_grid = false;
+    pool_changed.notify_all();
+    change(*availability_grid);
+    availability_grid->update_component_index();
+
+    // Resize the scratch of the planners to the grid now, otherwise the next query of every planner would do it and
+    // the queries must not write to the shared grid
+    for (const std::unique_ptr<A_star_planner>& planner : planners)
+    {
+        planner->set_grid_size(availability_grid->get_width(), availability_grid->get_height());
+    }
+}
+
+void A_star_planner_pool::give_back(A_star_planner& planner)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_planners.push_back(&planner);
+    }
+    pool_changed.notify_all();
+}
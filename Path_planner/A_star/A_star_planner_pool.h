@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_POOL_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_POOL_H_
+
+#include <A_star_planner.h>
+#include <A_star_planner_factory.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A pool of A_star_planners that share one availability grid, so that several threads can plan paths at the same time.
+// The availability grid is the board and it is only read by the queries. Every planner of the pool is the scratch
+// context of one query at a time, i.e. the search state grid and the points to visit, see A_star_planner. The planner
+// is reused by the next query, so the board is stored once and a query does not allocate once the scratch has grown to
+// the size of its searches.
+// A thread leases a planner for one or more queries and the planner is given back when the Lease is destroyed. If all
+// planners are leased the thread waits until one is given back, so a pool with one planner per core keeps all cores
+// busy.
+// While the pool is used the board must only be changed through change_availability_grid. It waits until all planners
+// have been given back, and before the next query starts it brings the component index of the board up to date and
+// resizes the scratch of the planners if the board was resized. The queries then only read the board.
+// All functions of the pool are thread safe. A Lease must only be used by one thread at a time.
+class A_star_planner_pool
+{
+public:
+    // A planner leased from the pool. It is given back to the pool when the lease is destroyed.
+    class Lease
+    {
+    public:
+        Lease(Lease&& other);
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        // Get a path from start point to end point with the leased planner, see A_star_planner::get_path
+        bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path);
+
+        // Get the leased planner, e.g. to set the cost mode or a cancellation token or to read the search statistics of
+        // the last query. The availability grid must not be changed through the planner.
+        A_star_planner& get_planner() const;
+
+    private:
+        friend class A_star_planner_pool;
+
+        Lease(A_star_planner_pool& pool, A_star_planner& planner);
+
+        A_star_planner_pool* pool;
+        A_star_planner* planner;
+    };
+
+    // Create a pool with number_of_planners planners for the availability grid, e.g. one per hardware thread. The
+    // planners are created by A_star_planner_factory with the connectivity. Throws if the availability grid is not set
+    // or if there are no planners.
+    typedef A_star_planner_factory::Connectivity_type Connectivity_type;
+    A_star_planner_pool(std::shared_ptr<Availability_grid> availability_grid,
+                        const size_t number_of_planners,
+                        const Connectivity_type connectivity_type = Connectivity_type::eight_connected);
+    virtual ~A_star_planner_pool();
+
+    A_star_planner_pool(const A_star_planner_pool&) = delete;
+    A_star_planner_pool& operator=(const A_star_planner_pool&) = delete;
+
+    size_t get_number_of_planners() const;
+
+    // Get the shared availability grid. Use change_availability_grid to change it.
+    std::shared_ptr<const Availability_grid> get_availability_grid() const;
+
+    // Lease a planner. Waits until a planner is free and no change of the availability grid is waiting.
+    Lease lease();
+
+    // Get a path from start point to end point with a planner leased for this query only
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path);
+
+    // Change the availability grid, e.g. block a routed path or resize it. Waits until all planners have been given
+    // back and new leases wait until the change is done. Must not be called by a thread that holds a lease.
+    void change_availability_grid(const std::function<void(Availability_grid&)>& change);
+
+private:
+    std::shared_ptr<Availability_grid> availability_grid;
+    std::vector<std::unique_ptr<A_star_planner>> planners;
+
+    // The planners that are not leased and if a change of the availability grid is waiting or running, guarded by the
+    // mutex
+    std::mutex mutex;
+    std::condition_variable pool_changed;
+    std::vector<A_star_planner*> free_planners;
+    bool changing_availability_grid;
+
+    // Give a leased planner back to the pool
+    void give_back(A_star_planner& planner);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_POOL_H_
@@ -0,0 +1,58 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_SPECIALIZATION_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_SPECIALIZATION_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Connectivity.h>
+#include <Coord_point_2D.h>
+#include <Grid_width.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// An A_star_planner where the width policy and the connectivity policy are chosen at compile time, see Grid_width.h
+// and Connectivity.h. The search is the same as the one of the A_star_planner, but the conversions between flat indices
+// and coordinates and the legal move lookups are inlined for the policies, so there is no runtime branching on them in
+// the search loop. If the availability grid is changed to a width that the width policy does not support the runtime
+// width is used instead.
+// Only the specializations created by A_star_planner_factory are compiled, use the factory to pick one at runtime.
+template<typename Width_policy, typename Connectivity>
+class A_star_planner_specialization : public A_star_planner
+{
+public:
+    // See A_star_planner
+    A_star_planner_specialization(std::shared_ptr<Availability_grid> availability_grid) :
+                                                                                     A_star_planner(availability_grid)
+    {
+    }
+
+    A_star_planner_specialization(const size_t width, const size_t height) : A_star_planner(width, height)
+    {
+    }
+
+    virtual ~A_star_planner_specialization()
+    {
+    }
+
+    // Get a path from start point to end point with the policies
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override
+    {
+        if (availability_grid && not Width_policy::is_supported(availability_grid->get_width()))
+        {
+            return plan_path<Runtime_width, Connectivity>(start, end, path);
+        }
+        return plan_path<Width_policy, Connectivity>(start, end, path);
+    }
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_A_STAR_PLANNER_SPECIALIZATION_H_
@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Bucket_queue.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+Bucket_queue::Bucket_queue(const uint32_t max_cost_increase) : bucket_mask(0),
+                                                               lowest_cost(0),
+                                                               number_of_points(0),
+                                                               number_of_pushes(0),
+                                                               number_of_pops(0)
+{
+    // Find the smallest power of two that can hold all costs from the lowest cost to the lowest cost plus
+    // max_cost_increase
+    uint32_t number_of_buckets = 1;
+    while (number_of_buckets <= max_cost_increase)
+    {
+        number_of_buckets *= 2;
+    }
+
+    buckets.resize(number_of_buckets);
+    bucket_mask = number_of_buckets - 1;
+}
+
+Bucket_queue::~Bucket_queue()
+{
+}
+
+void Bucket_queue::clear()
+{
+    for (std::vector<uint32_t>& bucket : buckets)
+    {
+        bucket.clear();
+    }
+
+    lowest_cost = 0;
+    number_of_points = 0;
+    number_of_pushes = 0;
+    number_of_pops = 0;
+}
@@ -0,0 +1,110 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_BUCKET_QUEUE_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_BUCKET_QUEUE_H_
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A monotone priority queue for integer costs, also known as Dial's algorithm. The points are put in a bucket per cost
+// and the buckets are used in a circular way. It works for searches where a pushed cost is never lower than the cost of
+// the last popped point and never more than max_cost_increase above it. That is the case for A* with a
+// consistent heuristic, where the total cost of a neighbor is at most two move costs above the cost of the current
+// point. Push and pop are then O(1).
+// The queue does not support decrease key. A point is pushed again when its cost is lowered and the old entry must be
+// skipped when it is popped, e.g. by checking if the point has already been closed. Points with the same cost are
+// popped in last in first out order which makes the search go deep before wide among equally cheap points.
+class Bucket_queue
+{
+public:
+    explicit Bucket_queue(const uint32_t max_cost_increase);
+    virtual ~Bucket_queue();
+
+    bool empty() const
+    {
+        return number_of_points == 0;
+    }
+
+    size_t size() const
+    {
+        return number_of_points;
+    }
+
+    // Remove all points from the queue and reset the counters. The allocated memory is kept for the next search.
+    void clear();
+
+    // Add a point with cost. The cost must not be lower than the cost of the last popped point or more than
+    // max_cost_increase above it.
+    void push(const size_t flat_index, const uint32_t cost)
+    {
+        // The lowest cost may have moved past the cost of the last popped point when its bucket became empty. All
+        // buckets in between are empty so the lowest cost can be moved back.
+        if (number_of_points == 0 || cost < lowest_cost)
+        {
+            lowest_cost = cost;
+        }
+
+        buckets[cost & bucket_mask].push_back(static_cast<uint32_t>(flat_index));
+        number_of_points++;
+        number_of_pushes++;
+    }
+
+    // Get the flat index of a point with the lowest cost
+    size_t top() const
+    {
+        return buckets[lowest_cost & bucket_mask].back();
+    }
+
+    // Get the lowest cost in the queue
+    uint32_t top_cost() const
+    {
+        return lowest_cost;
+    }
+
+    // Remove the point returned by top
+    void pop()
+    {
+        buckets[lowest_cost & bucket_mask].pop_back();
+        number_of_points--;
+        number_of_pops++;
+
+        // Move on to the next non-empty bucket. There is at most one lap of buckets to check.
+        while (number_of_points > 0 && buckets[lowest_cost & bucket_mask].empty())
+        {
+            lowest_cost++;
+        }
+    }
+
+    // Counters since the last clear
+    size_t get_number_of_pushes() const
+    {
+        return number_of_pushes;
+    }
+
+    size_t get_number_of_pops() const
+    {
+        return number_of_pops;
+    }
+
+private:
+    // The number of buckets is a power of two larger than max_cost_increase, so the bucket of a cost is found by a
+    // mask. The flat indices are stored as 32 bits like in Flat_point_2D.
+    std::vector<std::vector<uint32_t>> buckets;
+    uint32_t bucket_mask;
+
+    uint32_t lowest_cost;
+    size_t number_of_points;
+
+    size_t number_of_pushes;
+    size_t number_of_pops;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_BUCKET_QUEUE_H_
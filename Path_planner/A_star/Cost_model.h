@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_COST_MODEL_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_COST_MODEL_H_
+
+// Standard library headers
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// The cost models decide the cost of a move and the estimated cheapest cost to the end point (the heuristic h) used by
+// the A_star_planner. Both heuristics are consistent, i.e. h never decreases more than the cost of a move, so a point
+// never needs to be visited again once it has been closed.
+
+// Horizontal and vertical moves cost one and diagonal moves sqrt(1^2 + 1^2) ~= 1.4142136. The cheapest cost to the end
+// point is the line-of-sight distance sqrt(dx^2 + dy^2).
+struct Floating_point_cost_model
+{
+    typedef float Cost;
+
+    static Cost get_straight_cost()
+    {
+        return 1;
+    }
+
+    static Cost get_diagonal_cost()
+    {
+        return 1.4142136;
+    }
+
+    static Cost get_cheapest_cost_to_target(const size_t dx, const size_t dy)
+    {
+        const float fdx = dx;
+        const float fdy = dy;
+        return std::sqrt(fdx*fdx + fdy*fdy);
+    }
+};
+
+// Fixed point costs where horizontal and vertical moves cost 5 and diagonal moves 7, i.e. a diagonal move is 1.4 times
+// a straight move. The cheapest cost to the end point is the octile distance, the exact cost of going diagonal until
+// lined up with the end point and then straight to it. This is the true cost on an open 8-connected grid and thus a
+// stronger estimate than the line-of-sight distance.
+// Only integer additions and compares are used so the results are bit-reproducible across compilers and platforms.
+// The uint32_t path cost is enough for paths with more than 600 million moves.
+struct Fixed_point_octile_cost_model
+{
+    typedef uint32_t Cost;
+
+    static Cost get_straight_cost()
+    {
+        return 5;
+    }
+
+    static Cost get_diagonal_cost()
+    {
+        return 7;
+    }
+
+    static Cost get_cheapest_cost_to_target(const size_t dx, const size_t dy)
+    {
+        const size_t diagonal_moves = dx < dy ? dx : dy;
+        const size_t straight_moves = (dx < dy ? dy : dx) - diagonal_moves;
+        return static_cast<Cost>(diagonal_moves * get_diagonal_cost() + straight_moves * get_straight_cost());
+    }
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_COST_MODEL_H_
@@ -14,29 +14,53 @@
 
 // Standard library headers
 #include <cstddef>
+#include <type_traits>
 
 // This class is mainly used together with a sorted container for sorting points with a cost value. But could also be
 // used to keep track of cost for a given point.
+// It is a 32 bit flat index and a float cost without virtual functions, so an entry of the points to visit heap is 8
+// bytes and is moved with plain copies.
 class Cost_point_2D : public Flat_point_2D
 {
 public:
-    Cost_point_2D(const size_t flat_index, const float cost);
-    Cost_point_2D(const Flat_point_2D& point, const float cost);
+    constexpr Cost_point_2D(const size_t flat_index, const float cost) : Flat_point_2D(flat_index), cost(cost)
+    {
+    }
+
+    constexpr Cost_point_2D(const Flat_point_2D& point, const float cost) : Flat_point_2D(point), cost(cost)
+    {
+    }
+
     // The constructors below need to convert the x and y coordinate to a flat grid index. It requires a multiplication
     // and a addition operation.
-    Cost_point_2D(const size_t x, const size_t y, const size_t width, const float cost);
-    Cost_point_2D(const Coord_point_2D& point, const size_t width, const float cost);
+    constexpr Cost_point_2D(const size_t x, const size_t y, const size_t width, const float cost) :
+                                                                                             Flat_point_2D(x, y, width),
+                                                                                             cost(cost)
+    {
+    }
 
-    virtual ~Cost_point_2D();
+    Cost_point_2D(const Coord_point_2D& point, const size_t width, const float cost) : Flat_point_2D(point, width),
+                                                                                      cost(cost)
+    {
+    }
 
     // Get cost for the point
-    float get_cost() const;
+    constexpr float get_cost() const
+    {
+        return cost;
+    }
 
     // This is for sorting purposes. It will sort by cost in an ascending order.
-    bool operator<(const Cost_point_2D& other_point) const;
+    constexpr bool operator<(const Cost_point_2D& other_point) const
+    {
+        return cost > other_point.cost;
+    }
 
 private:
     float cost;
 };
 
+static_assert(std::is_trivially_copyable<Cost_point_2D>::value, "Cost_point_2D must be trivially copyable");
+static_assert(sizeof(Cost_point_2D) == 8, "Cost_point_2D must be a 32 bit flat index and a 32 bit cost");
+
 #endif // LINE_ROUTER_PATH_PLANNER_A_STAR_COST_POINT_2D_H_
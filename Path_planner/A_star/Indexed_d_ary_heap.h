@@ -0,0 +1,242 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_A_STAR_INDEXED_D_ARY_HEAP_H_
+#define LINE_ROUTER_PATH_PLANNER_A_STAR_INDEXED_D_ARY_HEAP_H_
+
+#include <Cost_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <vector>
+
+// A min heap of cost points where every node has Arity children. The heap position of every point is stored in a
+// position map, which makes it possible to lower the cost of a point that already is in the heap (decrease key) instead
+// of pushing it again. A point is therefore in the heap at most once and the heap never grows larger than the number of
+// points to visit.
+// The position map must have the functions
+//   size_t get_heap_index(const size_t flat_index) const;
+//   void set_heap_index(const size_t flat_index, const size_t heap_index);
+// and, for the functions of the heap that take the width policy of the flat index as an optional last argument, the
+// same functions with the width policy as the last argument, see Grid_width.h. A path planner that is specialized for a
+// width passes its policy so the position map can find the point without a division by the width.
+// The stored heap index is only trusted if the heap entry at that index is the same point, so the position map never
+// needs to be reset.
+// A higher arity gives a shallower heap and fewer cache misses when moving points up, at the cost of more compares when
+// moving points down. Arity 4 is a good default for grid searches where most operations are pushes and decrease keys.
+template<typename Position_map, size_t Arity = 4>
+class Indexed_d_ary_heap
+{
+    static_assert(Arity >= 2, "Indexed_d_ary_heap: Arity must be at least two");
+
+public:
+    explicit Indexed_d_ary_heap(Position_map& position_map) : position_map(position_map),
+                                                              number_of_pushes(0),
+                                                              number_of_pops(0),
+                                                              number_of_decreases(0)
+    {
+    }
+
+    virtual ~Indexed_d_ary_heap()
+    {
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    // Remove all points from the heap and reset the counters. The allocated memory is kept for the next search.
+    void clear()
+    {
+        heap.clear();
+        number_of_pushes = 0;
+        number_of_pops = 0;
+        number_of_decreases = 0;
+    }
+
+    // Check if the point with flat_index is in the heap
+    template<typename Width_policy>
+    bool contains(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        const size_t heap_index = get_heap_index(flat_index, grid_width);
+        return heap_index < heap.size() && heap[heap_index].get_flat_index() == flat_index;
+    }
+    bool contains(const size_t flat_index) const
+    {
+        return contains(flat_index, No_width_policy());
+    }
+
+    // Add a point to the heap. The point must not already be in the heap.
+    template<typename Width_policy>
+    void push(const Cost_point_2D& point, const Width_policy& grid_width)
+    {
+        number_of_pushes++;
+        heap.push_back(point);
+        move_up(heap.size() - 1, grid_width);
+    }
+    void push(const Cost_point_2D& point)
+    {
+        push(point, No_width_policy());
+    }
+
+    // Lower the cost of a point that is already in the heap
+    template<typename Width_policy>
+    void decrease_cost(const Cost_point_2D& point, const Width_policy& grid_width)
+    {
+        number_of_decreases++;
+        const size_t heap_index = get_heap_index(point.get_flat_index(), grid_width);
+        heap[heap_index] = point;
+        move_up(heap_index, grid_width);
+    }
+    void decrease_cost(const Cost_point_2D& point)
+    {
+        decrease_cost(point, No_width_policy());
+    }
+
+    // Get the point with the lowest cost
+    const Cost_point_2D& top() const
+    {
+        return heap.front();
+    }
+
+    // Remove the point with the lowest cost
+    template<typename Width_policy>
+    void pop(const Width_policy& grid_width)
+    {
+        number_of_pops++;
+        heap.front() = heap.back();
+        heap.pop_back();
+        if (not heap.empty())
+        {
+            move_down(0, grid_width);
+        }
+    }
+    void pop()
+    {
+        pop(No_width_policy());
+    }
+
+    // Counters since the last clear
+    size_t get_number_of_pushes() const
+    {
+        return number_of_pushes;
+    }
+
+    size_t get_number_of_pops() const
+    {
+        return number_of_pops;
+    }
+
+    size_t get_number_of_decreases() const
+    {
+        return number_of_decreases;
+    }
+
+private:
+    Position_map& position_map;
+    std::vector<Cost_point_2D> heap;
+
+    size_t number_of_pushes;
+    size_t number_of_pops;
+    size_t number_of_decreases;
+
+    // Used by the functions that are not given a width policy, the position map then finds the point by itself
+    struct No_width_policy
+    {
+    };
+
+    template<typename Width_policy>
+    size_t get_heap_index(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return position_map.get_heap_index(flat_index, grid_width);
+    }
+    size_t get_heap_index(const size_t flat_index, const No_width_policy&) const
+    {
+        return position_map.get_heap_index(flat_index);
+    }
+
+    template<typename Width_policy>
+    void set_heap_index(const size_t flat_index, const size_t heap_index, const Width_policy& grid_width)
+    {
+        position_map.set_heap_index(flat_index, heap_index, grid_width);
+    }
+    void set_heap_index(const size_t flat_index, const size_t heap_index, const No_width_policy&)
+    {
+        position_map.set_heap_index(flat_index, heap_index);
+    }
+
+    // Move the point at heap_index towards the root until its parent has a lower or equal cost
+    template<typename Width_policy>
+    void move_up(size_t heap_index, const Width_policy& grid_width)
+    {
+        const Cost_point_2D point = heap[heap_index];
+        while (heap_index > 0)
+        {
+            const size_t parent_index = (heap_index - 1) / Arity;
+            if (not (point.get_cost() < heap[parent_index].get_cost()))
+            {
+                break;
+            }
+
+            heap[heap_index] = heap[parent_index];
+            set_heap_index(heap[heap_index].get_flat_index(), heap_index, grid_width);
+            heap_index = parent_index;
+        }
+
+        heap[heap_index] = point;
+        set_heap_index(point.get_flat_index(), heap_index, grid_width);
+    }
+
+    // Move the point at heap_index towards the leaves until all its children have a higher or equal cost
+    template<typename Width_policy>
+    void move_down(size_t heap_index, const Width_policy& grid_width)
+    {
+        const Cost_point_2D point = heap[heap_index];
+        const size_t heap_size = heap.size();
+        while (true)
+        {
+            const size_t first_child_index = heap_index * Arity + 1;
+            if (first_child_index >= heap_size)
+            {
+                break;
+            }
+
+            // Find the child with the lowest cost
+            const size_t last_child_index = first_child_index + Arity < heap_size ? first_child_index + Arity
+                                                                                  : heap_size;
+            size_t cheapest_child_index = first_child_index;
+            for (size_t child_index = first_child_index + 1; child_index < last_child_index; child_index++)
+            {
+                if (heap[child_index].get_cost() < heap[cheapest_child_index].get_cost())
+                {
+                    cheapest_child_index = child_index;
+                }
+            }
+
+            if (not (heap[cheapest_child_index].get_cost() < point.get_cost()))
+            {
+                break;
+            }
+
+            heap[heap_index] = heap[cheapest_child_index];
+            set_heap_index(heap[heap_index].get_flat_index(), heap_index, grid_width);
+            heap_index = cheapest_child_index;
+        }
+
+        heap[heap_index] = point;
+        set_heap_index(point.get_flat_index(), heap_index, grid_width);
+    }
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_A_STAR_INDEXED_D_ARY_HEAP_H_
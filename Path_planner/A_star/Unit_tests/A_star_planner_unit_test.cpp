@@ -7,14 +7,43 @@
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include <A_star_planner.h>
+#include <A_star_planner_factory.h>
+#include <A_star_planner_pool.h>
+#include <A_star_planner_specialization.h>
 #include <Availability_grid.h>
+#include <Cancellation_token.h>
 #include <Coord_point_2D.h>
+#include <Flat_point_2D.h>
 
 // Google test header
 #include <gtest/gtest.h>
 
 // Standard library headers
+#include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Count the straight and diagonal moves of a path
+void count_moves(const std::vector<Coord_point_2D>& path, size_t& straight_moves, size_t& diagonal_moves)
+{
+    straight_moves = 0;
+    diagonal_moves = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        const bool is_diagonal = path.at(i).get_x() != path.at(i-1).get_x() &&
+                                 path.at(i).get_y() != path.at(i-1).get_y();
+        is_diagonal ? diagonal_moves++ : straight_moves++;
+    }
+}
+
+} // namespace
 
 TEST(A_star_planner, Simple_open_area)
 {
@@ -117,6 +146,12 @@ TEST(A_star_planner, Large_open_area)
     std::vector<Coord_point_2D> path;
     ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
 
+    // Only the points on the diagonal are expanded, and expanding point i, i visits the points within two steps of the
+    // diagonal, i.e. all points where |x - y| <= 2. Every visited point is pushed to the points to visit heap once.
+    // That is grid_width + 2 * (grid_width - 1) + 2 * (grid_width - 2) pushes and grid_width pops.
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pushes(), 5 * grid_width - 6);
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pops(), grid_width);
+
     // Best path would be to go diagonal to end point
     ASSERT_EQ(path.size(), size_t(grid_width));
     for (size_t i = 0; i < path.size()-1; i++)
@@ -151,6 +186,15 @@ TEST(A_star_planner, Large_area_with_diagonal_block)
     std::vector<Coord_point_2D> path;
     ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
 
+    // All points in front of the block, x + y < grid_width - 1, are expanded and so are the points of the last row
+    // behind it. The point 0, grid_height - 1 and the points of the second last row behind the block are visited but
+    // not expanded. Many points get a lower cost while they are in the points to visit heap, but with decrease key
+    // every visited point is still pushed once, where pushing a point again for every lower cost gave 4172470 pushes.
+    const size_t points_in_front_of_block = grid_width * (grid_width - 1) / 2;
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pushes(), points_in_front_of_block + 1 + (grid_width - 1) +
+                                                          (grid_width - 2));
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pops(), points_in_front_of_block + (grid_width - 1));
+
     // Best path would be to go straight down to point 0,1998 (1999 points used) and 1 step diagonal to 1,1999 and then
     // right to 1999,1999 (1998 points used) which in total gives 3998 points used including start and end point
     ASSERT_EQ(path.size(), size_t(grid_height + grid_width - 2));
@@ -191,6 +235,26 @@ TEST(A_star_planner, Impossible_to_reach_end_point)
     EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
 }
 
+TEST(A_star_planner, Impossible_to_reach_end_point_with_component_index)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    availability_grid->set_component_index_enabled(true);
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(99, 99);
+
+    A_star_planner a_star_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+    EXPECT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+
+    availability_grid->set_blocked(98,98);
+    availability_grid->set_blocked(99,98);
+    availability_grid->set_blocked(98,99);
+
+    // The end point is rejected without searching
+    EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pops(), size_t(0));
+}
+
 TEST(A_star_planner, End_point_outside_border)
 {
     const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(1000, 1000);
@@ -321,4 +385,750 @@ TEST(A_star_planner, Change_of_grid_size)
     {
         EXPECT_EQ(path.at(i), Coord_point_2D(i, i));
     }
+
+    // Setting a grid of the same size does not resize it, so its caches and change counter are kept
+    availability_grid->set_component_index_enabled(true);
+    availability_grid->update_component_index();
+    const size_t number_of_changes = availability_grid->get_number_of_changes();
+    a_star_planner.set_availability_grid(availability_grid);
+    a_star_planner.set_grid_size(grid_width, grid_height);
+    EXPECT_EQ(availability_grid->get_number_of_changes(), number_of_changes);
+    EXPECT_FALSE(availability_grid->get_component_index().is_dirty());
+}
+
+TEST(A_star_planner, Repeated_queries)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+
+    A_star_planner a_star_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    // The search state from a previous query must not be used by the next query
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+    ASSERT_EQ(path.size(), size_t(100));
+
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(10, 10), Coord_point_2D(12, 10), path));
+    ASSERT_EQ(path.size(), size_t(3));
+    EXPECT_EQ(path.front(), Coord_point_2D(10, 10));
+    EXPECT_EQ(path.back(),  Coord_point_2D(12, 10));
+
+    // Trap the end point, the points visited by the earlier queries must not make it reachable
+    availability_grid->set_blocked(98, 98);
+    availability_grid->set_blocked(99, 98);
+    availability_grid->set_blocked(98, 99);
+    EXPECT_FALSE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+}
+
+TEST(A_star_planner, Fixed_point_octile_open_area)
+{
+    const size_t grid_width  = 600;
+    const size_t grid_height = grid_width;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+    EXPECT_EQ(a_star_planner.get_cost_mode(), A_star_planner::Cost_mode::fixed_point_octile);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(grid_width-1, grid_height-1), path));
+
+    // Best path would be to go diagonal to end point
+    ASSERT_EQ(path.size(), size_t(grid_width));
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        EXPECT_EQ(path.at(i), Coord_point_2D(i, i));
+    }
+
+    // The octile heuristic is exact on an open grid so only the points on the path should be expanded
+    EXPECT_EQ(a_star_planner.get_number_of_heap_pops(), path.size());
+}
+
+TEST(A_star_planner, Fixed_point_octile_area_with_diagonal_block)
+{
+    const size_t grid_width  = 600;
+    const size_t grid_height = grid_width;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    // Same diagonal block as in Normal_sized_area_with_diagonal_block
+    for (size_t x = 1; x < grid_width; x++)
+    {
+        const size_t y = grid_width-x-1;
+        availability_grid->set_blocked(x, y);
+    }
+
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(grid_width-1, grid_height-1), path));
+
+    // The path must pass through the opening with one diagonal move and the rest straight moves
+    size_t straight_moves;
+    size_t diagonal_moves;
+    count_moves(path, straight_moves, diagonal_moves);
+    EXPECT_EQ(diagonal_moves, size_t(1));
+    EXPECT_EQ(straight_moves, size_t(grid_width + grid_height - 4));
+    EXPECT_EQ(path.size(), size_t(grid_height + grid_width - 2));
+}
+
+TEST(A_star_planner, Fixed_point_octile_impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    availability_grid->set_blocked(98,98);
+    availability_grid->set_blocked(99,98);
+    availability_grid->set_blocked(98,99);
+
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    std::vector<Coord_point_2D> path;
+    EXPECT_FALSE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+
+    // Switching back to floating point costs must give the same answer
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::floating_point);
+    EXPECT_FALSE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+}
+
+TEST(A_star_planner, Fixed_point_octile_same_cost_as_floating_point)
+{
+    const size_t grid_width  = 64;
+    const size_t grid_height = 48;
+
+    std::mt19937 random_generator(4711);
+    std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+    std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+    std::uniform_int_distribution<int> random_percent(0, 99);
+
+    for (size_t test = 0; test < 100; test++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid =
+                                                   std::make_shared<Availability_grid>(grid_width, grid_height);
+        for (size_t y = 0; y < grid_height; y++)
+        {
+            for (size_t x = 0; x < grid_width; x++)
+            {
+                if (random_percent(random_generator) < 30)
+                {
+                    availability_grid->set_blocked(x, y);
+                }
+            }
+        }
+
+        const Coord_point_2D start_point(random_x(random_generator), random_y(random_generator));
+        const Coord_point_2D end_point(random_x(random_generator), random_y(random_generator));
+        availability_grid->set_available(start_point);
+        availability_grid->set_available(end_point);
+
+        A_star_planner floating_point_planner(availability_grid);
+        A_star_planner fixed_point_planner(availability_grid);
+        fixed_point_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+        std::vector<Coord_point_2D> floating_point_path;
+        std::vector<Coord_point_2D> fixed_point_path;
+        const bool floating_point_found = floating_point_planner.get_path(start_point, end_point, floating_point_path);
+        const bool fixed_point_found    = fixed_point_planner.get_path(start_point, end_point, fixed_point_path);
+        ASSERT_EQ(floating_point_found, fixed_point_found);
+        if (not fixed_point_found)
+        {
+            continue;
+        }
+
+        EXPECT_EQ(fixed_point_path.front(), start_point);
+        EXPECT_EQ(fixed_point_path.back(),  end_point);
+
+        // The fixed point path must be the cheapest in its own cost model. A diagonal move costs 7/5 = 1.4 instead of
+        // 1.4142136 so measured with the floating point costs it can be at most about one percent more expensive.
+        size_t floating_point_straight;
+        size_t floating_point_diagonal;
+        size_t fixed_point_straight;
+        size_t fixed_point_diagonal;
+        count_moves(floating_point_path, floating_point_straight, floating_point_diagonal);
+        count_moves(fixed_point_path, fixed_point_straight, fixed_point_diagonal);
+
+        EXPECT_LE(fixed_point_straight*5 + fixed_point_diagonal*7,
+                  floating_point_straight*5 + floating_point_diagonal*7);
+        EXPECT_LE(fixed_point_straight + fixed_point_diagonal*std::sqrt(2.0),
+                  (floating_point_straight + floating_point_diagonal*std::sqrt(2.0)) * 1.011 + 1e-3);
+    }
+}
+
+TEST(A_star_planner, Legal_move_cache_gives_same_path)
+{
+    const size_t grid_width  = 100;
+    const size_t grid_height = 80;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    const std::shared_ptr<Availability_grid> cached_availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                        grid_height);
+    cached_availability_grid->set_legal_move_cache_enabled(true);
+
+    A_star_planner a_star_planner(availability_grid);
+    A_star_planner cached_a_star_planner(cached_availability_grid);
+
+    std::mt19937 random_generator(4711);
+    std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+    std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+
+    // Route a number of lines and block every routed path in both grids, like the Line router does
+    for (size_t line = 0; line < 30; line++)
+    {
+        const Coord_point_2D start_point(random_x(random_generator), random_y(random_generator));
+        const Coord_point_2D end_point(random_x(random_generator), random_y(random_generator));
+
+        std::vector<Coord_point_2D> path;
+        std::vector<Coord_point_2D> cached_path;
+        const bool found = a_star_planner.get_path(start_point, end_point, path);
+        ASSERT_EQ(cached_a_star_planner.get_path(start_point, end_point, cached_path), found);
+        ASSERT_EQ(cached_path, path);
+
+        if (found)
+        {
+            for (const Coord_point_2D& point : path)
+            {
+                a_star_planner.set_blocked(point);
+                cached_a_star_planner.set_blocked(point);
+            }
+        }
+    }
+}
+
+TEST(A_star_planner, Commit_path)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(20, 20);
+    A_star_planner a_star_planner(availability_grid);
+
+    // Route a horizontal line and commit it with a halo of one point
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(0, 10), Coord_point_2D(19, 10), path));
+    EXPECT_EQ(a_star_planner.commit_path(path, 1), Coord_rectangle_2D(0, 9, 19, 11));
+
+    for (size_t x = 0; x < 20; x++)
+    {
+        EXPECT_FALSE(availability_grid->is_available(x, 9));
+        EXPECT_FALSE(availability_grid->is_available(x, 10));
+        EXPECT_FALSE(availability_grid->is_available(x, 11));
+        EXPECT_TRUE(availability_grid->is_available(x, 8));
+        EXPECT_TRUE(availability_grid->is_available(x, 12));
+    }
+
+    // The committed line and its halo splits the grid in two
+    std::vector<Coord_point_2D> crossing_path;
+    EXPECT_FALSE(a_star_planner.get_path(Coord_point_2D(5, 0), Coord_point_2D(5, 19), crossing_path));
+}
+
+TEST(A_star_planner, Cancellation_token)
+{
+    const size_t grid_width  = 2000;
+    const size_t grid_height = grid_width;
+
+    // The end point is trapped so the search has to visit every point before it gives up
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    availability_grid->set_blocked(grid_width-2, grid_height-2);
+    availability_grid->set_blocked(grid_width-1, grid_height-2);
+    availability_grid->set_blocked(grid_width-2, grid_height-1);
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+
+    A_star_planner a_star_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    // An already cancelled token stops the search after the first poll
+    std::shared_ptr<Cancellation_token> cancellation_token = std::make_shared<Cancellation_token>();
+    cancellation_token->cancel();
+    a_star_planner.set_cancellation_token(cancellation_token);
+    EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_LE(a_star_planner.get_number_of_heap_pops(), size_t(256));
+
+    // A token without time budget left
+    a_star_planner.set_cancellation_token(std::make_shared<Cancellation_token>(std::chrono::milliseconds(0)));
+    EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_LE(a_star_planner.get_number_of_heap_pops(), size_t(256));
+
+    // Cancel from another thread while searching
+    cancellation_token = std::make_shared<Cancellation_token>();
+    a_star_planner.set_cancellation_token(cancellation_token);
+    std::thread cancel_thread([cancellation_token]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cancellation_token->cancel();
+    });
+    EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
+    cancel_thread.join();
+    EXPECT_LT(a_star_planner.get_number_of_heap_pops(), grid_width * grid_height);
+
+    // A generous time budget does not stop a normal search
+    a_star_planner.set_cancellation_token(std::make_shared<Cancellation_token>(std::chrono::seconds(60)));
+    ASSERT_TRUE(a_star_planner.get_path(start_point, Coord_point_2D(100, 100), path));
+    EXPECT_EQ(path.size(), size_t(101));
+
+    a_star_planner.set_cancellation_token(nullptr);
+    ASSERT_TRUE(a_star_planner.get_path(start_point, Coord_point_2D(100, 100), path));
+}
+
+TEST(A_star_planner, Search_statistics)
+{
+    const size_t grid_width  = 200;
+    const size_t grid_height = grid_width;
+
+    // The diagonal block from Normal_sized_area_with_diagonal_block
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    for (size_t x = 1; x < grid_width; x++)
+    {
+        availability_grid->set_blocked(x, grid_width-x-1);
+    }
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+
+    A_star_planner a_star_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    // Disabled by default, nothing is collected
+    EXPECT_FALSE(a_star_planner.is_search_statistics_enabled());
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_EQ(a_star_planner.get_search_statistics().number_of_expanded_points, size_t(0));
+    EXPECT_EQ(a_star_planner.get_search_statistics().number_of_heap_pops, size_t(0));
+
+    a_star_planner.set_search_statistics_enabled(true);
+    EXPECT_TRUE(a_star_planner.is_search_statistics_enabled());
+    if (not search_statistics_compiled_in)
+    {
+        return;
+    }
+
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        a_star_planner.set_cost_mode(cost_mode);
+        ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+
+        const Search_statistics& statistics = a_star_planner.get_search_statistics();
+        EXPECT_GE(statistics.number_of_expanded_points, path.size());
+        // Every pop either expands a point or skips an old entry of a closed point
+        EXPECT_EQ(statistics.number_of_heap_pops, statistics.number_of_expanded_points +
+                                                  statistics.number_of_stale_pops);
+        EXPECT_EQ(statistics.number_of_heap_pops, a_star_planner.get_number_of_heap_pops());
+        EXPECT_EQ(statistics.number_of_heap_pushes, a_star_planner.get_number_of_heap_pushes());
+        EXPECT_GE(statistics.number_of_visited_points, statistics.number_of_expanded_points);
+        EXPECT_GE(statistics.number_of_generated_points + 1, statistics.number_of_visited_points);
+        EXPECT_GT(statistics.peak_points_to_visit, size_t(0));
+        EXPECT_LE(statistics.peak_points_to_visit, statistics.number_of_heap_pushes);
+        EXPECT_GE(statistics.scratch_bytes_touched,
+                  statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point());
+        EXPECT_GE(statistics.reset_time_ms, 0.0);
+        EXPECT_GT(statistics.search_time_ms, 0.0);
+        EXPECT_GE(statistics.reconstruct_time_ms, 0.0);
+    }
+
+    // The heap supports decrease key so no point is popped twice
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::floating_point);
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_EQ(a_star_planner.get_search_statistics().number_of_stale_pops, size_t(0));
+
+    // A failed search expands every reachable point. The statistics are reset for every query.
+    availability_grid->set_blocked(0, 1);
+    availability_grid->set_blocked(1, 1);
+    availability_grid->set_blocked(1, 0);
+    EXPECT_FALSE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_EQ(a_star_planner.get_search_statistics().number_of_expanded_points, size_t(1));
+    EXPECT_EQ(a_star_planner.get_search_statistics().number_of_visited_points, size_t(1));
+    EXPECT_DOUBLE_EQ(a_star_planner.get_search_statistics().reconstruct_time_ms, 0.0);
+}
+
+TEST(A_star_planner, Expansion_trace)
+{
+    const size_t grid_width  = 100;
+    const size_t grid_height = grid_width;
+
+    A_star_planner a_star_planner(grid_width, grid_height);
+    const Coord_point_2D start_point(10, 20);
+    const Coord_point_2D end_point(80, 60);
+    std::vector<Coord_point_2D> path;
+
+    // Disabled by default, nothing is recorded
+    EXPECT_FALSE(a_star_planner.is_expansion_trace_enabled());
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_TRUE(a_star_planner.get_expansion_trace().empty());
+
+    a_star_planner.set_expansion_trace_enabled(true);
+    EXPECT_TRUE(a_star_planner.is_expansion_trace_enabled());
+    if (not search_statistics_compiled_in)
+    {
+        return;
+    }
+
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        a_star_planner.set_cost_mode(cost_mode);
+
+        // Only the trace is enabled, the statistics are not collected
+        ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+        EXPECT_EQ(a_star_planner.get_search_statistics().number_of_expanded_points, size_t(0));
+        const size_t trace_size = a_star_planner.get_expansion_trace().size();
+
+        a_star_planner.set_search_statistics_enabled(true);
+        ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+        a_star_planner.set_search_statistics_enabled(false);
+
+        // The trace is cleared for every query and has one entry per expanded point, from the start point to the end
+        // point. The path cost is scaled so that both cost models give the length of the path to the end point, the
+        // fixed point costs with a diagonal cost of 1.4.
+        const Expansion_trace& expansion_trace = a_star_planner.get_expansion_trace();
+        ASSERT_EQ(expansion_trace.size(), trace_size);
+        EXPECT_EQ(expansion_trace.size(), a_star_planner.get_search_statistics().number_of_expanded_points);
+        EXPECT_EQ(expansion_trace.front().flat_index, Flat_point_2D(start_point, grid_width).get_flat_index());
+        EXPECT_FLOAT_EQ(expansion_trace.front().path_cost, 0.0f);
+        EXPECT_EQ(expansion_trace.back().flat_index, Flat_point_2D(end_point, grid_width).get_flat_index());
+        EXPECT_NEAR(expansion_trace.back().path_cost, 30.0f + 40.0f * std::sqrt(2.0f), 0.6f);
+        for (const Expanded_point& expanded_point : expansion_trace)
+        {
+            EXPECT_LT(expanded_point.flat_index, grid_width * grid_height);
+            EXPECT_LE(expanded_point.path_cost, expansion_trace.back().path_cost + 0.001f);
+        }
+    }
+
+    a_star_planner.set_expansion_trace_enabled(false);
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    EXPECT_TRUE(a_star_planner.get_expansion_trace().empty());
+}
+
+TEST(A_star_planner, Bytes_per_point)
+{
+    const size_t width = 1024;
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(width, width);
+    A_star_planner a_star_planner(availability_grid);
+
+    // The search state and one bit per point of the availability grid, plus its border
+    const double bytes_per_point = a_star_planner.get_bytes_per_point();
+    EXPECT_GE(bytes_per_point, Search_state_grid::get_bytes_per_point() + 0.125);
+    EXPECT_LE(bytes_per_point, Search_state_grid::get_bytes_per_point() + 0.25);
+    EXPECT_EQ(a_star_planner.get_number_of_bytes(), availability_grid->get_number_of_bytes() +
+                                                    width * width * Search_state_grid::get_bytes_per_point());
+
+    // The points to visit are not counted, so a query does not change the number of bytes
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(width - 1, width - 1), path));
+    EXPECT_EQ(a_star_planner.get_bytes_per_point(), bytes_per_point);
+}
+
+TEST(A_star_planner, Narrow_grids)
+{
+    // On grids one or two points wide the flat index offsets of some directions are equal, the previous points must
+    // still lead back to the start point
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        for (size_t narrow_size = 1; narrow_size <= 2; narrow_size++)
+        {
+            for (const bool is_vertical : {true, false})
+            {
+                const size_t length = 10;
+                const size_t width = is_vertical ? narrow_size : length;
+                const size_t height = is_vertical ? length : narrow_size;
+                A_star_planner a_star_planner(width, height);
+                a_star_planner.set_cost_mode(cost_mode);
+
+                std::vector<Coord_point_2D> path;
+                const Coord_point_2D start(0, 0);
+                const Coord_point_2D end(width - 1, height - 1);
+                ASSERT_TRUE(a_star_planner.get_path(start, end, path));
+                ASSERT_EQ(path.size(), length);
+                EXPECT_EQ(path.front(), start);
+                EXPECT_EQ(path.back(), end);
+                // Every point is a neighbor of the point before it
+                for (size_t i = 1; i < path.size(); i++)
+                {
+                    const int dx = static_cast<int>(path.at(i).get_x()) - static_cast<int>(path.at(i-1).get_x());
+                    const int dy = static_cast<int>(path.at(i).get_y()) - static_cast<int>(path.at(i-1).get_y());
+                    EXPECT_LE(std::abs(dx), 1);
+                    EXPECT_LE(std::abs(dy), 1);
+                    EXPECT_NE(std::abs(dx) + std::abs(dy), 0);
+                }
+            }
+        }
+    }
+}
+
+TEST(A_star_planner, Factory_picks_width_policy)
+{
+    typedef A_star_planner_factory::Connectivity_type Connectivity_type;
+    typedef Fixed_width<A_star_planner_factory::fixed_board_width> Board_width;
+    typedef A_star_planner_specialization<Board_width, Eight_connected> Board_planner;
+    typedef A_star_planner_specialization<Power_of_two_width, Four_connected> Power_of_two_planner;
+    typedef A_star_planner_specialization<Runtime_width, Eight_connected_strict> Other_planner;
+
+    const std::shared_ptr<Availability_grid> board = std::make_shared<Availability_grid>(600, 600);
+    const std::shared_ptr<Availability_grid> power_of_two_board = std::make_shared<Availability_grid>(512, 300);
+    const std::shared_ptr<Availability_grid> other_board = std::make_shared<Availability_grid>(300, 512);
+
+    const std::unique_ptr<A_star_planner> board_planner = A_star_planner_factory::create(board,
+                                                                                 Connectivity_type::eight_connected);
+    const std::unique_ptr<A_star_planner> power_of_two_planner = A_star_planner_factory::create(power_of_two_board,
+                                                                                   Connectivity_type::four_connected);
+    const std::unique_ptr<A_star_planner> other_planner = A_star_planner_factory::create(other_board,
+                                                                            Connectivity_type::eight_connected_strict);
+
+    EXPECT_NE(dynamic_cast<Board_planner*>(board_planner.get()), nullptr);
+    EXPECT_NE(dynamic_cast<Power_of_two_planner*>(power_of_two_planner.get()), nullptr);
+    EXPECT_NE(dynamic_cast<Other_planner*>(other_planner.get()), nullptr);
+
+    EXPECT_THROW(A_star_planner_factory::create(nullptr, Connectivity_type::eight_connected), const char*);
+}
+
+TEST(A_star_planner, Specializations_give_same_path)
+{
+    typedef A_star_planner_factory::Connectivity_type Connectivity_type;
+
+    // The fixed board width, a power of two width and a runtime width
+    for (const size_t grid_width : {size_t(600), size_t(256), size_t(300)})
+    {
+        const size_t grid_height = 200;
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                         grid_height);
+        std::mt19937 random_generator(4711);
+        std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+        std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+        for (size_t i = 0; i < grid_width * grid_height / 5; i++)
+        {
+            availability_grid->set_blocked(random_x(random_generator), random_y(random_generator));
+        }
+
+        A_star_planner a_star_planner(availability_grid);
+        const std::unique_ptr<A_star_planner> specialized_planner = A_star_planner_factory::create(availability_grid,
+                                                                                  Connectivity_type::eight_connected);
+
+        for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                          A_star_planner::Cost_mode::fixed_point_octile})
+        {
+            a_star_planner.set_cost_mode(cost_mode);
+            specialized_planner->set_cost_mode(cost_mode);
+            for (size_t line = 0; line < 10; line++)
+            {
+                const Coord_point_2D start_point(random_x(random_generator), random_y(random_generator));
+                const Coord_point_2D end_point(random_x(random_generator), random_y(random_generator));
+
+                std::vector<Coord_point_2D> path;
+                std::vector<Coord_point_2D> specialized_path;
+                const bool found = a_star_planner.get_path(start_point, end_point, path);
+                ASSERT_EQ(specialized_planner->get_path(start_point, end_point, specialized_path), found);
+                ASSERT_EQ(specialized_path, path);
+            }
+        }
+    }
+}
+
+TEST(A_star_planner, Four_connected)
+{
+    typedef A_star_planner_factory::Connectivity_type Connectivity_type;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(600, 600);
+    const std::unique_ptr<A_star_planner> planner = A_star_planner_factory::create(availability_grid,
+                                                                                   Connectivity_type::four_connected);
+
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        planner->set_cost_mode(cost_mode);
+
+        // Only horizontal and vertical moves, the path is as long as the Manhattan distance
+        std::vector<Coord_point_2D> path;
+        ASSERT_TRUE(planner->get_path(Coord_point_2D(10, 10), Coord_point_2D(30, 20), path));
+        size_t straight_moves = 0;
+        size_t diagonal_moves = 0;
+        count_moves(path, straight_moves, diagonal_moves);
+        EXPECT_EQ(straight_moves, size_t(30));
+        EXPECT_EQ(diagonal_moves, size_t(0));
+    }
+
+    // A diagonal gap can not be passed
+    for (size_t i = 0; i < 600; i++)
+    {
+        availability_grid->set_blocked(i, 599 - i);
+        if (i > 0)
+        {
+            availability_grid->set_available(i - 1, 599 - i);
+        }
+    }
+    std::vector<Coord_point_2D> path;
+    EXPECT_FALSE(planner->get_path(Coord_point_2D(0, 0), Coord_point_2D(599, 599), path));
+}
+
+TEST(A_star_planner, Eight_connected_strict)
+{
+    typedef A_star_planner_factory::Connectivity_type Connectivity_type;
+
+    // A blocked point next to the diagonal move from start to end
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(600, 600);
+    availability_grid->set_blocked(11, 10);
+    const Coord_point_2D start(10, 10);
+    const Coord_point_2D end(11, 11);
+
+    const std::unique_ptr<A_star_planner> planner = A_star_planner_factory::create(availability_grid,
+                                                                                   Connectivity_type::eight_connected);
+    const std::unique_ptr<A_star_planner> strict_planner = A_star_planner_factory::create(availability_grid,
+                                                                            Connectivity_type::eight_connected_strict);
+
+    // The corner is cut unless the connectivity is strict
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(planner->get_path(start, end, path));
+    EXPECT_EQ(path, std::vector<Coord_point_2D>({start, end}));
+    ASSERT_TRUE(strict_planner->get_path(start, end, path));
+    EXPECT_EQ(path, std::vector<Coord_point_2D>({start, Coord_point_2D(10, 11), end}));
+
+    // The same moves with the legal move cache
+    availability_grid->set_legal_move_cache_enabled(true);
+    ASSERT_TRUE(strict_planner->get_path(start, end, path));
+    EXPECT_EQ(path, std::vector<Coord_point_2D>({start, Coord_point_2D(10, 11), end}));
+
+    // The runtime width is used when the grid is resized to a width the specialization does not support
+    availability_grid->resize(700, 600);
+    ASSERT_TRUE(strict_planner->get_path(start, Coord_point_2D(650, 10), path));
+    EXPECT_EQ(path.back(), Coord_point_2D(650, 10));
+}
+
+
+// Plan paths on several threads with a pool that has fewer planners than threads and compare them to the paths of one
+// planner
+TEST(A_star_planner, Planner_pool)
+{
+    const size_t grid_width  = 600;
+    const size_t grid_height = 400;
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    std::mt19937 random_generator(4711);
+    std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+    std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+    for (size_t i = 0; i < grid_width * grid_height / 5; i++)
+    {
+        availability_grid->set_blocked(random_x(random_generator), random_y(random_generator));
+    }
+    availability_grid->set_legal_move_cache_enabled(true);
+    availability_grid->set_component_index_enabled(true);
+
+    const size_t number_of_queries = 64;
+    std::vector<Coord_point_2D> start_points;
+    std::vector<Coord_point_2D> end_points;
+    std::vector<std::vector<Coord_point_2D>> expected_paths(number_of_queries);
+    A_star_planner a_star_planner(availability_grid);
+    for (size_t query = 0; query < number_of_queries; query++)
+    {
+        start_points.push_back(Coord_point_2D(random_x(random_generator), random_y(random_generator)));
+        end_points.push_back(Coord_point_2D(random_x(random_generator), random_y(random_generator)));
+        a_star_planner.get_path(start_points.back(), end_points.back(), expected_paths.at(query));
+    }
+
+    A_star_planner_pool pool(availability_grid, 3);
+    EXPECT_EQ(pool.get_number_of_planners(), size_t(3));
+
+    // Every other thread keeps its lease for all its queries, the others lease a planner per query
+    const size_t number_of_threads = 8;
+    std::vector<std::vector<Coord_point_2D>> paths(number_of_queries);
+    std::vector<std::thread> threads;
+    for (size_t thread_number = 0; thread_number < number_of_threads; thread_number++)
+    {
+        threads.push_back(std::thread([&, thread_number]()
+        {
+            for (size_t query = thread_number; query < number_of_queries; query += number_of_threads)
+            {
+                if (thread_number % 2 == 0)
+                {
+                    pool.get_path(start_points.at(query), end_points.at(query), paths.at(query));
+                }
+                else
+                {
+                    A_star_planner_pool::Lease lease = pool.lease();
+                    lease.get_planner().set_cost_mode(A_star_planner::Cost_mode::floating_point);
+                    lease.get_path(start_points.at(query), end_points.at(query), paths.at(query));
+                }
+            }
+        }));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t query = 0; query < number_of_queries; query++)
+    {
+        EXPECT_EQ(paths.at(query), expected_paths.at(query));
+    }
+
+    // Block a wall through the grid while the other threads are planning, afterwards no path crosses it
+    std::thread planning_thread([&]()
+    {
+        std::vector<Coord_point_2D> path;
+        for (size_t query = 0; query < number_of_queries; query++)
+        {
+            pool.get_path(start_points.at(query), end_points.at(query), path);
+        }
+    });
+    pool.change_availability_grid([](Availability_grid& grid)
+    {
+        for (size_t y = 0; y < grid.get_height(); y++)
+        {
+            grid.set_blocked(300, y);
+        }
+    });
+    planning_thread.join();
+    std::vector<Coord_point_2D> path;
+    EXPECT_FALSE(pool.get_path(Coord_point_2D(0, 0), Coord_point_2D(599, 399), path));
+    EXPECT_FALSE(pool.get_availability_grid()->get_component_index().is_dirty());
+
+    EXPECT_THROW(A_star_planner_pool(availability_grid, 0), const char*);
+    EXPECT_THROW(A_star_planner_pool(nullptr, 1), const char*);
+}
+
+// Resize the board of a pool while threads are planning. The planners of the pool must not resize the shared board
+// themselves, every query after the change sees the new size.
+TEST(A_star_planner, Planner_pool_resize)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    availability_grid->set_component_index_enabled(true);
+    A_star_planner_pool pool(availability_grid, 4);
+
+    const size_t number_of_threads = 4;
+    std::vector<std::thread> threads;
+    for (size_t thread_number = 0; thread_number < number_of_threads; thread_number++)
+    {
+        threads.push_back(std::thread([&pool]()
+        {
+            std::vector<Coord_point_2D> path;
+            for (size_t query = 0; query < 50; query++)
+            {
+                A_star_planner_pool::Lease lease = pool.lease();
+                const size_t width = lease.get_planner().get_width();
+                ASSERT_TRUE(lease.get_path(Coord_point_2D(0, 0), Coord_point_2D(width - 1, width - 1), path));
+                ASSERT_EQ(path.size(), width);
+            }
+        }));
+    }
+
+    for (const size_t width : {size_t(120), size_t(80), size_t(150)})
+    {
+        pool.change_availability_grid([width](Availability_grid& grid)
+        {
+            grid.resize(width, width);
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Lease all planners at once to check each of them
+    {
+        std::vector<A_star_planner_pool::Lease> leases;
+        for (size_t planner_number = 0; planner_number < pool.get_number_of_planners(); planner_number++)
+        {
+            leases.push_back(pool.lease());
+            EXPECT_EQ(leases.back().get_planner().get_width(), size_t(150));
+        }
+    }
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(pool.get_path(Coord_point_2D(0, 0), Coord_point_2D(149, 149), path));
+    EXPECT_EQ(path.size(), size_t(150));
 }
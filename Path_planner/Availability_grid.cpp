@@ -7,74 +7,347 @@
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include <Availability_grid.h>
-#include <Flat_grid_2D.h>
+#include <Bit_grid_2D.h>
+#include <Component_index.h>
 #include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Legal_move_table.h>
 
 // Standard library headers
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 
-Availability_grid::Availability_grid(const size_t width, const size_t height) : Flat_grid_2D(width, height)
+namespace
+{
+    // The square of all points within radius of a point in x and y, clamped to a width x height grid. The radius can be
+    // larger than the grid, so the limits are clamped before they are added to avoid a wrap around.
+    Coord_rectangle_2D get_clamped_square(const Coord_point_2D& point,
+                                          const size_t radius,
+                                          const size_t width,
+                                          const size_t height)
+    {
+        const size_t x = point.get_x();
+        const size_t y = point.get_y();
+        return Coord_rectangle_2D(x > radius ? x - radius : 0,
+                                  y > radius ? y - radius : 0,
+                                  radius >= width - x ? width - 1 : x + radius,
+                                  radius >= height - y ? height - 1 : y + radius);
+    }
+}
+
+Availability_grid::Availability_grid(const size_t width, const size_t height) : bit_grid(width, height, true),
+                                                                                legal_move_cache_enabled(false),
+                                                                                component_index_enabled(false),
+                                                                                number_of_changes(0)
 {
-    std::fill(vec.begin(), vec.end(), true);
 }
 
 Availability_grid::~Availability_grid()
 {
 }
 
+size_t Availability_grid::get_width() const
+{
+    return bit_grid.get_width();
+}
+
+size_t Availability_grid::get_height() const
+{
+    return bit_grid.get_height();
+}
+
+void Availability_grid::fill(const bool value)
+{
+    bit_grid.fill(value);
+    number_of_changes++;
+    rebuild_legal_move_cache();
+    if (component_index_enabled)
+    {
+        component_index.reset(bit_grid);
+    }
+}
+
+void Availability_grid::resize(const size_t width, const size_t height, const bool value)
+{
+    // Nothing changes, keep the caches and the change counter
+    if (width == get_width() && height == get_height())
+    {
+        return;
+    }
+
+    bit_grid.resize(width, height, value);
+    number_of_changes++;
+    rebuild_legal_move_cache();
+    if (component_index_enabled)
+    {
+        component_index.reset(bit_grid);
+    }
+}
+
 bool Availability_grid::is_available(const size_t flat_index) const
 {
-    return get(flat_index);
+    return is_available(Flat_point_2D(flat_index));
 }
 
 bool Availability_grid::is_available(const Flat_point_2D& point) const
 {
-    return is_available(point);
+    if (get_width() == 0)
+    {
+        throw std::out_of_range("Availability_grid: Point out of range");
+    }
+    return bit_grid.get(point.get_x(get_width()), point.get_y(get_width()));
 }
 
 void Availability_grid::set_available(const size_t flat_index)
 {
-    set(flat_index, true);
+    set_available(Flat_point_2D(flat_index));
 }
 
 void Availability_grid::set_available(const Flat_point_2D& point)
 {
-    set(point, true);
+    if (get_width() == 0)
+    {
+        throw std::out_of_range("Availability_grid: Point out of range");
+    }
+    set_value(point.get_x(get_width()), point.get_y(get_width()), true);
 }
 
 void Availability_grid::set_blocked(const size_t flat_index)
 {
-    set(flat_index, false);
+    set_blocked(Flat_point_2D(flat_index));
 }
 
 void Availability_grid::set_blocked(const Flat_point_2D& point)
 {
-    set(point, false);
+    if (get_width() == 0)
+    {
+        throw std::out_of_range("Availability_grid: Point out of range");
+    }
+    set_value(point.get_x(get_width()), point.get_y(get_width()), false);
 }
 
 bool Availability_grid::is_available(const size_t x, const size_t y) const
 {
-    return get(x, y);
+    return bit_grid.get(x, y);
 }
 bool Availability_grid::is_available(const Coord_point_2D& point) const
 {
-    return get(point);
+    return bit_grid.get(point.get_x(), point.get_y());
 }
 
 void Availability_grid::set_available(const size_t x, const size_t y)
 {
-    set(x, y, true);
+    set_value(x, y, true);
 }
 void Availability_grid::set_available(const Coord_point_2D& point)
 {
-    set(point, true);
+    set_value(point.get_x(), point.get_y(), true);
 }
 
 void Availability_grid::set_blocked(const size_t x, size_t y)
 {
-    set(x, y, false);
+    set_value(x, y, false);
 }
 void Availability_grid::set_blocked(const Coord_point_2D& point)
 {
-    set(point, false);
+    set_value(point.get_x(), point.get_y(), false);
+}
+
+void Availability_grid::set_legal_move_cache_enabled(const bool enabled)
+{
+    legal_move_cache_enabled = enabled;
+    rebuild_legal_move_cache();
+}
+
+bool Availability_grid::is_legal_move_cache_enabled() const
+{
+    return legal_move_cache_enabled;
+}
+
+uint8_t Availability_grid::get_legal_move_mask(const size_t x, const size_t y) const
+{
+    if (legal_move_cache_enabled)
+    {
+        return legal_move_cache[x + y * get_width()];
+    }
+
+    return Legal_move_table::get(bit_grid.get_neighbor_mask(x, y)).legal_mask;
+}
+
+void Availability_grid::set_value(const size_t x, const size_t y, const bool value)
+{
+    if (bit_grid.get(x, y) == value)
+    {
+        // Nothing changed, the legal move masks are still valid
+        return;
+    }
+
+    bit_grid.set(x, y, value);
+    number_of_changes++;
+
+    if (component_index_enabled)
+    {
+        component_index.mark_dirty(Coord_rectangle_2D(x, y, x, y));
+    }
+
+    if (not legal_move_cache_enabled)
+    {
+        return;
+    }
+
+    // The legal move mask of a point only depends on its eight neighbors, so only the neighbors of the changed point
+    // need to be updated
+    update_legal_move_cache(Coord_rectangle_2D(x > 0 ? x - 1 : 0,
+                                               y > 0 ? y - 1 : 0,
+                                               x + 1 < get_width() ? x + 1 : x,
+                                               y + 1 < get_height() ? y + 1 : y));
+}
+
+Coord_rectangle_2D Availability_grid::block_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius)
+{
+    const Coord_rectangle_2D dirty_rectangle = bit_grid.clear_dilated(path, halo_radius);
+    number_of_changes++;
+
+    if (component_index_enabled)
+    {
+        // Only mark the tiles around the path, the bounding rectangle of a long diagonal path covers most of the grid
+        for (const Coord_point_2D& point : path)
+        {
+            component_index.mark_dirty(get_clamped_square(point, halo_radius, get_width(), get_height()));
+        }
+    }
+
+    if (legal_move_cache_enabled)
+    {
+        // Only the points within halo_radius + 1 of the path can get a new legal move mask. Updating the square around
+        // every path point keeps the cost proportional to the path length even if the bounding rectangle is large.
+        // A halo radius that covers the whole grid is not increased, it can not grow the square and could wrap around.
+        const size_t radius = halo_radius < get_width() + get_height() ? halo_radius + 1 : halo_radius;
+        for (const Coord_point_2D& point : path)
+        {
+            update_legal_move_cache(get_clamped_square(point, radius, get_width(), get_height()));
+        }
+    }
+
+    return dirty_rectangle;
+}
+
+void Availability_grid::set_component_index_enabled(const bool enabled)
+{
+    component_index_enabled = enabled;
+    if (enabled)
+    {
+        component_index.reset(bit_grid);
+    }
+    else
+    {
+        component_index.clear();
+    }
+}
+
+bool Availability_grid::is_component_index_enabled() const
+{
+    return component_index_enabled;
+}
+
+bool Availability_grid::is_reachable(const Coord_point_2D& start, const Coord_point_2D& end)
+{
+    if (not component_index_enabled || start == end)
+    {
+        return true;
+    }
+
+    if (not bit_grid.get(end.get_x(), end.get_y()))
+    {
+        return false;
+    }
+
+    const uint32_t end_component = get_component(end.get_x(), end.get_y());
+    if (bit_grid.get(start.get_x(), start.get_y()))
+    {
+        return get_component(start.get_x(), start.get_y()) == end_component;
+    }
+
+    // A blocked start point reaches the components of the neighbors it can move to
+    const Legal_move_table::Legal_moves& legal_moves =
+                                      Legal_move_table::get(bit_grid.get_neighbor_mask(start.get_x(), start.get_y()));
+    const std::array<int, 8> direction_dx = {{-1,  0, 1, 0, -1,  1, 1, -1}};
+    const std::array<int, 8> direction_dy = {{ 0, -1, 0, 1, -1, -1, 1,  1}};
+    for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+    {
+        const uint8_t direction = legal_moves.directions[move];
+        if (get_component(start.get_x() + direction_dx[direction], start.get_y() + direction_dy[direction]) ==
+            end_component)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint32_t Availability_grid::get_component(const size_t x, const size_t y)
+{
+    if (not component_index_enabled)
+    {
+        throw "Availability_grid::get_component: Component index is not enabled";
+    }
+
+    component_index.update(bit_grid);
+    return component_index.get_component(x, y);
+}
+
+void Availability_grid::update_component_index()
+{
+    if (component_index_enabled)
+    {
+        component_index.update(bit_grid);
+    }
+}
+
+const Component_index& Availability_grid::get_component_index() const
+{
+    return component_index;
+}
+
+size_t Availability_grid::get_number_of_bytes() const
+{
+    // The component index is empty when disabled
+    return bit_grid.get_number_of_bytes() + legal_move_cache.capacity() * sizeof(uint8_t)
+           + component_index.get_number_of_bytes();
+}
+
+void Availability_grid::rebuild_legal_move_cache()
+{
+    if (not legal_move_cache_enabled)
+    {
+        std::vector<uint8_t>().swap(legal_move_cache);
+        return;
+    }
+
+    const size_t width = get_width();
+    const size_t height = get_height();
+    legal_move_cache.resize(width * height);
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            legal_move_cache[x + y * width] = Legal_move_table::get(bit_grid.get_neighbor_mask(x, y)).legal_mask;
+        }
+    }
+}
+
+void Availability_grid::update_legal_move_cache(const Coord_rectangle_2D& rectangle)
+{
+    const size_t width = get_width();
+    for (size_t y = rectangle.get_min_y(); y <= rectangle.get_max_y(); y++)
+    {
+        for (size_t x = rectangle.get_min_x(); x <= rectangle.get_max_x(); x++)
+        {
+            legal_move_cache[x + y * width] = Legal_move_table::get(bit_grid.get_neighbor_mask(x, y)).legal_mask;
+        }
+    }
 }
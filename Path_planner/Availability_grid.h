@@ -9,21 +9,43 @@
 #ifndef LINE_ROUTER_PATH_PLANNER_AVAILABILITY_GRID_H_
 #define LINE_ROUTER_PATH_PLANNER_AVAILABILITY_GRID_H_
 
-#include <Flat_grid_2D.h>
+#include <Bit_grid_2D.h>
+#include <Component_index.h>
 #include <Flat_point_2D.h>
 #include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
 
 // Standard library headers
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
-// This bool grid is used to set available/blocked grid points. It is initialized with all true values, i.e. available.
-// See Flat_grid_2D for more information about the flattened grid.
-class Availability_grid : public Flat_grid_2D<bool>
+// This grid is used to set available/blocked grid points. It is initialized with all points available.
+// The points are stored as a bitboard with a blocked border, see Bit_grid_2D, so the availability of all eight
+// neighbors of a point can be read at once with get_neighbor_mask. The flat index functions use the same indexing as
+// Flat_grid_2D. All functions except get_neighbor_mask throw a std::out_of_range exception if the point is out of
+// bounds.
+// An optional cache keeps the legal move mask of every point, see Legal_move_table. It is updated for the eight
+// neighbors of a point when the point changes, so blocking a path costs O(path length) and the planner only needs one
+// byte load per expanded point.
+// An optional component index keeps the connected components of the available points, see Component_index, so that a
+// planner can reject a query between two components without searching. It is updated for the tiles around the changed
+// points when it is used.
+class Availability_grid
 {
 public:
     Availability_grid(const size_t width, const size_t height);
     virtual ~Availability_grid();
 
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Fill all grid points with value, true is available
+    void fill(const bool value);
+
+    // Resize the grid. The points inside both the old and the new grid are kept and the new points are set to value.
+    void resize(const size_t width, const size_t height, const bool value = true);
+
     bool is_available(const size_t flat_index) const;
     bool is_available(const Flat_point_2D& point) const;
 
@@ -43,6 +65,87 @@ public:
 
     void set_blocked(const size_t x, size_t y);
     void set_blocked(const Coord_point_2D& point);
+
+    // Block all points of a path and all points within halo_radius of them in x and y. The whole path is blocked with
+    // word-level operations on the bitboard and the legal move cache, if enabled, is only updated around the path.
+    // Returns the rectangle of points that may have changed.
+    Coord_rectangle_2D block_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius);
+
+    // Get the availability of the eight neighbors of point x, y as a mask with one bit per neighbor, see
+    // Bit_grid_2D::Neighbor_bit. Neighbors outside the grid are blocked. There are no range checks, x and y must be
+    // inside the grid.
+    uint8_t get_neighbor_mask(const size_t x, const size_t y) const
+    {
+        return bit_grid.get_neighbor_mask(x, y);
+    }
+
+    // Enable or disable the legal move cache. The cache is built when enabled and freed when disabled. It is disabled
+    // by default.
+    void set_legal_move_cache_enabled(const bool enabled);
+    bool is_legal_move_cache_enabled() const;
+
+    // Get the legal moves of point x, y as a mask with one bit per legal direction, see Legal_move_table. The mask is
+    // taken from the cache if enabled. There are no range checks, x and y must be inside the grid.
+    uint8_t get_legal_move_mask(const size_t x, const size_t y) const;
+
+    // Get the cached legal move mask of a point. There are no range checks and the cache must be enabled.
+    uint8_t get_cached_legal_move_mask(const size_t flat_index) const
+    {
+        return legal_move_cache[flat_index];
+    }
+
+    // Enable or disable the component index. The index is built when it is first used and freed when disabled. It is
+    // disabled by default.
+    void set_component_index_enabled(const bool enabled);
+    bool is_component_index_enabled() const;
+
+    // Check if a path of legal moves can lead from start to end. A blocked start point can be left but a blocked end
+    // point can never be reached. It is always true if the component index is disabled. The dirty tiles of the index
+    // are labelled first, otherwise the check is O(1).
+    bool is_reachable(const Coord_point_2D& start, const Coord_point_2D& end);
+
+    // Get the component of point x, y, or Component_index::no_component if the point is blocked. The component index
+    // must be enabled.
+    uint32_t get_component(const size_t x, const size_t y);
+
+    // Label the dirty tiles of the component index, if enabled. Until the grid is changed again is_reachable and
+    // get_component then only read the grid, so planners on several threads can share it, see A_star_planner_pool.
+    void update_component_index();
+
+    // Get the component index, e.g. to check how many tiles it has labelled
+    const Component_index& get_component_index() const;
+
+    // Get the number of bytes allocated for the bitboard, the legal move cache and the component index
+    size_t get_number_of_bytes() const;
+
+    // Get the number of changes of the grid since it was created. It is increased by every call that changes points,
+    // so a structure built from the grid can check if it is still valid.
+    size_t get_number_of_changes() const
+    {
+        return number_of_changes;
+    }
+
+private:
+    // A set bit is an available point
+    Bit_grid_2D bit_grid;
+
+    // The legal move mask of every point indexed by flat index. Empty when the cache is disabled.
+    bool legal_move_cache_enabled;
+    std::vector<uint8_t> legal_move_cache;
+
+    bool component_index_enabled;
+    Component_index component_index;
+
+    size_t number_of_changes;
+
+    // Set the availability of a point and update the legal move masks of its neighbors if it changed
+    void set_value(const size_t x, const size_t y, const bool value);
+
+    // Recalculate the cached legal move masks of all points
+    void rebuild_legal_move_cache();
+
+    // Recalculate the cached legal move masks of the points in the rectangle
+    void update_legal_move_cache(const Coord_rectangle_2D& rectangle);
 };
 
 #endif // LINE_ROUTER_PATH_PLANNER_AVAILABILITY_GRID_H_
@@ -0,0 +1,521 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Bidirectional_A_star_planner.h>
+#include <A_star_planner.h>
+#include <Cost_model.h>
+#include <Cost_point_2D.h>
+#include <Bucket_queue.h>
+#include <Indexed_d_ary_heap.h>
+#include <Flat_point_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    // Add a point to the points to visit or lower its cost if it is already there, see A_star_planner
+    void update_points_to_visit(Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit,
+                                const size_t flat_index,
+                                const float total_cost,
+                                const bool is_in_points_to_visit)
+    {
+        const Cost_point_2D cost_point(flat_index, total_cost);
+        if (is_in_points_to_visit)
+        {
+            points_to_visit.decrease_cost(cost_point);
+        }
+        else
+        {
+            points_to_visit.push(cost_point);
+        }
+    }
+
+    void update_points_to_visit(Bucket_queue& points_to_visit,
+                                const size_t flat_index,
+                                const uint32_t total_cost,
+                                const bool)
+    {
+        points_to_visit.push(flat_index, total_cost);
+    }
+
+    // Get the flat index of the point with the lowest total cost
+    size_t get_cheapest_point_to_visit(const Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit)
+    {
+        return points_to_visit.top().get_flat_index();
+    }
+
+    size_t get_cheapest_point_to_visit(const Bucket_queue& points_to_visit)
+    {
+        return points_to_visit.top();
+    }
+
+    // Get the lowest key of the points to visit. The bucket queue may return the key of an old entry of a closed point,
+    // which is never higher than the lowest key of the points that are left, so it is still a lower bound.
+    float get_lowest_key(const Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit)
+    {
+        return points_to_visit.top().get_cost();
+    }
+
+    uint32_t get_lowest_key(const Bucket_queue& points_to_visit)
+    {
+        return points_to_visit.top_cost();
+    }
+
+    // Get the key of a point with path cost from the origin of its search, i.e. the start point for the forward search
+    // and the end point for the reverse search. The key is the path cost plus half the difference between the estimated
+    // costs to the target and to the origin of the search, see Bidirectional_A_star_planner.
+    float get_key(const float path_cost,
+                  const float cost_to_target,
+                  const float cost_to_origin,
+                  const float /* cost_between_end_points */)
+    {
+        return path_cost + 0.5f * (cost_to_target - cost_to_origin);
+    }
+
+    // The fixed point key is doubled to stay an integer. The estimated cost between the end points is added so the key
+    // is never negative, since the estimated cost to the origin is at most the estimated cost to the target plus the
+    // estimated cost between the end points.
+    uint32_t get_key(const uint32_t path_cost,
+                     const uint32_t cost_to_target,
+                     const uint32_t cost_to_origin,
+                     const uint32_t cost_between_end_points)
+    {
+        return 2 * path_cost + cost_to_target + cost_between_end_points - cost_to_origin;
+    }
+
+    // Get the sum of the keys of the two searches at a point with the given path cost from start to end through it
+    float get_key_sum(const float path_cost, const float /* cost_between_end_points */)
+    {
+        return path_cost;
+    }
+
+    uint32_t get_key_sum(const uint32_t path_cost, const uint32_t cost_between_end_points)
+    {
+        return 2 * path_cost + 2 * cost_between_end_points;
+    }
+
+    // Get the number of bytes of one entry in the points to visit
+    size_t get_bytes_per_entry(const Indexed_d_ary_heap<Search_state_grid, 4>&)
+    {
+        return sizeof(Cost_point_2D);
+    }
+
+    size_t get_bytes_per_entry(const Bucket_queue&)
+    {
+        return sizeof(size_t);
+    }
+
+    // Get the x and y distance between two points
+    size_t get_distance(const size_t a, const size_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+}
+
+Bidirectional_A_star_planner::Bidirectional_A_star_planner(std::shared_ptr<Availability_grid> availability_grid) :
+                                                  A_star_planner(availability_grid),
+                                                  reverse_search_state_grid(width, height),
+                                                  reverse_points_to_visit(reverse_search_state_grid),
+                                                  // The doubled key of a neighbor is at most four moves above the key
+                                                  // of the current point, see get_key
+                                                  forward_fixed_point_points_to_visit(
+                                                                4 * Fixed_point_octile_cost_model::get_diagonal_cost()),
+                                                  reverse_fixed_point_points_to_visit(
+                                                                4 * Fixed_point_octile_cost_model::get_diagonal_cost())
+{
+}
+
+Bidirectional_A_star_planner::Bidirectional_A_star_planner(const size_t width, const size_t height) :
+                                        Bidirectional_A_star_planner(std::make_shared<Availability_grid>(width, height))
+{
+}
+
+Bidirectional_A_star_planner::~Bidirectional_A_star_planner()
+{
+}
+
+bool Bidirectional_A_star_planner::get_path(const Coord_point_2D& start,
+                                            const Coord_point_2D& end,
+                                            std::vector<Coord_point_2D>& path)
+{
+    const bool collect_statistics = is_collecting_search_statistics();
+    const bool instrumented = collect_statistics || is_recording_expansion_trace();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect_statistics);
+
+    if (not check_end_points(start, end))
+    {
+        return false;
+    }
+
+    // Clear the points to visit of both searches and their counters
+    points_to_visit.clear();
+    reverse_points_to_visit.clear();
+    forward_fixed_point_points_to_visit.clear();
+    reverse_fixed_point_points_to_visit.clear();
+
+    if (start == end)
+    {
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
+    }
+
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_available(end.get_x(), end.get_y()))
+    {
+        // A move always goes to an available point, so a blocked end point can not be reached. The reverse search
+        // would otherwise leave it since the moves from a point only depend on its neighbors.
+        print_failure(start, end);
+        return false;
+    }
+
+    if (not availability_grid->is_reachable(start, end))
+    {
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
+        return false;
+    }
+
+    // Start a new query for both searches
+    search_state_grid.start_new_query();
+    reverse_search_state_grid.start_new_query();
+
+    if (collect_statistics)
+    {
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
+    }
+
+    bool path_found = false;
+    switch (cost_mode)
+    {
+        case Cost_mode::floating_point:
+            path_found = instrumented
+                       ? bidirectional_search<Floating_point_cost_model, true>(start, end, points_to_visit,
+                                                                               reverse_points_to_visit, path)
+                       : bidirectional_search<Floating_point_cost_model, false>(start, end, points_to_visit,
+                                                                                reverse_points_to_visit, path);
+            break;
+        case Cost_mode::fixed_point_octile:
+            path_found = instrumented
+                       ? bidirectional_search<Fixed_point_octile_cost_model, true>(start, end,
+                                                                                   forward_fixed_point_points_to_visit,
+                                                                                   reverse_fixed_point_points_to_visit,
+                                                                                   path)
+                       : bidirectional_search<Fixed_point_octile_cost_model, false>(start, end,
+                                                                                    forward_fixed_point_points_to_visit,
+                                                                                    reverse_fixed_point_points_to_visit,
+                                                                                    path);
+            break;
+    }
+
+    if (not path_found)
+    {
+        print_failure(start, end);
+    }
+
+    return path_found;
+}
+
+template<typename Cost_model, bool Instrumented, typename Points_to_visit_type>
+bool Bidirectional_A_star_planner::bidirectional_search(const Coord_point_2D& start,
+                                                        const Coord_point_2D& end,
+                                                        Points_to_visit_type& forward_points_to_visit,
+                                                        Points_to_visit_type& reverse_points_to_visit,
+                                                        std::vector<Coord_point_2D>& path)
+{
+    typedef typename Cost_model::Cost Cost;
+
+    // The counters and the trace are removed at compile time unless they are both requested and compiled in
+    const bool collect = Instrumented && search_statistics_compiled_in && search_statistics_enabled;
+    const bool trace = Instrumented && search_statistics_compiled_in && expansion_trace_enabled;
+    const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect);
+
+    const size_t start_index = start.get_flat_index(width);
+    const size_t end_index = end.get_flat_index(width);
+
+    // Both searches start with zero cost and the estimated cost to the other end point
+    const Cost cost_between_end_points = Cost_model::get_cheapest_cost_to_target(
+                                                                           get_distance(start.get_x(), end.get_x()),
+                                                                           get_distance(start.get_y(), end.get_y()));
+    const Cost start_key = get_key(Cost(0), cost_between_end_points, Cost(0), cost_between_end_points);
+    search_state_grid.set(start_index, Cost(0), start_index);
+    update_points_to_visit(forward_points_to_visit, start_index, start_key, false);
+    reverse_search_state_grid.set(end_index, Cost(0), end_index);
+    update_points_to_visit(reverse_points_to_visit, end_index, start_key, false);
+
+    if (collect)
+    {
+        search_statistics.number_of_visited_points = 2;
+        search_statistics.peak_points_to_visit = 2;
+    }
+
+    // The cost of the cheapest path found so far and the point where the two searches met on it
+    const Cost no_path_cost = std::numeric_limits<Cost>::has_infinity ? std::numeric_limits<Cost>::infinity()
+                                                                      : std::numeric_limits<Cost>::max();
+    Cost best_path_cost = no_path_cost;
+    size_t meeting_index = start_index;
+
+    bool cancelled = false;
+    while (forward_points_to_visit.empty() == false && reverse_points_to_visit.empty() == false)
+    {
+        // A path that is cheaper than the cheapest path found so far must pass a point that neither search has
+        // expanded, and the sum of its keys is at least the sum of the lowest keys of the two searches
+        if (best_path_cost != no_path_cost &&
+            not (get_lowest_key(forward_points_to_visit) + get_lowest_key(reverse_points_to_visit) <
+                 get_key_sum(best_path_cost, cost_between_end_points)))
+        {
+            break;
+        }
+
+        // Expand the search with the fewest points to visit
+        const bool is_forward = forward_points_to_visit.size() <= reverse_points_to_visit.size();
+        Points_to_visit_type& points_to_visit = is_forward ? forward_points_to_visit : reverse_points_to_visit;
+        Search_state_grid& this_search_state_grid = is_forward ? search_state_grid : reverse_search_state_grid;
+        const Search_state_grid& other_search_state_grid = is_forward ? reverse_search_state_grid : search_state_grid;
+
+        // Pop the point which have the lowest total cost
+        const size_t current_index = get_cheapest_point_to_visit(points_to_visit);
+        points_to_visit.pop();
+
+        if (should_stop(forward_points_to_visit.get_number_of_pops() + reverse_points_to_visit.get_number_of_pops()))
+        {
+            // Cancelled or out of time
+            cancelled = true;
+            break;
+        }
+
+        if (this_search_state_grid.is_closed(current_index))
+        {
+            // An old entry of a point that has been pushed again with a lower cost, see Bucket_queue
+            if (collect)
+            {
+                search_statistics.number_of_stale_pops++;
+            }
+            continue;
+        }
+
+        // The path cost of the current point can not be lowered any more so it is closed
+        this_search_state_grid.set_closed(current_index);
+
+        if (collect)
+        {
+            search_statistics.number_of_expanded_points++;
+        }
+
+        if (trace)
+        {
+            // The path cost in units of a horizontal or vertical move
+            const float path_cost = static_cast<float>(this_search_state_grid.get_path_cost<Cost>(current_index)) /
+                                    static_cast<float>(Cost_model::get_straight_cost());
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index), path_cost};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        size_t number_of_new_points = 0;
+        const size_t number_of_updated_points = expand<Cost_model>(current_index,
+                                                                   is_forward ? end : start,
+                                                                   is_forward ? start : end,
+                                                                   cost_between_end_points,
+                                                                   this_search_state_grid,
+                                                                   other_search_state_grid,
+                                                                   points_to_visit,
+                                                                   best_path_cost,
+                                                                   meeting_index,
+                                                                   number_of_new_points);
+
+        if (collect)
+        {
+            search_statistics.number_of_generated_points += number_of_updated_points;
+            search_statistics.number_of_visited_points += number_of_new_points;
+            search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                              forward_points_to_visit.size() +
+                                                              reverse_points_to_visit.size());
+        }
+    }
+
+    // The searches have met if the best path cost is set
+    bool path_found = false;
+    if (not cancelled && best_path_cost < no_path_cost)
+    {
+        const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect);
+        path_found = reconstruct_bidirectional_path(start, end, meeting_index, path);
+        if (collect)
+        {
+            search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
+        }
+    }
+
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = forward_points_to_visit.get_number_of_pushes() +
+                                                  reverse_points_to_visit.get_number_of_pushes();
+        search_statistics.number_of_heap_pops = forward_points_to_visit.get_number_of_pops() +
+                                                reverse_points_to_visit.get_number_of_pops();
+        search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time) -
+                                           search_statistics.reconstruct_time_ms;
+        search_statistics.scratch_bytes_touched =
+                               search_statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point() +
+                               search_statistics.peak_points_to_visit * get_bytes_per_entry(forward_points_to_visit);
+    }
+
+    return path_found;
+}
+
+template<typename Cost_model, typename Points_to_visit_type>
+size_t Bidirectional_A_star_planner::expand(const size_t current_index,
+                                            const Coord_point_2D& target,
+                                            const Coord_point_2D& origin,
+                                            const typename Cost_model::Cost cost_between_end_points,
+                                            Search_state_grid& this_search_state_grid,
+                                            const Search_state_grid& other_search_state_grid,
+                                            Points_to_visit_type& points_to_visit,
+                                            typename Cost_model::Cost& best_path_cost,
+                                            size_t& meeting_index,
+                                            size_t& number_of_new_points)
+{
+    typedef typename Cost_model::Cost Cost;
+
+    const size_t target_x = target.get_x();
+    const size_t target_y = target.get_y();
+    const size_t origin_x = origin.get_x();
+    const size_t origin_y = origin.get_y();
+    const Cost path_cost_current_point = this_search_state_grid.get_path_cost<Cost>(current_index);
+
+    Neighbors neighbors;
+    size_t number_of_updated_points = 0;
+    const size_t number_of_neighbors = get_neighbors(Flat_point_2D(current_index), neighbors);
+    for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+    {
+        const size_t neighbor_index = neighbors.at(neighbor_number).first.get_flat_index();
+        const bool is_diagonal = neighbors.at(neighbor_number).second;
+
+        if (this_search_state_grid.is_closed(neighbor_index))
+        {
+            // The cheapest path to a closed point has already been found
+            continue;
+        }
+
+        const Cost path_cost = path_cost_current_point + (is_diagonal ? Cost_model::get_diagonal_cost()
+                                                                      : Cost_model::get_straight_cost());
+        if (not (path_cost < this_search_state_grid.get_path_cost<Cost>(neighbor_index)))
+        {
+            continue;
+        }
+
+        // Update the path cost and the previous point and add the point to the points to visit, or lower its key if
+        // it is already there
+        const bool is_in_points_to_visit = this_search_state_grid.is_visited(neighbor_index);
+        const size_t neighbor_x = neighbor_index % width;
+        const size_t neighbor_y = neighbor_index / width;
+        const Cost cost_to_target = Cost_model::get_cheapest_cost_to_target(get_distance(neighbor_x, target_x),
+                                                                            get_distance(neighbor_y, target_y));
+        const Cost cost_to_origin = Cost_model::get_cheapest_cost_to_target(get_distance(neighbor_x, origin_x),
+                                                                            get_distance(neighbor_y, origin_y));
+        const Cost key = get_key(path_cost, cost_to_target, cost_to_origin, cost_between_end_points);
+        this_search_state_grid.set(neighbor_index, path_cost, current_index);
+        update_points_to_visit(points_to_visit, neighbor_index, key, is_in_points_to_visit);
+
+        number_of_updated_points++;
+        number_of_new_points += is_in_points_to_visit ? 0 : 1;
+
+        if (other_search_state_grid.is_visited(neighbor_index))
+        {
+            // The searches meet at the neighbor
+            const Cost meeting_path_cost = path_cost + other_search_state_grid.get_path_cost<Cost>(neighbor_index);
+            if (meeting_path_cost < best_path_cost)
+            {
+                best_path_cost = meeting_path_cost;
+                meeting_index = neighbor_index;
+            }
+        }
+    }
+
+    return number_of_updated_points;
+}
+
+bool Bidirectional_A_star_planner::reconstruct_bidirectional_path(const Coord_point_2D& start,
+                                                                  const Coord_point_2D& end,
+                                                                  const size_t meeting_index,
+                                                                  std::vector<Coord_point_2D>& path_vector) const
+{
+    // The forward part from the start point to the meeting point
+    const size_t start_index = start.get_flat_index(width);
+    if (meeting_index == start_index)
+    {
+        path_vector.clear();
+        path_vector.push_back(start);
+    }
+    else if (not reconstruct_path(start, Flat_point_2D(meeting_index), path_vector))
+    {
+        return false;
+    }
+
+    // The reverse part from the meeting point to the end point. It shouldn't take more than width x height iterations
+    // until the end point has been reached.
+    const size_t end_index = end.get_flat_index(width);
+    const size_t max_iterations = width * height;
+    size_t number_of_iterations = 0;
+    size_t next_index = meeting_index;
+    while (next_index != end_index && number_of_iterations < max_iterations)
+    {
+        number_of_iterations++;
+        next_index = reverse_search_state_grid.get_previous(next_index);
+        path_vector.push_back(Coord_point_2D(Flat_point_2D(next_index), width));
+    }
+
+    if (number_of_iterations >= max_iterations)
+    {
+        std::cerr << "ERROR: Maximum iterations to reconstruct the path from the meeting point to end reached"
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void Bidirectional_A_star_planner::set_grid_size(const size_t width, const size_t height)
+{
+    A_star_planner::set_grid_size(width, height);
+
+    if (reverse_search_state_grid.get_width() != width || reverse_search_state_grid.get_height() != height)
+    {
+        reverse_search_state_grid.resize(width, height);
+    }
+}
+
+size_t Bidirectional_A_star_planner::get_number_of_heap_pushes() const
+{
+    return points_to_visit.get_number_of_pushes() + reverse_points_to_visit.get_number_of_pushes() +
+           forward_fixed_point_points_to_visit.get_number_of_pushes() +
+           reverse_fixed_point_points_to_visit.get_number_of_pushes();
+}
+
+size_t Bidirectional_A_star_planner::get_number_of_heap_pops() const
+{
+    return points_to_visit.get_number_of_pops() + reverse_points_to_visit.get_number_of_pops() +
+           forward_fixed_point_points_to_visit.get_number_of_pops() +
+           reverse_fixed_point_points_to_visit.get_number_of_pops();
+}
+
+size_t Bidirectional_A_star_planner::get_number_of_bytes() const
+{
+    return A_star_planner::get_number_of_bytes() + reverse_search_state_grid.get_number_of_bytes();
+}
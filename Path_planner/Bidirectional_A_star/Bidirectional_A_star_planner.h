@@ -0,0 +1,114 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_BIDIRECTIONAL_A_STAR_BIDIRECTIONAL_A_STAR_PLANNER_H_
+#define LINE_ROUTER_PATH_PLANNER_BIDIRECTIONAL_A_STAR_BIDIRECTIONAL_A_STAR_PLANNER_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Bucket_queue.h>
+#include <Coord_point_2D.h>
+#include <Search_state_grid.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// This class finds the same cheapest path as the A_star_planner but searches from both the start point and the end
+// point at the same time. The forward search uses the search state of the A_star_planner, the reverse search has its
+// own search state. The moves are symmetric, so the reverse search finds the cheapest path from every point to the end
+// point.
+// Both searches use the same estimate, half the difference between the estimated cost to the end point h_end and to
+// the start point h_start. The key of a point in the forward search is g + (h_end - h_start) / 2 and in the reverse
+// search g + (h_start - h_end) / 2. Since both estimates are consistent the key never decreases along a path, and the
+// keys of the two searches at a point add up to the cost of the path from start to end through it. This is the same as
+// a bidirectional Dijkstra search on costs that are adjusted towards the middle of the two end points.
+// Every time one search reaches a point that the other search has visited, the two searches meet and the cost of the
+// path through that point is the sum of the two path costs. The cheapest meeting point is kept. The search stops when
+// the lowest keys of the two searches add up to at least the cost of the cheapest path found, since a cheaper path
+// would have to pass a point that neither search has expanded. The path is joined from the previous points of the
+// forward search from the start point to the meeting point and of the reverse search from there to the end point.
+// The search with the fewest points to visit is expanded first. The two searches then grow at about the same rate and
+// meet in the middle, and if one of the end points is boxed in its search runs out of points to visit early and the
+// query fails without flooding the rest of the grid.
+// Both cost modes of the A_star_planner are supported, the fixed point keys are doubled to stay integers. The reverse
+// search doubles the memory of the search state.
+// The search statistics and the expansion trace cover both searches. The path cost of an expanded point in the trace
+// is the cost from the start point for the forward search and from the end point for the reverse search.
+// This class is intended to be accessed by one thread since it is not thread safe.
+class Bidirectional_A_star_planner : public A_star_planner
+{
+public:
+    // Create a Bidirectional_A_star_planner with an already existing availability grid. The availability grid must have
+    // been initialized before calling this. The grid size will be fetched from the availability grid.
+    Bidirectional_A_star_planner(std::shared_ptr<Availability_grid> availability_grid);
+    // Create a Bidirectional_A_star_planner with a grid size of width x height. It will also initialize an all
+    // available width x height availability grid.
+    Bidirectional_A_star_planner(const size_t width, const size_t height);
+
+    virtual ~Bidirectional_A_star_planner();
+
+    // Get a path from start point to end point
+    // Returns a vector with path where first element is the start point and last is the end point
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override;
+
+    // Set a new grid size (could be costly if the grid is large)
+    void set_grid_size(const size_t width, const size_t height) override;
+
+    // Number of points pushed to and popped from the points to visit of both searches in the last call to get_path
+    size_t get_number_of_heap_pushes() const override;
+    size_t get_number_of_heap_pops() const override;
+
+    // Number of bytes of the grids including the search state of the reverse search
+    size_t get_number_of_bytes() const override;
+
+private:
+    // The search state and the points to visit of the reverse search from the end point. The forward search uses the
+    // search state and the points to visit heap of the A_star_planner. Both searches have their own bucket queues for
+    // the fixed point costs since the doubled keys increase more per move than the total cost of the A* search.
+    Search_state_grid reverse_search_state_grid;
+    Points_to_visit reverse_points_to_visit;
+    Bucket_queue forward_fixed_point_points_to_visit;
+    Bucket_queue reverse_fixed_point_points_to_visit;
+
+    // Search from both end points until the cheapest path is found or one of the searches runs out of points to visit
+    template<typename Cost_model, bool Instrumented, typename Points_to_visit_type>
+    bool bidirectional_search(const Coord_point_2D& start,
+                              const Coord_point_2D& end,
+                              Points_to_visit_type& forward_points_to_visit,
+                              Points_to_visit_type& reverse_points_to_visit,
+                              std::vector<Coord_point_2D>& path);
+
+    // Add the neighbors of the expanded point to the points to visit of one search. The origin is the start point of
+    // the forward search and the end point of the reverse search and the target is the other end point. A neighbor
+    // that has been visited by the other search is a meeting point, best_path_cost and meeting_index are updated if
+    // the path through it is cheaper. Returns the number of updated neighbors, number_of_new_points is increased by
+    // the number of neighbors that were not visited before.
+    template<typename Cost_model, typename Points_to_visit_type>
+    size_t expand(const size_t current_index,
+                  const Coord_point_2D& target,
+                  const Coord_point_2D& origin,
+                  const typename Cost_model::Cost cost_between_end_points,
+                  Search_state_grid& this_search_state_grid,
+                  const Search_state_grid& other_search_state_grid,
+                  Points_to_visit_type& points_to_visit,
+                  typename Cost_model::Cost& best_path_cost,
+                  size_t& meeting_index,
+                  size_t& number_of_new_points);
+
+    // Reconstruct the path from start point to end point through the meeting point. The previous points of the forward
+    // search lead from the meeting point back to the start point and the previous points of the reverse search lead
+    // from the meeting point to the end point.
+    bool reconstruct_bidirectional_path(const Coord_point_2D& start,
+                                        const Coord_point_2D& end,
+                                        const size_t meeting_index,
+                                        std::vector<Coord_point_2D>& path_vector) const;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_BIDIRECTIONAL_A_STAR_BIDIRECTIONAL_A_STAR_PLANNER_H_
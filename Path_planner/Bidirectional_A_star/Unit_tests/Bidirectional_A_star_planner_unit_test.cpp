@@ -0,0 +1,246 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Bidirectional_A_star_planner.h>
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Path_planner_test_helpers.h>
+#include <Search_statistics.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Block the eight neighbors of a point
+    void block_neighbors(Availability_grid& availability_grid, const size_t x, const size_t y)
+    {
+        for (size_t neighbor_y = y - 1; neighbor_y <= y + 1; neighbor_y++)
+        {
+            for (size_t neighbor_x = x - 1; neighbor_x <= x + 1; neighbor_x++)
+            {
+                if (neighbor_x != x || neighbor_y != y)
+                {
+                    availability_grid.set_blocked(neighbor_x, neighbor_y);
+                }
+            }
+        }
+    }
+}
+
+TEST(Bidirectional_A_star_planner, Simple_open_area)
+{
+    Bidirectional_A_star_planner planner(2, 2);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(1, 1), path));
+
+    ASSERT_EQ(path.size(),  size_t(2));
+    EXPECT_EQ(path.front(), Coord_point_2D(0, 0));
+    EXPECT_EQ(path.back(),  Coord_point_2D(1, 1));
+
+    // Start point is the end point
+    ASSERT_TRUE(planner.get_path(Coord_point_2D(1, 0), Coord_point_2D(1, 0), path));
+    ASSERT_EQ(path.size(),  size_t(1));
+    EXPECT_EQ(path.front(), Coord_point_2D(1, 0));
+}
+
+TEST(Bidirectional_A_star_planner, Normal_sized_open_area)
+{
+    const size_t grid_width  = 600;
+    const size_t grid_height = grid_width;
+
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+
+    Bidirectional_A_star_planner planner(grid_width, grid_height);
+
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        planner.set_cost_mode(cost_mode);
+
+        std::vector<Coord_point_2D> path;
+        ASSERT_TRUE(planner.get_path(start_point, end_point, path));
+
+        // Best path would be to go diagonal to end point
+        ASSERT_EQ(path.size(), size_t(grid_width));
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            EXPECT_EQ(path.at(i), Coord_point_2D(i, i));
+        }
+    }
+}
+
+TEST(Bidirectional_A_star_planner, Normal_sized_area_with_diagonal_block)
+{
+    const size_t grid_width  = 200;
+    const size_t grid_height = grid_width;
+
+    // Create a diagonal with only one possible point to pass through, see A_star_planner_unit_test
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    for (size_t x = 1; x < grid_width; x++)
+    {
+        availability_grid->set_blocked(x, grid_width-x-1);
+    }
+
+    A_star_planner a_star_planner(availability_grid);
+    Bidirectional_A_star_planner planner(availability_grid);
+
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+}
+
+TEST(Bidirectional_A_star_planner, Impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+
+    Bidirectional_A_star_planner planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    availability_grid->set_blocked(98,98);
+    availability_grid->set_blocked(99,98);
+    availability_grid->set_blocked(98,99);
+
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+
+    // A blocked end point can not be reached
+    availability_grid->set_blocked(0, 99);
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(0, 99), path));
+}
+
+// The reverse search runs out of points to visit right away, so the query fails without flooding the grid
+TEST(Bidirectional_A_star_planner, End_point_trapped_in_the_middle)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    block_neighbors(*availability_grid, 50, 50);
+
+    Bidirectional_A_star_planner planner(availability_grid);
+    planner.set_search_statistics_enabled(true);
+    std::vector<Coord_point_2D> path;
+
+    for (const A_star_planner::Cost_mode cost_mode : {A_star_planner::Cost_mode::floating_point,
+                                                      A_star_planner::Cost_mode::fixed_point_octile})
+    {
+        planner.set_cost_mode(cost_mode);
+        EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(50, 50), path));
+        EXPECT_LE(planner.get_number_of_heap_pops(), size_t(2));
+        if (search_statistics_compiled_in)
+        {
+            EXPECT_LE(planner.get_search_statistics().number_of_expanded_points, size_t(2));
+        }
+    }
+
+    // The same for a trapped start point
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(50, 50), Coord_point_2D(0, 0), path));
+    EXPECT_LE(planner.get_number_of_heap_pops(), size_t(2));
+}
+
+TEST(Bidirectional_A_star_planner, Change_of_grid_size)
+{
+    Bidirectional_A_star_planner planner(100, 100);
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+
+    // Both search state grids follow a larger availability grid
+    planner.set_availability_grid(std::make_shared<Availability_grid>(300, 200));
+    ASSERT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(299, 199), path));
+    EXPECT_EQ(path.size(), size_t(300));
+    EXPECT_EQ(path.back(), Coord_point_2D(299, 199));
+}
+
+// Route between random points on grids with random obstacles and check that the Bidirectional_A_star_planner finds a
+// path exactly when the A_star_planner does and that the paths have the same cost
+TEST(Bidirectional_A_star_planner, Same_cost_as_A_star_planner)
+{
+    const size_t grid_width  = 64;
+    const size_t grid_height = 48;
+    const size_t number_of_grids = 20;
+    const size_t number_of_queries = 25;
+
+    std::mt19937 random_generator(1234);
+    std::uniform_int_distribution<size_t> x_distribution(0, grid_width - 1);
+    std::uniform_int_distribution<size_t> y_distribution(0, grid_height - 1);
+
+    for (size_t grid = 0; grid < number_of_grids; grid++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                         grid_height);
+        // Block between 0 and 38 percent of the points
+        block_random_points(*availability_grid, (grid * 2) % 40, random_generator);
+
+        A_star_planner a_star_planner(availability_grid);
+        Bidirectional_A_star_planner planner(availability_grid);
+
+        // Every other grid uses the fixed point costs
+        if (grid % 2 == 1)
+        {
+            a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+            planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+        }
+
+        for (size_t query = 0; query < number_of_queries; query++)
+        {
+            // The start point may be blocked, a path can always leave it
+            const Coord_point_2D start(x_distribution(random_generator), y_distribution(random_generator));
+            const Coord_point_2D end(x_distribution(random_generator), y_distribution(random_generator));
+            expect_same_cost_as_a_star(planner, a_star_planner, start, end);
+        }
+    }
+}
+
+TEST(Bidirectional_A_star_planner, Search_statistics)
+{
+    const size_t grid_width  = 300;
+    const size_t grid_height = grid_width;
+
+    // Block 20 percent of the points, but not the corners
+    std::mt19937 random_generator(1234);
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    block_random_points(*availability_grid, 20, random_generator);
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+    availability_grid->set_available(start_point);
+    availability_grid->set_available(end_point);
+
+    A_star_planner a_star_planner(availability_grid);
+    Bidirectional_A_star_planner planner(availability_grid);
+    a_star_planner.set_search_statistics_enabled(true);
+    planner.set_search_statistics_enabled(true);
+    planner.set_expansion_trace_enabled(true);
+    if (not search_statistics_compiled_in)
+    {
+        return;
+    }
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    ASSERT_TRUE(planner.get_path(start_point, end_point, path));
+
+    // The unidirectional search floods a wide cone towards the far corner with the line-of-sight estimate
+    const Search_statistics& statistics = planner.get_search_statistics();
+    EXPECT_GT(statistics.number_of_expanded_points, size_t(0));
+    EXPECT_LT(statistics.number_of_expanded_points,
+              a_star_planner.get_search_statistics().number_of_expanded_points);
+
+    // The statistics and the trace cover both searches
+    EXPECT_EQ(statistics.number_of_heap_pops, planner.get_number_of_heap_pops());
+    EXPECT_EQ(statistics.number_of_heap_pushes, planner.get_number_of_heap_pushes());
+    EXPECT_GE(statistics.number_of_visited_points, statistics.number_of_expanded_points);
+    EXPECT_EQ(planner.get_expansion_trace().size(), statistics.number_of_expanded_points);
+}
@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_CANCELLATION_TOKEN_H_
+#define LINE_ROUTER_PATH_PLANNER_CANCELLATION_TOKEN_H_
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+
+// A token used to stop a path planning query before it has finished. The query is stopped either when cancel is called,
+// from any thread, or when the time budget of the token has run out. The path planner polls the token every now and
+// then from its search loop and gives up if it should stop, see Path_planner::set_cancellation_token.
+class Cancellation_token
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Creates a token without a time budget
+    Cancellation_token() : cancelled(false), has_deadline(false)
+    {
+    }
+
+    // Creates a token that stops the query when time_budget has passed from now
+    explicit Cancellation_token(const Clock::duration time_budget) : cancelled(false),
+                                                                     has_deadline(true),
+                                                                     deadline(Clock::now() + time_budget)
+    {
+    }
+
+    virtual ~Cancellation_token()
+    {
+    }
+
+    // Ask the query to stop. This is thread safe.
+    void cancel()
+    {
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // Check if the query should stop, i.e. it has been cancelled or the time budget has run out. This is thread safe.
+    bool is_cancelled() const
+    {
+        return cancelled.load(std::memory_order_relaxed) || (has_deadline && Clock::now() >= deadline);
+    }
+
+private:
+    std::atomic<bool> cancelled;
+
+    const bool has_deadline;
+    const Clock::time_point deadline;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_CANCELLATION_TOKEN_H_
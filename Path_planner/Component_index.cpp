@@ -0,0 +1,331 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Component_index.h>
+#include <Bit_grid_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Legal_move_table.h>
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// The constants are passed by reference in comparisons so they need a definition
+const uint32_t Component_index::no_component;
+const size_t Component_index::tile_size;
+const uint16_t Component_index::no_label;
+
+namespace
+{
+    // The x and y step of each direction, in the order of Bit_grid_2D::Neighbor_bit
+    const std::array<int, 8> direction_dx = {{-1,  0, 1, 0, -1,  1, 1, -1}};
+    const std::array<int, 8> direction_dy = {{ 0, -1, 0, 1, -1, -1, 1,  1}};
+
+    // Find the root of a tile component and shorten the path to it on the way
+    uint32_t find_root(std::vector<uint32_t>& parents, uint32_t component)
+    {
+        while (parents[component] != component)
+        {
+            parents[component] = parents[parents[component]];
+            component = parents[component];
+        }
+        return component;
+    }
+}
+
+Component_index::Component_index() : width(0),
+                                     height(0),
+                                     tiles_x(0),
+                                     tiles_y(0),
+                                     number_of_dirty_tiles(0),
+                                     number_of_relabelled_tiles(0)
+{
+}
+
+Component_index::~Component_index()
+{
+}
+
+void Component_index::reset(const Bit_grid_2D& bit_grid)
+{
+    width = bit_grid.get_width();
+    height = bit_grid.get_height();
+    tiles_x = (width + tile_size - 1) / tile_size;
+    tiles_y = (height + tile_size - 1) / tile_size;
+
+    const size_t number_of_tiles = tiles_x * tiles_y;
+    labels.assign(width * height, no_label);
+    tile_number_of_components.assign(number_of_tiles, 0);
+    tile_dirty.assign(number_of_tiles, 1);
+    tile_border_edges.assign(number_of_tiles, std::vector<Border_edge>());
+    tile_first_component.assign(number_of_tiles, 0);
+    components.clear();
+    number_of_dirty_tiles = number_of_tiles;
+    number_of_relabelled_tiles = 0;
+}
+
+void Component_index::clear()
+{
+    width = 0;
+    height = 0;
+    tiles_x = 0;
+    tiles_y = 0;
+    std::vector<uint16_t>().swap(labels);
+    std::vector<uint16_t>().swap(tile_number_of_components);
+    std::vector<uint8_t>().swap(tile_dirty);
+    std::vector<std::vector<Border_edge>>().swap(tile_border_edges);
+    std::vector<uint32_t>().swap(tile_first_component);
+    std::vector<uint32_t>().swap(components);
+    number_of_dirty_tiles = 0;
+    number_of_relabelled_tiles = 0;
+}
+
+size_t Component_index::get_number_of_bytes() const
+{
+    size_t number_of_bytes = labels.capacity() * sizeof(uint16_t)
+                             + tile_number_of_components.capacity() * sizeof(uint16_t)
+                             + tile_dirty.capacity() * sizeof(uint8_t)
+                             + tile_border_edges.capacity() * sizeof(std::vector<Border_edge>)
+                             + (tile_first_component.capacity() + components.capacity()) * sizeof(uint32_t);
+    for (const std::vector<Border_edge>& border_edges : tile_border_edges)
+    {
+        number_of_bytes += border_edges.capacity() * sizeof(Border_edge);
+    }
+    return number_of_bytes;
+}
+
+void Component_index::mark_dirty(const Coord_rectangle_2D& rectangle)
+{
+    if (rectangle.is_empty())
+    {
+        return;
+    }
+
+    // The moves of the points next to a changed point may change too
+    const size_t min_tile_x = (rectangle.get_min_x() > 0 ? rectangle.get_min_x() - 1 : 0) / tile_size;
+    const size_t min_tile_y = (rectangle.get_min_y() > 0 ? rectangle.get_min_y() - 1 : 0) / tile_size;
+    const size_t max_tile_x = std::min(rectangle.get_max_x() + 1, width - 1) / tile_size;
+    const size_t max_tile_y = std::min(rectangle.get_max_y() + 1, height - 1) / tile_size;
+
+    for (size_t tile_y = min_tile_y; tile_y <= max_tile_y; tile_y++)
+    {
+        for (size_t tile_x = min_tile_x; tile_x <= max_tile_x; tile_x++)
+        {
+            uint8_t& dirty = tile_dirty[tile_x + tile_y * tiles_x];
+            if (not dirty)
+            {
+                dirty = 1;
+                number_of_dirty_tiles++;
+            }
+        }
+    }
+}
+
+void Component_index::update(const Bit_grid_2D& bit_grid)
+{
+    if (number_of_dirty_tiles == 0)
+    {
+        return;
+    }
+
+    const size_t number_of_tiles = tiles_x * tiles_y;
+    for (size_t tile = 0; tile < number_of_tiles; tile++)
+    {
+        if (tile_dirty[tile])
+        {
+            label_tile(bit_grid, tile);
+            number_of_relabelled_tiles++;
+        }
+    }
+
+    // The border edges of a tile go to the tiles to the right, lower left, below and lower right. They are found again
+    // if the tile or one of those tiles has new labels.
+    for (size_t tile = 0; tile < number_of_tiles; tile++)
+    {
+        const size_t tile_x = tile % tiles_x;
+        const size_t tile_y = tile / tiles_x;
+        const bool has_right = tile_x + 1 < tiles_x;
+        const bool has_left = tile_x > 0;
+        const bool has_below = tile_y + 1 < tiles_y;
+        if (tile_dirty[tile] ||
+            (has_right && tile_dirty[tile + 1]) ||
+            (has_below && has_left && tile_dirty[tile + tiles_x - 1]) ||
+            (has_below && tile_dirty[tile + tiles_x]) ||
+            (has_below && has_right && tile_dirty[tile + tiles_x + 1]))
+        {
+            find_border_edges(bit_grid, tile);
+        }
+    }
+
+    std::fill(tile_dirty.begin(), tile_dirty.end(), 0);
+    number_of_dirty_tiles = 0;
+
+    join_components();
+}
+
+void Component_index::label_tile(const Bit_grid_2D& bit_grid, const size_t tile)
+{
+    const size_t min_x = (tile % tiles_x) * tile_size;
+    const size_t min_y = (tile / tiles_x) * tile_size;
+    const size_t end_x = std::min(min_x + tile_size, width);
+    const size_t end_y = std::min(min_y + tile_size, height);
+
+    for (size_t y = min_y; y < end_y; y++)
+    {
+        std::fill(labels.begin() + min_x + y * width, labels.begin() + end_x + y * width, no_label);
+    }
+
+    // Flood fill every available point that has no label yet with a new label
+    uint16_t number_of_components = 0;
+    std::vector<size_t> points_to_fill;
+    for (size_t y = min_y; y < end_y; y++)
+    {
+        for (size_t x = min_x; x < end_x; x++)
+        {
+            if (labels[x + y * width] != no_label || not bit_grid.get(x, y))
+            {
+                continue;
+            }
+
+            labels[x + y * width] = number_of_components;
+            points_to_fill.push_back(x + y * width);
+            while (not points_to_fill.empty())
+            {
+                const size_t point = points_to_fill.back();
+                points_to_fill.pop_back();
+                const size_t point_x = point % width;
+                const size_t point_y = point / width;
+
+                const Legal_move_table::Legal_moves& legal_moves =
+                                                   Legal_move_table::get(bit_grid.get_neighbor_mask(point_x, point_y));
+                for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+                {
+                    // A move never leaves the grid, but it may leave the tile
+                    const uint8_t direction = legal_moves.directions[move];
+                    const size_t neighbor_x = point_x + direction_dx[direction];
+                    const size_t neighbor_y = point_y + direction_dy[direction];
+                    if (neighbor_x < min_x || neighbor_x >= end_x || neighbor_y < min_y || neighbor_y >= end_y)
+                    {
+                        continue;
+                    }
+
+                    uint16_t& neighbor_label = labels[neighbor_x + neighbor_y * width];
+                    if (neighbor_label == no_label)
+                    {
+                        neighbor_label = number_of_components;
+                        points_to_fill.push_back(neighbor_x + neighbor_y * width);
+                    }
+                }
+            }
+
+            number_of_components++;
+        }
+    }
+
+    tile_number_of_components[tile] = number_of_components;
+}
+
+void Component_index::find_border_edges(const Bit_grid_2D& bit_grid, const size_t tile)
+{
+    const size_t min_x = (tile % tiles_x) * tile_size;
+    const size_t min_y = (tile / tiles_x) * tile_size;
+    const size_t max_x = std::min(min_x + tile_size, width) - 1;
+    const size_t max_y = std::min(min_y + tile_size, height) - 1;
+
+    std::vector<Border_edge>& border_edges = tile_border_edges[tile];
+    border_edges.clear();
+
+    // Only the moves from the left, right and bottom border points can reach a tile with a higher index
+    for (size_t y = min_y; y <= max_y; y++)
+    {
+        for (size_t x = min_x; x <= max_x; x++)
+        {
+            if (x != min_x && x != max_x && y != max_y)
+            {
+                // Skip the inner points of the row
+                x = max_x - 1;
+                continue;
+            }
+
+            const uint16_t label = labels[x + y * width];
+            if (label == no_label)
+            {
+                continue;
+            }
+
+            const Legal_move_table::Legal_moves& legal_moves = Legal_move_table::get(bit_grid.get_neighbor_mask(x, y));
+            for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+            {
+                const uint8_t direction = legal_moves.directions[move];
+                const size_t neighbor_x = x + direction_dx[direction];
+                const size_t neighbor_y = y + direction_dy[direction];
+                const size_t neighbor_tile = get_tile(neighbor_x, neighbor_y);
+                if (neighbor_tile > tile)
+                {
+                    const Border_edge border_edge = {label,
+                                                     static_cast<uint32_t>(neighbor_tile),
+                                                     labels[neighbor_x + neighbor_y * width]};
+                    border_edges.push_back(border_edge);
+                }
+            }
+        }
+    }
+
+    // Most border points of a tile component lead to the same neighbor component, keep one edge of each
+    const auto edge_less = [](const Border_edge& a, const Border_edge& b)
+    {
+        return std::tie(a.label, a.neighbor_tile, a.neighbor_label) <
+               std::tie(b.label, b.neighbor_tile, b.neighbor_label);
+    };
+    const auto edge_equal = [](const Border_edge& a, const Border_edge& b)
+    {
+        return a.label == b.label && a.neighbor_tile == b.neighbor_tile && a.neighbor_label == b.neighbor_label;
+    };
+    std::sort(border_edges.begin(), border_edges.end(), edge_less);
+    border_edges.erase(std::unique(border_edges.begin(), border_edges.end(), edge_equal), border_edges.end());
+}
+
+void Component_index::join_components()
+{
+    const size_t number_of_tiles = tiles_x * tiles_y;
+    uint32_t number_of_tile_components = 0;
+    for (size_t tile = 0; tile < number_of_tiles; tile++)
+    {
+        tile_first_component[tile] = number_of_tile_components;
+        number_of_tile_components += tile_number_of_components[tile];
+    }
+
+    // Union-find over the tile components
+    components.resize(number_of_tile_components);
+    for (uint32_t component = 0; component < number_of_tile_components; component++)
+    {
+        components[component] = component;
+    }
+
+    for (size_t tile = 0; tile < number_of_tiles; tile++)
+    {
+        for (const Border_edge& border_edge : tile_border_edges[tile])
+        {
+            const uint32_t root = find_root(components, tile_first_component[tile] + border_edge.label);
+            const uint32_t neighbor_root = find_root(components,
+                                                     tile_first_component[border_edge.neighbor_tile] +
+                                                     border_edge.neighbor_label);
+            components[std::max(root, neighbor_root)] = std::min(root, neighbor_root);
+        }
+    }
+
+    // Point every tile component directly to its root, which is used as the component of the grid
+    for (uint32_t component = 0; component < number_of_tile_components; component++)
+    {
+        components[component] = find_root(components, component);
+    }
+}
@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_COMPONENT_INDEX_H_
+#define LINE_ROUTER_PATH_PLANNER_COMPONENT_INDEX_H_
+
+#include <Bit_grid_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The connected components of the available points of a grid, where two points are connected if there is a path of
+// legal moves between them, see Legal_move_table. The moves between available points are symmetric, so the points of
+// a component can all reach each other and no other points.
+// The grid is split into tiles of tile_size x tile_size points. The points of every tile are labelled with the
+// components of the tile on their own, i.e. only using moves inside the tile, and the moves across the tile borders
+// are kept as edges between the tile components. The tile components are then joined by the border edges with a
+// union-find to get the components of the whole grid. There are few tile components compared to points, so joining
+// them is cheap.
+// A change of the grid only affects the moves between points within one point of the change, so only the tiles that
+// overlap that area are marked as dirty. The dirty tiles are labelled again, together with the border edges to their
+// neighbors, the next time the components are updated. Blocking a path therefore costs O(path length) to mark and the
+// update only relabels the tiles along the path instead of the whole grid.
+class Component_index
+{
+public:
+    // The component of a blocked point
+    static const uint32_t no_component = UINT32_MAX;
+
+    // The width and height in points of a tile
+    static const size_t tile_size = 64;
+
+    Component_index();
+    virtual ~Component_index();
+
+    // Resize the index to the size of the bit grid and mark all tiles as dirty
+    void reset(const Bit_grid_2D& bit_grid);
+
+    // Free the labels and the tiles, the index has no points afterwards
+    void clear();
+
+    // Mark the tiles that overlap the rectangle grown by one point as dirty. The rectangle must be inside the grid.
+    void mark_dirty(const Coord_rectangle_2D& rectangle);
+
+    // Check if any tile is dirty
+    bool is_dirty() const
+    {
+        return number_of_dirty_tiles > 0;
+    }
+
+    // Label the dirty tiles again and join the tile components. The bit grid must be the same size as at the last
+    // reset.
+    void update(const Bit_grid_2D& bit_grid);
+
+    // Get the component of point x, y, or no_component if the point is blocked. Only valid when the index is not
+    // dirty. There are no range checks, x and y must be inside the grid.
+    uint32_t get_component(const size_t x, const size_t y) const
+    {
+        const uint16_t label = labels[x + y * width];
+        if (label == no_label)
+        {
+            return no_component;
+        }
+        return components[tile_first_component[get_tile(x, y)] + label];
+    }
+
+    // Number of tiles labelled by the last calls to update since the last reset, for testing the local relabelling
+    size_t get_number_of_relabelled_tiles() const
+    {
+        return number_of_relabelled_tiles;
+    }
+
+    // Get the number of bytes allocated for the labels and the tile components
+    size_t get_number_of_bytes() const;
+
+private:
+    // The label of a blocked point. A tile has at most tile_size * tile_size components so a label fits 16 bits.
+    static const uint16_t no_label = UINT16_MAX;
+
+    // A legal move from a tile component to a component of a later tile
+    struct Border_edge
+    {
+        uint16_t label;
+        uint32_t neighbor_tile;
+        uint16_t neighbor_label;
+    };
+
+    size_t width;
+    size_t height;
+    size_t tiles_x;
+    size_t tiles_y;
+
+    // The tile component label of every point, indexed by flat index
+    std::vector<uint16_t> labels;
+
+    // Per tile: the number of components, if it is dirty and the border edges to the tiles with a higher index, i.e.
+    // the tiles to the right, lower left, below and lower right
+    std::vector<uint16_t> tile_number_of_components;
+    std::vector<uint8_t> tile_dirty;
+    std::vector<std::vector<Border_edge>> tile_border_edges;
+    size_t number_of_dirty_tiles;
+    size_t number_of_relabelled_tiles;
+
+    // The index of the first component of every tile among all tile components, and the grid component of every tile
+    // component
+    std::vector<uint32_t> tile_first_component;
+    std::vector<uint32_t> components;
+
+    size_t get_tile(const size_t x, const size_t y) const
+    {
+        return x / tile_size + (y / tile_size) * tiles_x;
+    }
+
+    // Label the components of a tile with a flood fill that only uses moves inside the tile
+    void label_tile(const Bit_grid_2D& bit_grid, const size_t tile);
+
+    // Find the legal moves from the border points of a tile to the tiles with a higher index
+    void find_border_edges(const Bit_grid_2D& bit_grid, const size_t tile);
+
+    // Join the tile components with the border edges of all tiles
+    void join_components();
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_COMPONENT_INDEX_H_
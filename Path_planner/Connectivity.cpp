@@ -0,0 +1,19 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Connectivity.h>
+#include <Legal_move_table.h>
+
+// Standard library headers
+#include <array>
+
+const std::array<Legal_move_table::Legal_moves, 256> Eight_connected_strict::table =
+                               Legal_move_table::create_table(Legal_move_table::Diagonal_rule::both_sides_available);
+
+const std::array<Legal_move_table::Legal_moves, 256> Four_connected::table =
+                                  Legal_move_table::create_table(Legal_move_table::Diagonal_rule::no_diagonal_moves);
@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_CONNECTIVITY_H_
+#define LINE_ROUTER_PATH_PLANNER_CONNECTIVITY_H_
+
+#include <Legal_move_table.h>
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The connectivity policies decide which moves a path can make from a point. They are template parameters of
+// A_star_planner_specialization so the legal moves of the chosen policy are looked up without any runtime branching:
+// - Eight_connected: Horizontal, vertical and diagonal moves where a diagonal move may cut the corner of a blocked
+//   point, i.e. the rule of Legal_move_table::get used by all other planners.
+// - Eight_connected_strict: As Eight_connected but a diagonal move needs both nearest horizontal and vertical neighbors
+//   to be available.
+// - Four_connected: Horizontal and vertical moves only. The cheapest cost to the target is the Manhattan distance.
+// The legal moves are given for a neighbor mask, see Availability_grid::get_neighbor_mask. The cached legal move masks
+// of the Availability_grid can be used as neighbor masks with all policies, since a cached mask keeps the horizontal
+// and vertical neighbors and every diagonal neighbor that is legal in the stricter rules.
+
+class Eight_connected
+{
+public:
+    static const Legal_move_table::Legal_moves& get_legal_moves(const uint8_t neighbor_mask)
+    {
+        return Legal_move_table::get(neighbor_mask);
+    }
+
+    // The cheapest cost to the target of the cost model, see Cost_model.h
+    template<typename Cost_model>
+    static typename Cost_model::Cost get_cheapest_cost_to_target(const size_t dx, const size_t dy)
+    {
+        return Cost_model::get_cheapest_cost_to_target(dx, dy);
+    }
+
+    static const char* get_name()
+    {
+        return "eight connected";
+    }
+};
+
+class Eight_connected_strict
+{
+public:
+    static const Legal_move_table::Legal_moves& get_legal_moves(const uint8_t neighbor_mask)
+    {
+        return table[neighbor_mask];
+    }
+
+    // A path with fewer legal moves is never cheaper, so the estimate of the cost model still holds
+    template<typename Cost_model>
+    static typename Cost_model::Cost get_cheapest_cost_to_target(const size_t dx, const size_t dy)
+    {
+        return Cost_model::get_cheapest_cost_to_target(dx, dy);
+    }
+
+    static const char* get_name()
+    {
+        return "eight connected strict";
+    }
+
+private:
+    static const std::array<Legal_move_table::Legal_moves, 256> table;
+};
+
+class Four_connected
+{
+public:
+    static const Legal_move_table::Legal_moves& get_legal_moves(const uint8_t neighbor_mask)
+    {
+        return table[neighbor_mask];
+    }
+
+    // The Manhattan distance, which is the exact cost on an open grid without diagonal moves
+    template<typename Cost_model>
+    static typename Cost_model::Cost get_cheapest_cost_to_target(const size_t dx, const size_t dy)
+    {
+        return static_cast<typename Cost_model::Cost>(dx + dy) * Cost_model::get_straight_cost();
+    }
+
+    static const char* get_name()
+    {
+        return "four connected";
+    }
+
+private:
+    static const std::array<Legal_move_table::Legal_moves, 256> table;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_CONNECTIVITY_H_
@@ -0,0 +1,29 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_EXPANSION_TRACE_H_
+#define LINE_ROUTER_PATH_PLANNER_EXPANSION_TRACE_H_
+
+// Standard library headers
+#include <cstdint>
+#include <vector>
+
+// A point expanded by a path planning query
+struct Expanded_point
+{
+    uint32_t flat_index;
+    // The path cost from the start point (g) in units of a horizontal or vertical move, for all cost models
+    float path_cost;
+};
+
+// The points expanded by the last call to Path_planner::get_path in expansion order. It is recorded when enabled with
+// Path_planner::set_expansion_trace_enabled and, like the search statistics, only if LINE_ROUTER_SEARCH_STATISTICS is
+// compiled in, see Search_statistics.h. One entry of 8 bytes is appended per expanded point.
+typedef std::vector<Expanded_point> Expansion_trace;
+
+#endif // LINE_ROUTER_PATH_PLANNER_EXPANSION_TRACE_H_
@@ -0,0 +1,740 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Cluster_graph.h>
+#include <Availability_grid.h>
+#include <Bucket_queue.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Cost_model.h>
+#include <Legal_move_table.h>
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// The constants are passed by reference in comparisons so they need a definition
+const size_t Cluster_graph::long_entrance_length;
+
+namespace
+{
+    // The x and y step of each direction, in the order of Bit_grid_2D::Neighbor_bit
+    const std::array<int, 8> direction_dx = {{-1,  0, 1, 0, -1,  1, 1, -1}};
+    const std::array<int, 8> direction_dy = {{ 0, -1, 0, 1, -1, -1, 1,  1}};
+
+    // Get the x and y distance between two points
+    size_t get_distance(const size_t a, const size_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+
+    // Get the octile cost between two points, the cost of the cheapest path if no point is blocked
+    Cluster_graph::Cost get_octile_cost(const size_t a, const size_t b, const size_t width)
+    {
+        return Fixed_point_octile_cost_model::get_cheapest_cost_to_target(get_distance(a % width, b % width),
+                                                                          get_distance(a / width, b / width));
+    }
+}
+
+Cluster_graph::Cluster_graph(const size_t cluster_size) : cluster_size(cluster_size),
+                                                          width(0),
+                                                          height(0),
+                                                          clusters_x(0),
+                                                          clusters_y(0),
+                                                          number_of_dirty_clusters(0),
+                                                          number_of_rebuilt_clusters(0),
+                                                          local_stamp(0),
+                                                          // The cost of a neighbor is at most one diagonal move above
+                                                          // the cost of the current point
+                                                          local_points_to_visit(
+                                                                    Fixed_point_octile_cost_model::get_diagonal_cost()),
+                                                          node_stamp(0),
+                                                          number_of_expanded_nodes(0),
+                                                          abstract_path_cost(0)
+{
+    if (cluster_size < 2)
+    {
+        throw "Cluster_graph: The cluster size must be at least two";
+    }
+}
+
+Cluster_graph::~Cluster_graph()
+{
+}
+
+size_t Cluster_graph::get_cluster_size() const
+{
+    return cluster_size;
+}
+
+void Cluster_graph::reset(const Availability_grid& availability_grid)
+{
+    width = availability_grid.get_width();
+    height = availability_grid.get_height();
+    clusters_x = (width + cluster_size - 1) / cluster_size;
+    clusters_y = (height + cluster_size - 1) / cluster_size;
+
+    const size_t number_of_clusters = clusters_x * clusters_y;
+    nodes.clear();
+    free_nodes.clear();
+    removed_nodes.clear();
+    clusters.assign(number_of_clusters, Cluster());
+    cluster_dirty.assign(number_of_clusters, 1);
+    cluster_rebuild.assign(number_of_clusters, 0);
+    number_of_dirty_clusters = number_of_clusters;
+    number_of_rebuilt_clusters = 0;
+
+    const size_t points_per_cluster = cluster_size * cluster_size;
+    local_costs.assign(points_per_cluster, 0);
+    local_visited.assign(points_per_cluster, 0);
+    local_closed.assign(points_per_cluster, 0);
+    local_targets.assign(points_per_cluster, 0);
+    local_stamp = 0;
+}
+
+void Cluster_graph::mark_dirty(const Coord_rectangle_2D& rectangle)
+{
+    if (rectangle.is_empty())
+    {
+        return;
+    }
+
+    // The moves of the points next to a changed point may change too
+    const size_t min_cluster_x = (rectangle.get_min_x() > 0 ? rectangle.get_min_x() - 1 : 0) / cluster_size;
+    const size_t min_cluster_y = (rectangle.get_min_y() > 0 ? rectangle.get_min_y() - 1 : 0) / cluster_size;
+    const size_t max_cluster_x = std::min(rectangle.get_max_x() + 1, width - 1) / cluster_size;
+    const size_t max_cluster_y = std::min(rectangle.get_max_y() + 1, height - 1) / cluster_size;
+
+    for (size_t cluster_y = min_cluster_y; cluster_y <= max_cluster_y; cluster_y++)
+    {
+        for (size_t cluster_x = min_cluster_x; cluster_x <= max_cluster_x; cluster_x++)
+        {
+            uint8_t& dirty = cluster_dirty[cluster_x + cluster_y * clusters_x];
+            if (not dirty)
+            {
+                dirty = 1;
+                number_of_dirty_clusters++;
+            }
+        }
+    }
+}
+
+void Cluster_graph::update(const Availability_grid& availability_grid)
+{
+    if (number_of_dirty_clusters == 0)
+    {
+        return;
+    }
+
+    // The transitions of a border are found again if the cluster on either side is dirty. A cluster needs new edges if
+    // it is dirty or if a border of it got new transitions.
+    const size_t number_of_clusters = clusters_x * clusters_y;
+    cluster_rebuild = cluster_dirty;
+    for (size_t cluster = 0; cluster < number_of_clusters; cluster++)
+    {
+        const size_t right_cluster = cluster + 1;
+        if (cluster % clusters_x + 1 < clusters_x && (cluster_dirty[cluster] || cluster_dirty[right_cluster]) &&
+            find_transitions(availability_grid, cluster, true))
+        {
+            cluster_rebuild[cluster] = 1;
+            cluster_rebuild[right_cluster] = 1;
+        }
+
+        const size_t lower_cluster = cluster + clusters_x;
+        if (lower_cluster < number_of_clusters && (cluster_dirty[cluster] || cluster_dirty[lower_cluster]) &&
+            find_transitions(availability_grid, cluster, false))
+        {
+            cluster_rebuild[cluster] = 1;
+            cluster_rebuild[lower_cluster] = 1;
+        }
+    }
+
+    for (size_t cluster = 0; cluster < number_of_clusters; cluster++)
+    {
+        if (cluster_rebuild[cluster])
+        {
+            find_edges(availability_grid, cluster);
+            number_of_rebuilt_clusters++;
+        }
+    }
+
+    free_nodes.insert(free_nodes.end(), removed_nodes.begin(), removed_nodes.end());
+    removed_nodes.clear();
+
+    std::fill(cluster_dirty.begin(), cluster_dirty.end(), 0);
+    number_of_dirty_clusters = 0;
+}
+
+bool Cluster_graph::find_abstract_path(const Availability_grid& availability_grid,
+                                       const Coord_point_2D& start,
+                                       const Coord_point_2D& end,
+                                       std::vector<size_t>& path_clusters)
+{
+    update(availability_grid);
+
+    path_clusters.clear();
+    number_of_expanded_nodes = 0;
+    abstract_path_cost = 0;
+
+    const size_t start_index = start.get_flat_index(width);
+    const size_t end_index = end.get_flat_index(width);
+    const size_t start_cluster = get_cluster(start.get_x(), start.get_y());
+    const size_t end_cluster = get_cluster(end.get_x(), end.get_y());
+
+    // The start and end points are the two last nodes
+    const uint32_t start_node = static_cast<uint32_t>(nodes.size());
+    const uint32_t end_node = start_node + 1;
+    start_new_abstract_search(nodes.size() + 2);
+
+    // Join the start point to the nodes of its cluster, and to the end point if it is in the same cluster
+    start_edges.clear();
+    join_start_point(availability_grid, start_cluster, start_index, 0, end_index, end_node);
+
+    // A blocked start point is not on any entrance, since the transitions are between available points, but it can
+    // still move into the clusters next to it. Join it to those clusters through the points it can move to.
+    if (not availability_grid.is_available(start_index))
+    {
+        const Legal_move_table::Legal_moves& legal_moves =
+                             Legal_move_table::get(availability_grid.get_legal_move_mask(start.get_x(), start.get_y()));
+        for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+        {
+            const uint8_t direction = legal_moves.directions[move];
+            const size_t neighbor_x = start.get_x() + direction_dx[direction];
+            const size_t neighbor_y = start.get_y() + direction_dy[direction];
+            const size_t neighbor_cluster = get_cluster(neighbor_x, neighbor_y);
+            if (neighbor_cluster != start_cluster)
+            {
+                const Cost move_cost = Legal_move_table::is_diagonal(direction)
+                                     ? Fixed_point_octile_cost_model::get_diagonal_cost()
+                                     : Fixed_point_octile_cost_model::get_straight_cost();
+                join_start_point(availability_grid, neighbor_cluster, neighbor_x + neighbor_y * width, move_cost,
+                                 end_index, end_node);
+            }
+        }
+    }
+
+    // Join the nodes of the end cluster to the end point. The moves between available points are symmetric, so the
+    // costs from the end point are the costs to it.
+    std::vector<size_t> targets;
+    Cost cost = 0;
+    get_cluster_nodes(end_cluster, cluster_nodes);
+    for (const uint32_t node : cluster_nodes)
+    {
+        targets.push_back(nodes[node].flat_index);
+    }
+    search_cluster(availability_grid, end_cluster, end_index, targets);
+    for (const uint32_t node : cluster_nodes)
+    {
+        if (get_local_cost(end_cluster, nodes[node].flat_index, cost))
+        {
+            node_end_costs[node] = cost;
+            node_end_visited[node] = node_stamp;
+        }
+    }
+
+    // A* on the abstract graph. The octile cost to the end point is a consistent estimate since no edge is cheaper
+    // than the octile cost between its nodes.
+    const auto get_total_cost = [&](const uint32_t node, const Cost path_cost) -> Cost
+    {
+        if (node == end_node)
+        {
+            return path_cost;
+        }
+        const size_t flat_index = node == start_node ? start_index : nodes[node].flat_index;
+        return path_cost + get_octile_cost(flat_index, end_index, width);
+    };
+
+    const auto update_node = [&](const uint32_t node, const uint32_t previous, const Cost path_cost)
+    {
+        if (node_visited[node] != node_stamp || path_cost < node_costs[node])
+        {
+            node_visited[node] = node_stamp;
+            node_costs[node] = path_cost;
+            node_previous[node] = previous;
+            nodes_to_visit.push_back(std::make_pair(get_total_cost(node, path_cost), node));
+            std::push_heap(nodes_to_visit.begin(), nodes_to_visit.end(), std::greater<std::pair<Cost, uint32_t>>());
+        }
+    };
+
+    nodes_to_visit.clear();
+    update_node(start_node, start_node, 0);
+
+    bool path_found = false;
+    while (not nodes_to_visit.empty())
+    {
+        const std::pair<Cost, uint32_t> cheapest = nodes_to_visit.front();
+        std::pop_heap(nodes_to_visit.begin(), nodes_to_visit.end(), std::greater<std::pair<Cost, uint32_t>>());
+        nodes_to_visit.pop_back();
+
+        const uint32_t current_node = cheapest.second;
+        if (cheapest.first > get_total_cost(current_node, node_costs[current_node]))
+        {
+            // An old entry of a node that has been pushed again with a lower cost
+            continue;
+        }
+
+        number_of_expanded_nodes++;
+        if (current_node == end_node)
+        {
+            path_found = true;
+            break;
+        }
+
+        const Cost current_cost = node_costs[current_node];
+        const std::vector<Edge>& edges = current_node == start_node ? start_edges : nodes[current_node].edges;
+        for (const Edge& edge : edges)
+        {
+            update_node(edge.node, current_node, current_cost + edge.cost);
+        }
+
+        if (current_node != start_node && node_end_visited[current_node] == node_stamp)
+        {
+            update_node(end_node, current_node, current_cost + node_end_costs[current_node]);
+        }
+    }
+
+    if (not path_found)
+    {
+        return false;
+    }
+
+    // Collect the clusters from the end point back to the start point
+    abstract_path_cost = node_costs[end_node];
+    path_clusters.push_back(end_cluster);
+    for (uint32_t node = node_previous[end_node]; node != start_node; node = node_previous[node])
+    {
+        const size_t cluster = get_cluster(nodes[node].flat_index % width, nodes[node].flat_index / width);
+        if (cluster != path_clusters.back())
+        {
+            path_clusters.push_back(cluster);
+        }
+    }
+    if (start_cluster != path_clusters.back())
+    {
+        path_clusters.push_back(start_cluster);
+    }
+    std::reverse(path_clusters.begin(), path_clusters.end());
+
+    return true;
+}
+
+size_t Cluster_graph::get_number_of_clusters() const
+{
+    return clusters_x * clusters_y;
+}
+
+size_t Cluster_graph::get_number_of_bytes() const
+{
+    size_t number_of_bytes = nodes.capacity() * sizeof(Node) + clusters.capacity() * sizeof(Cluster)
+                             + (free_nodes.capacity() + removed_nodes.capacity()) * sizeof(uint32_t)
+                             + (cluster_dirty.capacity() + cluster_rebuild.capacity()) * sizeof(uint8_t)
+                             + local_costs.capacity() * sizeof(Cost)
+                             + (local_visited.capacity() + local_closed.capacity() + local_targets.capacity())
+                               * sizeof(uint32_t)
+                             + (node_costs.capacity() + node_end_costs.capacity()) * sizeof(Cost)
+                             + (node_previous.capacity() + node_visited.capacity() + node_end_visited.capacity()
+                                + cluster_nodes.capacity()) * sizeof(uint32_t)
+                             + start_edges.capacity() * sizeof(Edge);
+    for (const Node& node : nodes)
+    {
+        number_of_bytes += node.edges.capacity() * sizeof(Edge);
+    }
+    for (const Cluster& cluster : clusters)
+    {
+        number_of_bytes += (cluster.right_transitions.capacity() + cluster.lower_transitions.capacity())
+                           * sizeof(Transition);
+    }
+    return number_of_bytes;
+}
+
+size_t Cluster_graph::get_number_of_nodes() const
+{
+    return nodes.size() - free_nodes.size() - removed_nodes.size();
+}
+
+size_t Cluster_graph::get_number_of_rebuilt_clusters() const
+{
+    return number_of_rebuilt_clusters;
+}
+
+size_t Cluster_graph::get_number_of_expanded_nodes() const
+{
+    return number_of_expanded_nodes;
+}
+
+Cluster_graph::Cost Cluster_graph::get_abstract_path_cost() const
+{
+    return abstract_path_cost;
+}
+
+Coord_rectangle_2D Cluster_graph::get_cluster_rectangle(const size_t cluster) const
+{
+    const size_t min_x = (cluster % clusters_x) * cluster_size;
+    const size_t min_y = (cluster / clusters_x) * cluster_size;
+    return Coord_rectangle_2D(min_x,
+                              min_y,
+                              std::min(min_x + cluster_size, width) - 1,
+                              std::min(min_y + cluster_size, height) - 1);
+}
+
+void Cluster_graph::get_cluster_nodes(const size_t cluster, std::vector<uint32_t>& nodes_of_cluster) const
+{
+    nodes_of_cluster.clear();
+    for (const Transition& transition : clusters[cluster].right_transitions)
+    {
+        nodes_of_cluster.push_back(transition.node);
+    }
+    for (const Transition& transition : clusters[cluster].lower_transitions)
+    {
+        nodes_of_cluster.push_back(transition.node);
+    }
+    if (cluster % clusters_x > 0)
+    {
+        for (const Transition& transition : clusters[cluster - 1].right_transitions)
+        {
+            nodes_of_cluster.push_back(transition.neighbor_node);
+        }
+    }
+    if (cluster >= clusters_x)
+    {
+        for (const Transition& transition : clusters[cluster - clusters_x].lower_transitions)
+        {
+            nodes_of_cluster.push_back(transition.neighbor_node);
+        }
+    }
+}
+
+bool Cluster_graph::find_transitions(const Availability_grid& availability_grid,
+                                     const size_t cluster,
+                                     const bool right)
+{
+    // The border points of the cluster and the step over the border to the neighbor cluster
+    const Coord_rectangle_2D rectangle = get_cluster_rectangle(cluster);
+    const size_t border_length = right ? rectangle.get_height() : rectangle.get_width();
+    const size_t first_index = right ? rectangle.get_max_x() + rectangle.get_min_y() * width
+                                     : rectangle.get_min_x() + rectangle.get_max_y() * width;
+    const size_t along_step = right ? width : 1;
+    const size_t across_step = right ? 1 : width;
+
+    // Find the runs of available point pairs across the border and put the transitions at their middle or ends
+    std::vector<size_t> transition_indices;
+    size_t run_length = 0;
+    for (size_t i = 0; i <= border_length; i++)
+    {
+        const size_t flat_index = first_index + i * along_step;
+        if (i < border_length && availability_grid.is_available(flat_index) &&
+            availability_grid.is_available(flat_index + across_step))
+        {
+            run_length++;
+            continue;
+        }
+
+        if (run_length > 0)
+        {
+            const size_t run_first = flat_index - run_length * along_step;
+            const size_t run_last = flat_index - along_step;
+            if (run_length < long_entrance_length)
+            {
+                transition_indices.push_back(run_first + (run_length / 2) * along_step);
+            }
+            else
+            {
+                transition_indices.push_back(run_first);
+                transition_indices.push_back(run_last);
+            }
+        }
+        run_length = 0;
+    }
+
+    std::vector<Transition>& transitions = right ? clusters[cluster].right_transitions
+                                                 : clusters[cluster].lower_transitions;
+    if (transitions.size() == transition_indices.size())
+    {
+        bool changed = false;
+        for (size_t i = 0; i < transitions.size(); i++)
+        {
+            changed = changed || nodes[transitions[i].node].flat_index != transition_indices[i];
+        }
+        if (not changed)
+        {
+            // The nodes and the edges to them are still valid
+            return false;
+        }
+    }
+
+    for (const Transition& transition : transitions)
+    {
+        remove_node(transition.node);
+        remove_node(transition.neighbor_node);
+    }
+    transitions.clear();
+
+    for (const size_t flat_index : transition_indices)
+    {
+        const Transition transition = {add_node(flat_index), add_node(flat_index + across_step)};
+        const Edge edge = {transition.neighbor_node, Fixed_point_octile_cost_model::get_straight_cost()};
+        const Edge reverse_edge = {transition.node, Fixed_point_octile_cost_model::get_straight_cost()};
+        nodes[transition.node].edges.push_back(edge);
+        nodes[transition.neighbor_node].edges.push_back(reverse_edge);
+        transitions.push_back(transition);
+    }
+
+    return true;
+}
+
+void Cluster_graph::find_edges(const Availability_grid& availability_grid, const size_t cluster)
+{
+    std::vector<uint32_t> nodes_of_cluster;
+    get_cluster_nodes(cluster, nodes_of_cluster);
+
+    // Remove the old edges inside the cluster, the edges across the borders are kept
+    for (const uint32_t node : nodes_of_cluster)
+    {
+        std::vector<Edge>& edges = nodes[node].edges;
+        edges.erase(std::remove_if(edges.begin(),
+                                   edges.end(),
+                                   [&](const Edge& edge)
+                                   {
+                                       const size_t flat_index = nodes[edge.node].flat_index;
+                                       return get_cluster(flat_index % width, flat_index / width) == cluster;
+                                   }),
+                    edges.end());
+    }
+
+    // If all points of the cluster are available the cheapest path between two points is the octile cost
+    const Coord_rectangle_2D rectangle = get_cluster_rectangle(cluster);
+    bool open = true;
+    for (size_t y = rectangle.get_min_y(); y <= rectangle.get_max_y() && open; y++)
+    {
+        for (size_t x = rectangle.get_min_x(); x <= rectangle.get_max_x() && open; x++)
+        {
+            open = availability_grid.is_available(x, y);
+        }
+    }
+
+    // The costs are symmetric so every pair of nodes is only searched once
+    std::vector<size_t> targets;
+    for (size_t i = 0; i < nodes_of_cluster.size(); i++)
+    {
+        const uint32_t node = nodes_of_cluster[i];
+        const size_t flat_index = nodes[node].flat_index;
+        if (not open)
+        {
+            targets.clear();
+            for (size_t j = i + 1; j < nodes_of_cluster.size(); j++)
+            {
+                targets.push_back(nodes[nodes_of_cluster[j]].flat_index);
+            }
+            search_cluster(availability_grid, cluster, flat_index, targets);
+        }
+
+        for (size_t j = i + 1; j < nodes_of_cluster.size(); j++)
+        {
+            const uint32_t other_node = nodes_of_cluster[j];
+            const size_t other_flat_index = nodes[other_node].flat_index;
+            Cost cost = get_octile_cost(flat_index, other_flat_index, width);
+            if (open || get_local_cost(cluster, other_flat_index, cost))
+            {
+                const Edge edge = {other_node, cost};
+                const Edge reverse_edge = {node, cost};
+                nodes[node].edges.push_back(edge);
+                nodes[other_node].edges.push_back(reverse_edge);
+            }
+        }
+    }
+}
+
+void Cluster_graph::join_start_point(const Availability_grid& availability_grid,
+                                     const size_t cluster,
+                                     const size_t origin,
+                                     const Cost origin_cost,
+                                     const size_t end_index,
+                                     const uint32_t end_node)
+{
+    const bool end_in_cluster = get_cluster(end_index % width, end_index / width) == cluster;
+    std::vector<size_t> targets;
+    get_cluster_nodes(cluster, cluster_nodes);
+    for (const uint32_t node : cluster_nodes)
+    {
+        targets.push_back(nodes[node].flat_index);
+    }
+    if (end_in_cluster)
+    {
+        targets.push_back(end_index);
+    }
+    search_cluster(availability_grid, cluster, origin, targets);
+
+    Cost cost = 0;
+    for (const uint32_t node : cluster_nodes)
+    {
+        if (get_local_cost(cluster, nodes[node].flat_index, cost))
+        {
+            const Edge edge = {node, origin_cost + cost};
+            start_edges.push_back(edge);
+        }
+    }
+    if (end_in_cluster && get_local_cost(cluster, end_index, cost))
+    {
+        const Edge edge = {end_node, origin_cost + cost};
+        start_edges.push_back(edge);
+    }
+}
+
+void Cluster_graph::search_cluster(const Availability_grid& availability_grid,
+                                   const size_t cluster,
+                                   const size_t origin,
+                                   const std::vector<size_t>& targets)
+{
+    local_stamp++;
+    if (local_stamp == 0)
+    {
+        // The stamp has wrapped around, clear the old stamps so that no point looks visited
+        std::fill(local_visited.begin(), local_visited.end(), 0);
+        std::fill(local_closed.begin(), local_closed.end(), 0);
+        std::fill(local_targets.begin(), local_targets.end(), 0);
+        local_stamp = 1;
+    }
+
+    // Count the distinct targets so the search can stop when all of them are closed
+    size_t number_of_targets = 0;
+    for (const size_t target : targets)
+    {
+        uint32_t& target_stamp = local_targets[get_local_index(cluster, target)];
+        if (target_stamp != local_stamp)
+        {
+            target_stamp = local_stamp;
+            number_of_targets++;
+        }
+    }
+
+    const Coord_rectangle_2D rectangle = get_cluster_rectangle(cluster);
+    local_points_to_visit.clear();
+    local_points_to_visit.push(origin, 0);
+    local_costs[get_local_index(cluster, origin)] = 0;
+    local_visited[get_local_index(cluster, origin)] = local_stamp;
+
+    // Dijkstra search, the targets are not known in advance when joining the start point so no estimate is used
+    while (number_of_targets > 0 && not local_points_to_visit.empty())
+    {
+        const size_t current_index = local_points_to_visit.top();
+        local_points_to_visit.pop();
+
+        const size_t current_local_index = get_local_index(cluster, current_index);
+        if (local_closed[current_local_index] == local_stamp)
+        {
+            // An old entry of a point that has been pushed again with a lower cost
+            continue;
+        }
+        local_closed[current_local_index] = local_stamp;
+
+        if (local_targets[current_local_index] == local_stamp)
+        {
+            number_of_targets--;
+        }
+
+        const size_t x = current_index % width;
+        const size_t y = current_index / width;
+        const Cost current_cost = local_costs[current_local_index];
+        const Legal_move_table::Legal_moves& legal_moves =
+                                               Legal_move_table::get(availability_grid.get_legal_move_mask(x, y));
+        for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+        {
+            const uint8_t direction = legal_moves.directions[move];
+            const size_t neighbor_x = x + direction_dx[direction];
+            const size_t neighbor_y = y + direction_dy[direction];
+            if (neighbor_x < rectangle.get_min_x() || neighbor_x > rectangle.get_max_x() ||
+                neighbor_y < rectangle.get_min_y() || neighbor_y > rectangle.get_max_y())
+            {
+                // Only moves inside the cluster are used
+                continue;
+            }
+
+            const size_t neighbor_index = neighbor_x + neighbor_y * width;
+            const size_t neighbor_local_index = get_local_index(cluster, neighbor_index);
+            const Cost cost = current_cost + (Legal_move_table::is_diagonal(direction)
+                                                              ? Fixed_point_octile_cost_model::get_diagonal_cost()
+                                                              : Fixed_point_octile_cost_model::get_straight_cost());
+            if (local_visited[neighbor_local_index] != local_stamp || cost < local_costs[neighbor_local_index])
+            {
+                local_visited[neighbor_local_index] = local_stamp;
+                local_costs[neighbor_local_index] = cost;
+                local_points_to_visit.push(neighbor_index, cost);
+            }
+        }
+    }
+}
+
+bool Cluster_graph::get_local_cost(const size_t cluster, const size_t flat_index, Cost& cost) const
+{
+    const size_t local_index = get_local_index(cluster, flat_index);
+    if (local_closed[local_index] != local_stamp)
+    {
+        return false;
+    }
+
+    cost = local_costs[local_index];
+    return true;
+}
+
+size_t Cluster_graph::get_local_index(const size_t cluster, const size_t flat_index) const
+{
+    const size_t local_x = flat_index % width - (cluster % clusters_x) * cluster_size;
+    const size_t local_y = flat_index / width - (cluster / clusters_x) * cluster_size;
+    return local_x + local_y * cluster_size;
+}
+
+uint32_t Cluster_graph::add_node(const size_t flat_index)
+{
+    uint32_t node = static_cast<uint32_t>(nodes.size());
+    if (free_nodes.empty())
+    {
+        nodes.push_back(Node());
+    }
+    else
+    {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+    }
+
+    nodes[node].flat_index = flat_index;
+    nodes[node].edges.clear();
+    return node;
+}
+
+void Cluster_graph::remove_node(const uint32_t node)
+{
+    // The edges to the node are removed when the edges of its cluster are searched again, see removed_nodes
+    nodes[node].edges.clear();
+    removed_nodes.push_back(node);
+}
+
+void Cluster_graph::start_new_abstract_search(const size_t size)
+{
+    if (node_visited.size() < size)
+    {
+        node_costs.resize(size);
+        node_previous.resize(size);
+        node_visited.resize(size, 0);
+        node_end_costs.resize(size);
+        node_end_visited.resize(size, 0);
+    }
+
+    node_stamp++;
+    if (node_stamp == 0)
+    {
+        // The stamp has wrapped around, clear the old stamps so that no node looks visited
+        std::fill(node_visited.begin(), node_visited.end(), 0);
+        std::fill(node_end_visited.begin(), node_end_visited.end(), 0);
+        node_stamp = 1;
+    }
+}
@@ -0,0 +1,205 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_HPA_STAR_CLUSTER_GRAPH_H_
+#define LINE_ROUTER_PATH_PLANNER_HPA_STAR_CLUSTER_GRAPH_H_
+
+#include <Availability_grid.h>
+#include <Bucket_queue.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// The abstract graph of the HPA_star_planner. The grid is split into clusters of cluster_size x cluster_size points.
+// Where two clusters next to each other have available points on both sides of their border, the border points are
+// grouped into entrances, i.e. runs of pairs of available points next to each other across the border. An entrance
+// gets one transition in the middle, or two at its ends if it is long, and a transition is a node on each side of the
+// border joined by a horizontal or vertical move. The nodes of a cluster are joined by edges with the cost of the
+// cheapest path between them that stays inside the cluster.
+// Every move across a border from or to a point in a cluster next to it passes an entrance, also the diagonal ones
+// since one of the two points next to a legal diagonal move is available, so the abstract graph connects the same
+// points as the grid. The abstract path is not always the cheapest, since it must pass the border at a transition.
+// The costs are the fixed point costs of Fixed_point_octile_cost_model.
+// A change of the grid only affects the moves within one point of the change, so only the clusters that overlap that
+// area are marked as dirty. The entrances on the borders of the dirty clusters are found again, and the edges inside
+// the dirty clusters and the clusters that got new nodes on their borders are searched again, the next time the graph
+// is updated. The other clusters are not touched.
+class Cluster_graph
+{
+public:
+    typedef uint32_t Cost;
+
+    // The cluster size must be at least two
+    explicit Cluster_graph(const size_t cluster_size);
+    virtual ~Cluster_graph();
+
+    size_t get_cluster_size() const;
+
+    // Resize the graph to the size of the availability grid and mark all clusters as dirty
+    void reset(const Availability_grid& availability_grid);
+
+    // Mark the clusters that overlap the rectangle grown by one point as dirty. The rectangle must be inside the grid.
+    void mark_dirty(const Coord_rectangle_2D& rectangle);
+
+    // Check if any cluster is dirty
+    bool is_dirty() const
+    {
+        return number_of_dirty_clusters > 0;
+    }
+
+    // Find the entrances and the edges of the dirty clusters again. The availability grid must be the same size as at
+    // the last reset.
+    void update(const Availability_grid& availability_grid);
+
+    // Find the cheapest abstract path from start to end, after updating the dirty clusters. The start and end points
+    // are joined to the nodes of their clusters for this query only. The clusters the path passes are returned in path
+    // order. The end point must be available. Returns false if there is no path.
+    bool find_abstract_path(const Availability_grid& availability_grid,
+                            const Coord_point_2D& start,
+                            const Coord_point_2D& end,
+                            std::vector<size_t>& path_clusters);
+
+    // Get the cluster of point x, y. There are no range checks.
+    size_t get_cluster(const size_t x, const size_t y) const
+    {
+        return x / cluster_size + (y / cluster_size) * clusters_x;
+    }
+
+    size_t get_number_of_clusters() const;
+
+    // Number of nodes in the graph, not counting the start and end points
+    size_t get_number_of_nodes() const;
+
+    // Number of clusters whose edges have been searched by the calls to update since the last reset
+    size_t get_number_of_rebuilt_clusters() const;
+
+    // Number of nodes expanded by the last call to find_abstract_path and the cost of the path it found
+    size_t get_number_of_expanded_nodes() const;
+    Cost get_abstract_path_cost() const;
+
+    // Number of bytes allocated for the nodes, edges, clusters and the per node and per cluster point scratch. The
+    // queues of the searches are not counted.
+    size_t get_number_of_bytes() const;
+
+private:
+    // An entrance of at least this many point pairs gets a transition at each end instead of one in the middle
+    static const size_t long_entrance_length = 6;
+
+    struct Edge
+    {
+        uint32_t node;
+        Cost cost;
+    };
+
+    struct Node
+    {
+        size_t flat_index;
+        std::vector<Edge> edges;
+    };
+
+    // The two nodes of a transition across the border to the cluster to the right or below. The first node is in the
+    // cluster that keeps the transition.
+    struct Transition
+    {
+        uint32_t node;
+        uint32_t neighbor_node;
+    };
+
+    struct Cluster
+    {
+        std::vector<Transition> right_transitions;
+        std::vector<Transition> lower_transitions;
+    };
+
+    size_t cluster_size;
+    size_t width;
+    size_t height;
+    size_t clusters_x;
+    size_t clusters_y;
+
+    // The nodes are reused through the list of free nodes when the transitions of a border change. The removed nodes
+    // are only freed at the end of an update, since the edges to them are removed when their cluster gets new edges.
+    std::vector<Node> nodes;
+    std::vector<uint32_t> free_nodes;
+    std::vector<uint32_t> removed_nodes;
+
+    std::vector<Cluster> clusters;
+    std::vector<uint8_t> cluster_dirty;
+    std::vector<uint8_t> cluster_rebuild;
+    size_t number_of_dirty_clusters;
+    size_t number_of_rebuilt_clusters;
+
+    // The scratch of the searches inside one cluster, indexed by the point index inside the cluster. The points are
+    // stamped per search like in Search_state_grid, so nothing needs to be cleared between the searches.
+    std::vector<Cost> local_costs;
+    std::vector<uint32_t> local_visited;
+    std::vector<uint32_t> local_closed;
+    std::vector<uint32_t> local_targets;
+    uint32_t local_stamp;
+    Bucket_queue local_points_to_visit;
+
+    // The scratch of the abstract search, indexed by node. The start and end points are the two last nodes.
+    std::vector<Cost> node_costs;
+    std::vector<uint32_t> node_previous;
+    std::vector<uint32_t> node_visited;
+    std::vector<Cost> node_end_costs;
+    std::vector<uint32_t> node_end_visited;
+    uint32_t node_stamp;
+    std::vector<Edge> start_edges;
+    std::vector<std::pair<Cost, uint32_t>> nodes_to_visit;
+    std::vector<uint32_t> cluster_nodes;
+    size_t number_of_expanded_nodes;
+    Cost abstract_path_cost;
+
+    // Get the rectangle of the points of a cluster
+    Coord_rectangle_2D get_cluster_rectangle(const size_t cluster) const;
+
+    // Get the nodes of a cluster from the transitions on its four borders
+    void get_cluster_nodes(const size_t cluster, std::vector<uint32_t>& nodes_of_cluster) const;
+
+    // Find the transitions on the border to the cluster to the right or below again. Returns true if they changed.
+    bool find_transitions(const Availability_grid& availability_grid, const size_t cluster, const bool right);
+
+    // Search the cheapest paths between all nodes of a cluster that stay inside the cluster
+    void find_edges(const Availability_grid& availability_grid, const size_t cluster);
+
+    // Search the cheapest costs from a point to the targets in its cluster with moves that stay inside the cluster.
+    // The costs are read with get_local_cost until the next search.
+    void search_cluster(const Availability_grid& availability_grid,
+                        const size_t cluster,
+                        const size_t origin,
+                        const std::vector<size_t>& targets);
+
+    // Join the start point to the nodes of a cluster, and to the end point if it is in the cluster, through a point of
+    // the cluster that the start point reaches at origin_cost. The edges are added to start_edges.
+    void join_start_point(const Availability_grid& availability_grid,
+                          const size_t cluster,
+                          const size_t origin,
+                          const Cost origin_cost,
+                          const size_t end_index,
+                          const uint32_t end_node);
+
+    // Get the cost from the origin of the last cluster search, or no cost if the point was not reached
+    bool get_local_cost(const size_t cluster, const size_t flat_index, Cost& cost) const;
+
+    // Get the index of a point inside its cluster
+    size_t get_local_index(const size_t cluster, const size_t flat_index) const;
+
+    uint32_t add_node(const size_t flat_index);
+    void remove_node(const uint32_t node);
+
+    // Start a new search of the abstract graph with size number of nodes
+    void start_new_abstract_search(const size_t size);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_HPA_STAR_CLUSTER_GRAPH_H_
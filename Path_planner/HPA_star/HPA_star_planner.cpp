@@ -0,0 +1,435 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <HPA_star_planner.h>
+#include <A_star_planner.h>
+#include <Cluster_graph.h>
+#include <Coord_rectangle_2D.h>
+#include <Cost_model.h>
+#include <Cost_point_2D.h>
+#include <Bucket_queue.h>
+#include <Indexed_d_ary_heap.h>
+#include <Flat_point_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The constants are passed by reference in comparisons so they need a definition
+const size_t HPA_star_planner::default_cluster_size;
+
+namespace
+{
+    // Add a point to the points to visit or lower its cost if it is already there, see A_star_planner
+    void update_points_to_visit(Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit,
+                                const size_t flat_index,
+                                const float total_cost,
+                                const bool is_in_points_to_visit)
+    {
+        const Cost_point_2D cost_point(flat_index, total_cost);
+        if (is_in_points_to_visit)
+        {
+            points_to_visit.decrease_cost(cost_point);
+        }
+        else
+        {
+            points_to_visit.push(cost_point);
+        }
+    }
+
+    void update_points_to_visit(Bucket_queue& points_to_visit,
+                                const size_t flat_index,
+                                const uint32_t total_cost,
+                                const bool)
+    {
+        points_to_visit.push(flat_index, total_cost);
+    }
+
+    // Get the flat index of the point with the lowest total cost
+    size_t get_cheapest_point_to_visit(const Indexed_d_ary_heap<Search_state_grid, 4>& points_to_visit)
+    {
+        return points_to_visit.top().get_flat_index();
+    }
+
+    size_t get_cheapest_point_to_visit(const Bucket_queue& points_to_visit)
+    {
+        return points_to_visit.top();
+    }
+
+    // Get the number of bytes of one entry in the points to visit
+    size_t get_bytes_per_entry(const Indexed_d_ary_heap<Search_state_grid, 4>&)
+    {
+        return sizeof(Cost_point_2D);
+    }
+
+    size_t get_bytes_per_entry(const Bucket_queue&)
+    {
+        return sizeof(size_t);
+    }
+
+    // Get the x and y distance between two points
+    size_t get_distance(const size_t a, const size_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+}
+
+HPA_star_planner::HPA_star_planner(std::shared_ptr<Availability_grid> availability_grid, const size_t cluster_size) :
+                                                                                A_star_planner(availability_grid),
+                                                                                cluster_graph(cluster_size),
+                                                                                cluster_graph_outdated(true),
+                                                                                number_of_grid_changes(0)
+{
+}
+
+HPA_star_planner::HPA_star_planner(const size_t width, const size_t height, const size_t cluster_size) :
+                                    HPA_star_planner(std::make_shared<Availability_grid>(width, height), cluster_size)
+{
+}
+
+HPA_star_planner::~HPA_star_planner()
+{
+}
+
+bool HPA_star_planner::get_path(const Coord_point_2D& start,
+                                const Coord_point_2D& end,
+                                std::vector<Coord_point_2D>& path)
+{
+    const bool collect_statistics = is_collecting_search_statistics();
+    const bool instrumented = collect_statistics || is_recording_expansion_trace();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect_statistics);
+
+    if (not check_end_points(start, end))
+    {
+        return false;
+    }
+
+    // Clear the points to visit and their counters
+    points_to_visit.clear();
+    fixed_point_points_to_visit.clear();
+
+    if (start == end)
+    {
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
+    }
+
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_available(end.get_x(), end.get_y()))
+    {
+        // A move always goes to an available point, so a blocked end point can not be reached. The search from the end
+        // point inside its cluster would otherwise leave it.
+        print_failure(start, end);
+        return false;
+    }
+
+    if (not availability_grid->is_reachable(start, end))
+    {
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
+        return false;
+    }
+
+    // Build the abstract graph again if the availability grid has been changed directly. Otherwise only the dirty
+    // clusters are updated by find_abstract_path.
+    if (cluster_graph_outdated || availability_grid->get_number_of_changes() != number_of_grid_changes)
+    {
+        cluster_graph.reset(*availability_grid);
+        in_corridor.assign(cluster_graph.get_number_of_clusters(), 0);
+        cluster_graph_outdated = false;
+        number_of_grid_changes = availability_grid->get_number_of_changes();
+    }
+
+    // Start a new query, this will mark all points as unvisited with an infinite path cost without touching the grid
+    search_state_grid.start_new_query();
+
+    if (collect_statistics)
+    {
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
+    }
+
+    const std::chrono::steady_clock::time_point abstract_start_time = get_statistics_time(collect_statistics);
+    if (not cluster_graph.find_abstract_path(*availability_grid, start, end, corridor_clusters))
+    {
+        print_failure(start, end);
+        return false;
+    }
+    const double abstract_time_ms = collect_statistics ? get_statistics_time_ms_since(abstract_start_time) : 0;
+
+    for (const size_t cluster : corridor_clusters)
+    {
+        in_corridor[cluster] = 1;
+    }
+
+    bool path_found = false;
+    switch (cost_mode)
+    {
+        case Cost_mode::floating_point:
+            path_found = instrumented
+                                   ? refine<Floating_point_cost_model, true>(start, end, points_to_visit, path)
+                                   : refine<Floating_point_cost_model, false>(start, end, points_to_visit, path);
+            break;
+        case Cost_mode::fixed_point_octile:
+            path_found = instrumented
+                       ? refine<Fixed_point_octile_cost_model, true>(start, end, fixed_point_points_to_visit, path)
+                       : refine<Fixed_point_octile_cost_model, false>(start, end, fixed_point_points_to_visit, path);
+            break;
+    }
+
+    for (const size_t cluster : corridor_clusters)
+    {
+        in_corridor[cluster] = 0;
+    }
+
+    if (collect_statistics)
+    {
+        search_statistics.search_time_ms += abstract_time_ms;
+    }
+
+    if (not path_found)
+    {
+        print_failure(start, end);
+    }
+
+    return path_found;
+}
+
+template<typename Cost_model, bool Instrumented, typename Points_to_visit_type>
+bool HPA_star_planner::refine(const Coord_point_2D& start,
+                              const Coord_point_2D& end,
+                              Points_to_visit_type& points_to_visit,
+                              std::vector<Coord_point_2D>& path)
+{
+    typedef typename Cost_model::Cost Cost;
+
+    // The counters and the trace are removed at compile time unless they are both requested and compiled in
+    const bool collect = Instrumented && search_statistics_compiled_in && search_statistics_enabled;
+    const bool trace = Instrumented && search_statistics_compiled_in && expansion_trace_enabled;
+    const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect);
+
+    const size_t start_index = start.get_flat_index(width);
+    const size_t end_index = end.get_flat_index(width);
+    const size_t end_x = end.get_x();
+    const size_t end_y = end.get_y();
+
+    // The start point has zero cost
+    search_state_grid.set(start_index, Cost(0), start_index);
+    update_points_to_visit(points_to_visit,
+                           start_index,
+                           Cost_model::get_cheapest_cost_to_target(get_distance(start.get_x(), end_x),
+                                                                   get_distance(start.get_y(), end_y)),
+                           false);
+
+    if (collect)
+    {
+        search_statistics.number_of_visited_points = 1;
+        search_statistics.peak_points_to_visit = 1;
+    }
+
+    Neighbors neighbors;
+
+    bool path_found = false;
+    while (not points_to_visit.empty())
+    {
+        // Pop the point which have the lowest total cost
+        const size_t current_index = get_cheapest_point_to_visit(points_to_visit);
+        points_to_visit.pop();
+
+        if (should_stop(points_to_visit.get_number_of_pops()))
+        {
+            // Cancelled or out of time
+            break;
+        }
+
+        if (search_state_grid.is_closed(current_index))
+        {
+            // An old entry of a point that has been pushed again with a lower cost, see Bucket_queue
+            if (collect)
+            {
+                search_statistics.number_of_stale_pops++;
+            }
+            continue;
+        }
+
+        search_state_grid.set_closed(current_index);
+
+        if (collect)
+        {
+            search_statistics.number_of_expanded_points++;
+        }
+
+        if (trace)
+        {
+            // The path cost in units of a horizontal or vertical move
+            const float path_cost = static_cast<float>(search_state_grid.get_path_cost<Cost>(current_index)) /
+                                    static_cast<float>(Cost_model::get_straight_cost());
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index), path_cost};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        if (current_index == end_index)
+        {
+            // End point reached, reconstruct the path
+            const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect);
+            path_found = reconstruct_path(start, Flat_point_2D(current_index), path);
+            if (collect)
+            {
+                search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
+            }
+            break;
+        }
+
+        const Cost path_cost_current_point = search_state_grid.get_path_cost<Cost>(current_index);
+
+        const size_t number_of_neighbors = get_neighbors(Flat_point_2D(current_index), neighbors);
+        for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+        {
+            const size_t neighbor_index = neighbors.at(neighbor_number).first.get_flat_index();
+            const size_t neighbor_x = neighbor_index % width;
+            const size_t neighbor_y = neighbor_index / width;
+
+            if (not in_corridor[cluster_graph.get_cluster(neighbor_x, neighbor_y)] ||
+                search_state_grid.is_closed(neighbor_index))
+            {
+                // Only the points of the clusters on the abstract path are searched
+                continue;
+            }
+
+            const Cost path_cost = path_cost_current_point + (neighbors.at(neighbor_number).second
+                                                                                    ? Cost_model::get_diagonal_cost()
+                                                                                    : Cost_model::get_straight_cost());
+
+            if (path_cost < search_state_grid.get_path_cost<Cost>(neighbor_index))
+            {
+                const bool is_in_points_to_visit = search_state_grid.is_visited(neighbor_index);
+                const Cost total_cost = path_cost + Cost_model::get_cheapest_cost_to_target(
+                                                                                  get_distance(neighbor_x, end_x),
+                                                                                  get_distance(neighbor_y, end_y));
+
+                search_state_grid.set(neighbor_index, path_cost, current_index);
+
+                update_points_to_visit(points_to_visit, neighbor_index, total_cost, is_in_points_to_visit);
+
+                if (collect)
+                {
+                    search_statistics.number_of_generated_points++;
+                    search_statistics.number_of_visited_points += is_in_points_to_visit ? 0 : 1;
+                    search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                                      points_to_visit.size());
+                }
+            }
+        }
+    }
+
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = points_to_visit.get_number_of_pushes();
+        search_statistics.number_of_heap_pops = points_to_visit.get_number_of_pops();
+        search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time) -
+                                           search_statistics.reconstruct_time_ms;
+        search_statistics.scratch_bytes_touched =
+                               search_statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point() +
+                               search_statistics.peak_points_to_visit * get_bytes_per_entry(points_to_visit);
+    }
+
+    return path_found;
+}
+
+void HPA_star_planner::set_grid_size(const size_t width, const size_t height)
+{
+    A_star_planner::set_grid_size(width, height);
+    cluster_graph_outdated = true;
+}
+
+void HPA_star_planner::set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid)
+{
+    A_star_planner::set_availability_grid(availability_grid);
+    cluster_graph_outdated = true;
+}
+
+void HPA_star_planner::set_available(const size_t x, const size_t y)
+{
+    const bool up_to_date = is_cluster_graph_up_to_date();
+    A_star_planner::set_available(x, y);
+    if (up_to_date)
+    {
+        mark_dirty(Coord_rectangle_2D(x, y, x, y));
+    }
+}
+
+void HPA_star_planner::set_available(const Coord_point_2D& point)
+{
+    set_available(point.get_x(), point.get_y());
+}
+
+void HPA_star_planner::set_blocked(const size_t x, size_t y)
+{
+    const bool up_to_date = is_cluster_graph_up_to_date();
+    A_star_planner::set_blocked(x, y);
+    if (up_to_date)
+    {
+        mark_dirty(Coord_rectangle_2D(x, y, x, y));
+    }
+}
+
+void HPA_star_planner::set_blocked(const Coord_point_2D& point)
+{
+    set_blocked(point.get_x(), point.get_y());
+}
+
+Coord_rectangle_2D HPA_star_planner::commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius)
+{
+    const bool up_to_date = is_cluster_graph_up_to_date();
+    const Coord_rectangle_2D dirty_rectangle = A_star_planner::commit_path(path, halo_radius);
+
+    // Only mark the clusters around the path, the bounding rectangle of a long diagonal path covers most of the grid
+    for (size_t i = 0; i < path.size() && up_to_date; i++)
+    {
+        const size_t x = path[i].get_x();
+        const size_t y = path[i].get_y();
+        mark_dirty(Coord_rectangle_2D(x > halo_radius ? x - halo_radius : 0,
+                                      y > halo_radius ? y - halo_radius : 0,
+                                      std::min(x + halo_radius, width - 1),
+                                      std::min(y + halo_radius, height - 1)));
+    }
+
+    return dirty_rectangle;
+}
+
+const Cluster_graph& HPA_star_planner::get_cluster_graph() const
+{
+    return cluster_graph;
+}
+
+size_t HPA_star_planner::get_number_of_bytes() const
+{
+    return A_star_planner::get_number_of_bytes() + cluster_graph.get_number_of_bytes()
+           + corridor_clusters.capacity() * sizeof(size_t) + in_corridor.capacity() * sizeof(uint8_t);
+}
+
+bool HPA_star_planner::is_cluster_graph_up_to_date() const
+{
+    return not cluster_graph_outdated && availability_grid &&
+           availability_grid->get_number_of_changes() == number_of_grid_changes;
+}
+
+void HPA_star_planner::mark_dirty(const Coord_rectangle_2D& rectangle)
+{
+    cluster_graph.mark_dirty(rectangle);
+    number_of_grid_changes = availability_grid->get_number_of_changes();
+}
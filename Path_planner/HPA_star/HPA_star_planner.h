@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_HPA_STAR_HPA_STAR_PLANNER_H_
+#define LINE_ROUTER_PATH_PLANNER_HPA_STAR_HPA_STAR_PLANNER_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Cluster_graph.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// This class finds paths with hierarchical path-finding A* (HPA*) for large grids. The grid is split into clusters and
+// an abstract graph of the entrances between the clusters is kept, see Cluster_graph. A query first finds the cheapest
+// path in the abstract graph, which only has a few nodes per cluster, and then refines it with an A* search on the
+// grid that may only expand the points of the clusters on the abstract path. A query on an open grid therefore expands
+// about the points of a corridor of clusters between the end points instead of an area that grows with the distance.
+// The path is optimal inside the corridor but not always the cheapest path on the whole grid.
+// The abstract graph is built on the first query. When points are changed through the planner, e.g. by commit_path,
+// only the clusters around the changed points are marked as dirty and they are updated on the next query. If the
+// availability grid has been changed directly the whole graph is built again, see
+// Availability_grid::get_number_of_changes.
+// Both cost modes of the A_star_planner are supported for the refinement, the abstract graph always uses the fixed
+// point costs. The search statistics and the expansion trace cover the refinement.
+// This class is intended to be accessed by one thread since it is not thread safe.
+class HPA_star_planner : public A_star_planner
+{
+public:
+    // The width and height in points of a cluster
+    static const size_t default_cluster_size = 32;
+
+    // Create a HPA_star_planner with an already existing availability grid. The availability grid must have been
+    // initialized before calling this. The grid size will be fetched from the availability grid.
+    HPA_star_planner(std::shared_ptr<Availability_grid> availability_grid,
+                     const size_t cluster_size = default_cluster_size);
+    // Create a HPA_star_planner with a grid size of width x height. It will also initialize an all available
+    // width x height availability grid.
+    HPA_star_planner(const size_t width, const size_t height, const size_t cluster_size = default_cluster_size);
+
+    virtual ~HPA_star_planner();
+
+    // Get a path from start point to end point
+    // Returns a vector with path where first element is the start point and last is the end point
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override;
+
+    // Set a new grid size (could be costly if the grid is large). The abstract graph is built again on the next query.
+    void set_grid_size(const size_t width, const size_t height) override;
+
+    // Set a new availability grid. The abstract graph is built again on the next query.
+    void set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid) override;
+
+    // Change points and mark the clusters around them as dirty
+    void set_available(const size_t x, const size_t y) override;
+    void set_available(const Coord_point_2D& point) override;
+    void set_blocked(const size_t x, size_t y) override;
+    void set_blocked(const Coord_point_2D& point) override;
+    Coord_rectangle_2D commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius) override;
+
+    // Get the abstract graph, e.g. to check how many clusters have been updated
+    const Cluster_graph& get_cluster_graph() const;
+
+    // Number of bytes of the grids including the abstract graph and the corridor flags
+    size_t get_number_of_bytes() const override;
+
+private:
+    Cluster_graph cluster_graph;
+
+    // The graph is up to date with the availability grid after this many changes of it, unless it must be built again
+    bool cluster_graph_outdated;
+    size_t number_of_grid_changes;
+
+    // The clusters on the abstract path of the current query, and a flag per cluster if it is one of them
+    std::vector<size_t> corridor_clusters;
+    std::vector<uint8_t> in_corridor;
+
+    // Check if the abstract graph is up to date with the availability grid, apart from its dirty clusters. A change
+    // through the planner only marks the clusters around it as dirty if the graph was up to date before the change,
+    // otherwise the graph is built again on the next query.
+    bool is_cluster_graph_up_to_date() const;
+
+    // Mark the clusters around a rectangle of changed points as dirty and take the new number of grid changes
+    void mark_dirty(const Coord_rectangle_2D& rectangle);
+
+    // The A* search from start to end that only expands the points in the corridor clusters
+    template<typename Cost_model, bool Instrumented, typename Points_to_visit_type>
+    bool refine(const Coord_point_2D& start,
+                const Coord_point_2D& end,
+                Points_to_visit_type& points_to_visit,
+                std::vector<Coord_point_2D>& path);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_HPA_STAR_HPA_STAR_PLANNER_H_
@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <HPA_star_planner.h>
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Cluster_graph.h>
+#include <Coord_point_2D.h>
+#include <Path_planner_test_helpers.h>
+#include <Search_statistics.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(HPA_star_planner, Simple_open_area)
+{
+    HPA_star_planner planner(2, 2);
+    std::vector<Coord_point_2D> path;
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(2));
+    EXPECT_EQ(path.front(), Coord_point_2D(0, 0));
+    EXPECT_EQ(path.back(), Coord_point_2D(1, 1));
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(1, 1), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(1));
+}
+
+TEST(HPA_star_planner, Normal_sized_open_area)
+{
+    // The grid is not a multiple of the cluster size
+    HPA_star_planner planner(300, 250);
+    std::vector<Coord_point_2D> path;
+
+    const Coord_point_2D start_point(3, 7);
+    const Coord_point_2D end_point(291, 240);
+    EXPECT_TRUE(planner.get_path(start_point, end_point, path));
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front(), start_point);
+    EXPECT_EQ(path.back(), end_point);
+    expect_valid_path(*planner.get_availability_grid(), path);
+
+    // The octile distance is the cheapest cost on an open grid. The corridor of clusters on the abstract path may not
+    // contain a path with that cost, since the abstract path passes the borders at the transitions.
+    const double octile_cost = 233 * 1.4142136 + 55;
+    EXPECT_GE(get_path_cost(path), octile_cost - 0.01);
+    EXPECT_LE(get_path_cost(path), 1.03 * octile_cost);
+}
+
+TEST(HPA_star_planner, Impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    HPA_star_planner planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    availability_grid->set_blocked(98, 98);
+    availability_grid->set_blocked(99, 98);
+    availability_grid->set_blocked(98, 99);
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+
+    // A blocked end point can not be reached
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(98, 98), path));
+
+    // A blocked start point can be left
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(98, 98), Coord_point_2D(0, 0), path));
+    expect_valid_path(*availability_grid, path);
+}
+
+// A blocked start point is not on any entrance of its cluster, but it can move into the clusters next to it
+TEST(HPA_star_planner, Blocked_start_on_cluster_border)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(64, 64);
+    HPA_star_planner planner(availability_grid, 16);
+    A_star_planner a_star_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    // The start point on the right border of the first cluster can only move into the cluster to the right
+    for (size_t y = 0; y < 64; y++)
+    {
+        availability_grid->set_blocked(14, y);
+        availability_grid->set_blocked(15, y);
+    }
+    const Coord_point_2D start_point(15, 20);
+    ASSERT_TRUE(planner.get_path(start_point, Coord_point_2D(40, 50), path));
+    EXPECT_EQ(path.front(), start_point);
+    EXPECT_EQ(path.back(), Coord_point_2D(40, 50));
+    expect_valid_path(*availability_grid, path);
+
+    // Also when the end point is in the cluster to the right
+    ASSERT_TRUE(planner.get_path(start_point, Coord_point_2D(20, 18), path));
+    EXPECT_EQ(path.size(), size_t(6));
+    expect_valid_path(*availability_grid, path);
+
+    // Blocked start points on random grids are left like by A_star_planner
+    std::mt19937 random_generator(2019);
+    for (size_t grid_number = 0; grid_number < 4; grid_number++)
+    {
+        const std::shared_ptr<Availability_grid> random_grid = std::make_shared<Availability_grid>(100, 90);
+        block_random_points(*random_grid, 40, random_generator);
+        planner.set_availability_grid(random_grid);
+        a_star_planner.set_availability_grid(random_grid);
+
+        for (size_t query = 0; query < 100; query++)
+        {
+            const Coord_point_2D start = get_random_blocked_point(*random_grid, random_generator);
+            const Coord_point_2D end = get_random_available_point(*random_grid, random_generator);
+
+            std::vector<Coord_point_2D> a_star_path;
+            const bool path_found = planner.get_path(start, end, path);
+            ASSERT_EQ(path_found, a_star_planner.get_path(start, end, a_star_path)) << start << " to " << end;
+            if (path_found)
+            {
+                ASSERT_EQ(path.front(), start);
+                ASSERT_EQ(path.back(), end);
+                expect_valid_path(*random_grid, path);
+            }
+        }
+    }
+}
+
+TEST(HPA_star_planner, Close_to_A_star_planner_cost)
+{
+    std::mt19937 random_generator(2019);
+
+    for (size_t grid_number = 0; grid_number < 4; grid_number++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(200, 170);
+        block_random_points(*availability_grid, 25, random_generator);
+
+        // Alternate the cluster size and the cost mode
+        HPA_star_planner planner(availability_grid, grid_number % 2 == 0 ? 16 : 32);
+        A_star_planner a_star_planner(availability_grid);
+        if (grid_number >= 2)
+        {
+            planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+            a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+        }
+
+        double total_cost = 0;
+        double total_a_star_cost = 0;
+        for (size_t query = 0; query < 50; query++)
+        {
+            const Coord_point_2D start_point = get_random_available_point(*availability_grid, random_generator);
+            const Coord_point_2D end_point = get_random_available_point(*availability_grid, random_generator);
+
+            std::vector<Coord_point_2D> path;
+            std::vector<Coord_point_2D> a_star_path;
+            const bool path_found = planner.get_path(start_point, end_point, path);
+            ASSERT_EQ(path_found, a_star_planner.get_path(start_point, end_point, a_star_path));
+            if (not path_found)
+            {
+                continue;
+            }
+
+            ASSERT_EQ(path.front(), start_point);
+            ASSERT_EQ(path.back(), end_point);
+            expect_valid_path(*availability_grid, path);
+
+            // The path is optimal inside the clusters of the abstract path. The fixed point paths have the cheapest
+            // cost with a diagonal move of 1.4 so they are only compared with the floating point cost here.
+            const double cost = get_path_cost(path);
+            const double a_star_cost = get_path_cost(a_star_path);
+            if (grid_number < 2)
+            {
+                EXPECT_GE(cost, a_star_cost - 0.01);
+            }
+            EXPECT_LE(cost, 1.2 * a_star_cost + 0.01);
+            total_cost += cost;
+            total_a_star_cost += a_star_cost;
+        }
+        EXPECT_LE(total_cost, 1.05 * total_a_star_cost);
+    }
+}
+
+TEST(HPA_star_planner, Incremental_cluster_updates)
+{
+    const size_t width = 512;
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(width, width);
+    HPA_star_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+
+    // The first query builds all clusters
+    std::vector<Coord_point_2D> path;
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(511, 511), path));
+    EXPECT_EQ(planner.get_cluster_graph().get_number_of_clusters(), size_t(16 * 16));
+    EXPECT_EQ(planner.get_cluster_graph().get_number_of_rebuilt_clusters(), size_t(16 * 16));
+
+    // Commit lines, only the clusters around the last committed line are updated by a query
+    std::mt19937 random_generator(2019);
+    std::uniform_int_distribution<size_t> coordinate_distribution(10, width - 11);
+    for (size_t line = 0; line < 40; line++)
+    {
+        const Coord_point_2D start_point = get_random_available_point(*availability_grid, random_generator);
+        const Coord_point_2D end_point(coordinate_distribution(random_generator),
+                                       coordinate_distribution(random_generator));
+
+        const size_t rebuilt_clusters_before = planner.get_cluster_graph().get_number_of_rebuilt_clusters();
+        std::vector<Coord_point_2D> a_star_path;
+        const bool path_found = planner.get_path(start_point, end_point, path);
+        ASSERT_EQ(path_found, a_star_planner.get_path(start_point, end_point, a_star_path));
+        EXPECT_LT(planner.get_cluster_graph().get_number_of_rebuilt_clusters() - rebuilt_clusters_before,
+                  size_t(16 * 16 / 4));
+
+        if (path_found)
+        {
+            expect_valid_path(*availability_grid, path);
+            planner.commit_path(path, 1);
+        }
+    }
+
+    // The updated graph is the same as a graph built from scratch
+    HPA_star_planner fresh_planner(availability_grid);
+    for (size_t query = 0; query < 20; query++)
+    {
+        const Coord_point_2D start_point = get_random_available_point(*availability_grid, random_generator);
+        const Coord_point_2D end_point = get_random_available_point(*availability_grid, random_generator);
+
+        std::vector<Coord_point_2D> fresh_path;
+        const bool path_found = planner.get_path(start_point, end_point, path);
+        ASSERT_EQ(path_found, fresh_planner.get_path(start_point, end_point, fresh_path));
+        EXPECT_EQ(planner.get_cluster_graph().get_abstract_path_cost(),
+                  fresh_planner.get_cluster_graph().get_abstract_path_cost());
+        EXPECT_EQ(planner.get_cluster_graph().get_number_of_nodes(),
+                  fresh_planner.get_cluster_graph().get_number_of_nodes());
+    }
+}
+
+TEST(HPA_star_planner, Change_outside_of_planner)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(256, 256);
+    HPA_star_planner planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(255, 0), path));
+    EXPECT_EQ(planner.get_cluster_graph().get_number_of_rebuilt_clusters(), size_t(8 * 8));
+
+    // A change through the planner only updates the clusters around it
+    planner.set_blocked(100, 100);
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(255, 0), path));
+    EXPECT_EQ(planner.get_cluster_graph().get_number_of_rebuilt_clusters(), size_t(8 * 8 + 1));
+
+    // A wall changed directly in the availability grid is found since the whole graph is built again
+    for (size_t y = 0; y < 255; y++)
+    {
+        availability_grid->set_blocked(128, y);
+    }
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(255, 0), path));
+    EXPECT_EQ(planner.get_cluster_graph().get_number_of_rebuilt_clusters(), size_t(8 * 8));
+    expect_valid_path(*availability_grid, path);
+    EXPECT_EQ(path.at(255), Coord_point_2D(128, 255));
+}
+
+TEST(HPA_star_planner, Search_statistics)
+{
+    if (not search_statistics_compiled_in)
+    {
+        return;
+    }
+
+    // On an open grid the refinement only expands the points of the corridor of clusters between the end points
+    HPA_star_planner planner(1024, 1024);
+    A_star_planner a_star_planner(planner.get_availability_grid());
+    planner.set_search_statistics_enabled(true);
+    a_star_planner.set_search_statistics_enabled(true);
+    for (size_t y = 0; y < 1000; y++)
+    {
+        planner.set_blocked(500, y);
+    }
+
+    std::vector<Coord_point_2D> path;
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(10, 10), Coord_point_2D(1000, 20), path));
+    EXPECT_TRUE(a_star_planner.get_path(Coord_point_2D(10, 10), Coord_point_2D(1000, 20), path));
+    EXPECT_GT(planner.get_search_statistics().number_of_expanded_points, size_t(0));
+    EXPECT_LT(planner.get_search_statistics().number_of_expanded_points * 4,
+              a_star_planner.get_search_statistics().number_of_expanded_points);
+}
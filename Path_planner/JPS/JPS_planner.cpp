@@ -0,0 +1,509 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <JPS_planner.h>
+#include <A_star_planner.h>
+#include <Cost_point_2D.h>
+#include <Flat_point_2D.h>
+
+// Standard library headers
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <iostream>
+
+JPS_planner::JPS_planner(std::shared_ptr<Availability_grid> availability_grid) : A_star_planner(availability_grid)
+{
+}
+
+JPS_planner::JPS_planner(const size_t width, const size_t height) : A_star_planner(width, height)
+{
+}
+
+JPS_planner::~JPS_planner()
+{
+}
+
+bool JPS_planner::get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path)
+{
+    // Every expanded jump point costs a lot more than the counters, so unlike the A_star_planner the statistics are
+    // checked at runtime. They are still removed at compile time if not compiled in.
+    const bool collect = is_collecting_search_statistics();
+    const bool trace = is_recording_expansion_trace();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect);
+
+    if (not check_end_points(start, end))
+    {
+        return false;
+    }
+
+    // Clear the points to visit heap and its counters
+    points_to_visit.clear();
+
+    if (start == end)
+    {
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
+    }
+
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_reachable(start, end))
+    {
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
+        return false;
+    }
+
+    // Start a new query, all points are unvisited with an infinite path cost except for the start point which has zero
+    // cost
+    search_state_grid.start_new_query();
+    search_state_grid.set(start.get_flat_index(width), 0.0f, start.get_flat_index(width));
+
+    const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect);
+    if (collect)
+    {
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
+    }
+
+    // Set start point total cost and add it to the points to visit heap
+    const float cheapest_cost_to_end_point = calculate_cheapest_cost_to_target(start, end);
+    points_to_visit.push(Cost_point_2D(start, width, cheapest_cost_to_end_point));
+
+    if (collect)
+    {
+        search_statistics.number_of_visited_points = 1;
+        search_statistics.peak_points_to_visit = 1;
+    }
+
+    Directions directions;
+
+    bool path_found = false;
+
+    while (points_to_visit.empty() == false)
+    {
+        // Pop the jump point which have the lowest total cost, its path cost can not be lowered any more
+        const Cost_point_2D current_cost_point = points_to_visit.top();
+        points_to_visit.pop();
+        search_state_grid.set_closed(current_cost_point.get_flat_index());
+
+        if (should_stop(points_to_visit.get_number_of_pops()))
+        {
+            // Cancelled or out of time
+            break;
+        }
+
+        if (collect)
+        {
+            search_statistics.number_of_expanded_points++;
+        }
+
+        if (trace)
+        {
+            const size_t current_index = current_cost_point.get_flat_index();
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index),
+                                                   search_state_grid.get_path_cost(current_index)};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        const Coord_point_2D current_point(current_cost_point, width);
+        if (current_point == end)
+        {
+            // End point reached, reconstruct the path
+            const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect);
+            path_found = reconstruct_jump_path(start, end, path);
+            if (collect)
+            {
+                search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
+            }
+            break;
+        }
+
+        const float path_cost_current_point = search_state_grid.get_path_cost(current_cost_point.get_flat_index());
+
+        // The direction used to reach the current point from its parent jump point
+        Direction direction = {0, 0};
+        const bool is_start = current_point == start;
+        if (not is_start)
+        {
+            const Coord_point_2D parent_point(Flat_point_2D(search_state_grid.get_previous(
+                                                                                current_cost_point.get_flat_index())),
+                                              width);
+            const size_t x = current_point.get_x();
+            const size_t y = current_point.get_y();
+            direction.dx = (x > parent_point.get_x()) - (x < parent_point.get_x());
+            direction.dy = (y > parent_point.get_y()) - (y < parent_point.get_y());
+        }
+
+        const size_t number_of_directions = get_pruned_directions(current_point.get_x(),
+                                                                  current_point.get_y(),
+                                                                  is_start,
+                                                                  direction,
+                                                                  directions);
+        for (size_t direction_index = 0; direction_index < number_of_directions; direction_index++)
+        {
+            const Direction& jump_direction = directions.at(direction_index);
+
+            Coord_point_2D jump_point;
+            size_t steps = 0;
+            if (not jump(current_point.get_x(), current_point.get_y(), jump_direction, end, jump_point, steps))
+            {
+                continue;
+            }
+
+            const bool is_diagonal = jump_direction.dx != 0 && jump_direction.dy != 0;
+            const float path_cost = path_cost_current_point + get_jump_cost(steps, is_diagonal);
+
+            const size_t jump_index = jump_point.get_flat_index(width);
+            if (search_state_grid.is_closed(jump_index))
+            {
+                // The cheapest path to a closed jump point has already been found
+                continue;
+            }
+
+            if (path_cost < search_state_grid.get_path_cost(jump_index))
+            {
+                const bool is_in_points_to_visit = search_state_grid.is_visited(jump_index);
+
+                // The total cost is the cheapest possible cost from start point to the jump point plus the estimated
+                // cheapest cost to end point. A* function f = g + h.
+                const float total_cost = path_cost + calculate_cheapest_cost_to_target(jump_point, end);
+
+                // The previous point is the neighbor one step back towards the current point, see JPS_planner
+                const size_t previous_index = jump_index - jump_direction.dx -
+                                              jump_direction.dy * static_cast<ssize_t>(width);
+                search_state_grid.set(jump_index, path_cost, previous_index);
+
+                const Cost_point_2D jump_cost_point(jump_index, total_cost);
+                if (is_in_points_to_visit)
+                {
+                    points_to_visit.decrease_cost(jump_cost_point);
+                }
+                else
+                {
+                    points_to_visit.push(jump_cost_point);
+                }
+
+                if (collect)
+                {
+                    search_statistics.number_of_generated_points++;
+                    search_statistics.number_of_visited_points += is_in_points_to_visit ? 0 : 1;
+                    search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                                      points_to_visit.size());
+                }
+            }
+        }
+    }
+
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = points_to_visit.get_number_of_pushes();
+        search_statistics.number_of_heap_pops = points_to_visit.get_number_of_pops();
+        search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time) -
+                                           search_statistics.reconstruct_time_ms;
+        search_statistics.scratch_bytes_touched =
+                               search_statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point() +
+                               search_statistics.peak_points_to_visit * sizeof(Cost_point_2D);
+    }
+
+    if (not path_found)
+    {
+        print_failure(start, end);
+    }
+
+    return path_found;
+}
+
+bool JPS_planner::is_walkable(const ssize_t x, const ssize_t y) const
+{
+    if (x < 0 || y < 0 || x >= static_cast<ssize_t>(width) || y >= static_cast<ssize_t>(height))
+    {
+        return false;
+    }
+
+    return availability_grid->is_available(static_cast<size_t>(x), static_cast<size_t>(y));
+}
+
+bool JPS_planner::is_move_allowed(const ssize_t x, const ssize_t y, const Direction& direction) const
+{
+    if (not is_walkable(x + direction.dx, y + direction.dy))
+    {
+        return false;
+    }
+
+    if (direction.dx != 0 && direction.dy != 0)
+    {
+        // A diagonal move needs at least one of the nearest neighbors to the diagonal neighbor to be available
+        return is_walkable(x + direction.dx, y) || is_walkable(x, y + direction.dy);
+    }
+
+    return true;
+}
+
+size_t JPS_planner::get_pruned_directions(const size_t x,
+                                          const size_t y,
+                                          const bool is_start,
+                                          const Direction& direction,
+                                          Directions& directions) const
+{
+    size_t number_of_directions = 0;
+
+    const ssize_t sx = static_cast<ssize_t>(x);
+    const ssize_t sy = static_cast<ssize_t>(y);
+
+    if (is_start)
+    {
+        // Nothing can be pruned from the start point, all allowed moves are searched
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                const Direction start_direction = {dx, dy};
+                if ((dx != 0 || dy != 0) && is_move_allowed(sx, sy, start_direction))
+                {
+                    directions.at(number_of_directions) = start_direction;
+                    number_of_directions++;
+                }
+            }
+        }
+
+        return number_of_directions;
+    }
+
+    const int dx = direction.dx;
+    const int dy = direction.dy;
+
+    if (dx != 0 && dy != 0)
+    {
+        // Diagonal direction. The natural neighbors are the horizontal, vertical and diagonal neighbor in the
+        // direction of travel.
+        const bool horizontal_walkable = is_walkable(sx + dx, sy);
+        const bool vertical_walkable   = is_walkable(sx, sy + dy);
+
+        if (horizontal_walkable)
+        {
+            directions.at(number_of_directions) = {dx, 0};
+            number_of_directions++;
+        }
+        if (vertical_walkable)
+        {
+            directions.at(number_of_directions) = {0, dy};
+            number_of_directions++;
+        }
+        if ((horizontal_walkable || vertical_walkable) && is_walkable(sx + dx, sy + dy))
+        {
+            directions.at(number_of_directions) = {dx, dy};
+            number_of_directions++;
+        }
+
+        // Forced neighbors. They appear when a point next to the parent is blocked.
+        // P = parent, C = current, X = blocked, F = forced neighbor
+        //   F A
+        //   X C
+        //   P X
+        if (not is_walkable(sx - dx, sy) && vertical_walkable && is_walkable(sx - dx, sy + dy))
+        {
+            directions.at(number_of_directions) = {-dx, dy};
+            number_of_directions++;
+        }
+        if (not is_walkable(sx, sy - dy) && horizontal_walkable && is_walkable(sx + dx, sy - dy))
+        {
+            directions.at(number_of_directions) = {dx, -dy};
+            number_of_directions++;
+        }
+    }
+    else if (dx != 0)
+    {
+        // Horizontal direction. The natural neighbor is the next point in the direction of travel.
+        if (is_walkable(sx + dx, sy))
+        {
+            directions.at(number_of_directions) = {dx, 0};
+            number_of_directions++;
+
+            // Forced neighbors. They appear when a point above or below the current point is blocked.
+            // P = parent, C = current, X = blocked, F = forced neighbor
+            //   A X F
+            //   P C A
+            if (not is_walkable(sx, sy - 1) && is_walkable(sx + dx, sy - 1))
+            {
+                directions.at(number_of_directions) = {dx, -1};
+                number_of_directions++;
+            }
+            if (not is_walkable(sx, sy + 1) && is_walkable(sx + dx, sy + 1))
+            {
+                directions.at(number_of_directions) = {dx, 1};
+                number_of_directions++;
+            }
+        }
+    }
+    else
+    {
+        // Vertical direction. Same as the horizontal direction but with x and y swapped.
+        if (is_walkable(sx, sy + dy))
+        {
+            directions.at(number_of_directions) = {0, dy};
+            number_of_directions++;
+
+            if (not is_walkable(sx - 1, sy) && is_walkable(sx - 1, sy + dy))
+            {
+                directions.at(number_of_directions) = {-1, dy};
+                number_of_directions++;
+            }
+            if (not is_walkable(sx + 1, sy) && is_walkable(sx + 1, sy + dy))
+            {
+                directions.at(number_of_directions) = {1, dy};
+                number_of_directions++;
+            }
+        }
+    }
+
+    return number_of_directions;
+}
+
+bool JPS_planner::jump(const size_t x,
+                       const size_t y,
+                       const Direction& direction,
+                       const Coord_point_2D& end,
+                       Coord_point_2D& jump_point,
+                       size_t& steps) const
+{
+    const int dx = direction.dx;
+    const int dy = direction.dy;
+
+    ssize_t sx = static_cast<ssize_t>(x);
+    ssize_t sy = static_cast<ssize_t>(y);
+    steps = 0;
+
+    while (is_move_allowed(sx, sy, direction))
+    {
+        sx += dx;
+        sy += dy;
+        steps++;
+
+        jump_point = Coord_point_2D(sx, sy);
+        if (jump_point == end)
+        {
+            return true;
+        }
+
+        if (dx != 0 && dy != 0)
+        {
+            // Diagonal jump, look for forced neighbors (see get_pruned_directions)
+            if ((not is_walkable(sx - dx, sy) && is_walkable(sx, sy + dy) && is_walkable(sx - dx, sy + dy)) ||
+                (not is_walkable(sx, sy - dy) && is_walkable(sx + dx, sy) && is_walkable(sx + dx, sy - dy)))
+            {
+                return true;
+            }
+
+            // The point is also a jump point if a horizontal or vertical jump from it finds a jump point
+            Coord_point_2D straight_jump_point;
+            size_t straight_steps = 0;
+            const Direction horizontal = {dx, 0};
+            const Direction vertical = {0, dy};
+            if (jump(sx, sy, horizontal, end, straight_jump_point, straight_steps) ||
+                jump(sx, sy, vertical, end, straight_jump_point, straight_steps))
+            {
+                return true;
+            }
+        }
+        else if (dx != 0)
+        {
+            // Horizontal jump, look for forced neighbors (see get_pruned_directions)
+            if (is_walkable(sx + dx, sy) &&
+                ((not is_walkable(sx, sy - 1) && is_walkable(sx + dx, sy - 1)) ||
+                 (not is_walkable(sx, sy + 1) && is_walkable(sx + dx, sy + 1))))
+            {
+                return true;
+            }
+        }
+        else
+        {
+            // Vertical jump, look for forced neighbors (see get_pruned_directions)
+            if (is_walkable(sx, sy + dy) &&
+                ((not is_walkable(sx - 1, sy) && is_walkable(sx - 1, sy + dy)) ||
+                 (not is_walkable(sx + 1, sy) && is_walkable(sx + 1, sy + dy))))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool JPS_planner::reconstruct_jump_path(const Coord_point_2D& start,
+                                        const Coord_point_2D& end,
+                                        std::vector<Coord_point_2D>& path_vector) const
+{
+    // This function will do a reverse search from end point to start point from the previous points and fill in the
+    // points between the jump points
+
+    // Clear the path vector
+    path_vector.clear();
+
+    // Add end point to path
+    path_vector.push_back(end);
+
+    // It shouldn't take more than width x height iterations until the start point have been reached
+    const size_t max_iterations = width * height;
+    size_t number_of_iterations = 0;
+
+    Coord_point_2D current_point = end;
+    while (current_point != start && number_of_iterations < max_iterations)
+    {
+        // The previous point is one step back towards the parent jump point
+        const size_t current_index = current_point.get_flat_index(width);
+        const float path_cost = search_state_grid.get_path_cost(current_index);
+        const Coord_point_2D previous_point(Flat_point_2D(search_state_grid.get_previous(current_index)), width);
+        const int dx = (previous_point.get_x() > current_point.get_x()) -
+                       (previous_point.get_x() < current_point.get_x());
+        const int dy = (previous_point.get_y() > current_point.get_y()) -
+                       (previous_point.get_y() < current_point.get_y());
+        const bool is_diagonal = dx != 0 && dy != 0;
+
+        // Step towards the parent jump point one point at a time. The parent is the first visited point where the path
+        // cost plus the cost of the jump is the path cost of the current point. If another jump point is passed before
+        // the parent with the same cost, the path continues from there with the same total cost.
+        size_t steps = 0;
+        bool parent_found = false;
+        while (not parent_found && number_of_iterations < max_iterations)
+        {
+            number_of_iterations++;
+            steps++;
+            current_point = Coord_point_2D(current_point.get_x() + dx, current_point.get_y() + dy);
+            if (current_point.get_x() >= width || current_point.get_y() >= height)
+            {
+                std::cerr << "ERROR: No parent jump point found when reconstructing the path" << std::endl;
+                return false;
+            }
+            path_vector.push_back(current_point);
+
+            const size_t index = current_point.get_flat_index(width);
+            parent_found = search_state_grid.is_visited(index) &&
+                           search_state_grid.get_path_cost(index) + get_jump_cost(steps, is_diagonal) == path_cost;
+        }
+    }
+
+    if (number_of_iterations >= max_iterations)
+    {
+        std::cerr << "ERROR: Maximum iterations to reconstruct the path from start to end reached" << std::endl;
+        return false;
+    }
+
+    // Reverse the order so that the start point is first and end point is last
+    std::reverse(path_vector.begin(), path_vector.end());
+
+    return true;
+}
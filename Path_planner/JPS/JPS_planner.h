@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_JPS_JPS_PLANNER_H_
+#define LINE_ROUTER_PATH_PLANNER_JPS_JPS_PLANNER_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Flat_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// This class finds the same cheapest path as the A_star_planner but uses Jump Point Search (JPS) to prune the symmetric
+// paths of the grid. Instead of pushing every neighbor to the points to visit queue it will "jump" in a straight or
+// diagonal direction until it finds a point that has a forced neighbor, i.e. a neighbor that can not be reached as
+// cheap without passing the point. Only these jump points are added to the queue which cuts the number of expanded
+// points by a lot on open grids.
+// The moves follow the same rules as A_star_planner::get_neighbors, a diagonal move needs at least one of the two
+// nearest horizontal or vertical neighbors to be available. The previous point of a jump point is always another jump
+// point so the path between two jump points is filled in when the path is reconstructed. The search state only keeps
+// the direction to the previous point, see Search_state_grid, so the previous point of a jump point is stored as the
+// point one step back towards its parent jump point. The parent is then found again by stepping back until a visited
+// point with a matching path cost is reached.
+// The JPS_planner always uses the floating point costs, the cost mode of the A_star_planner is ignored.
+// This class is intended to be accessed by one thread since it is not thread safe.
+class JPS_planner : public A_star_planner
+{
+public:
+    // Create a JPS_planner with an already existing availability grid. The availability grid must have been
+    // initialized before calling this. The grid size will be fetched from the availability grid.
+    JPS_planner(std::shared_ptr<Availability_grid> availability_grid);
+    // Create a JPS_planner with a grid size of width x height. It will also initialize an all available
+    // width x height availability grid.
+    JPS_planner(const size_t width, const size_t height);
+
+    virtual ~JPS_planner();
+
+    // Get a path from start point to end point
+    // Returns a vector with path where first element is the start point and last is the end point. All points between
+    // the start and end point are included, not only the jump points.
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override;
+
+private:
+    // A search direction. Both dx and dy are -1, 0 or 1 and at least one of them is non-zero.
+    struct Direction
+    {
+        int dx;
+        int dy;
+    };
+
+    // The directions to search from a point is at most eight (from the start point)
+    typedef std::array<Direction, 8> Directions;
+
+    // Check if the coordinate is inside the grid and available
+    bool is_walkable(const ssize_t x, const ssize_t y) const;
+
+    // Check if it is possible to move one step from x, y in the given direction. It follows the same rules as
+    // A_star_planner::get_neighbors.
+    bool is_move_allowed(const ssize_t x, const ssize_t y, const Direction& direction) const;
+
+    // Get the directions that need to be searched from point. The direction is the direction that was used to reach
+    // the point from its parent. Directions to neighbors that can be reached at least as cheap without passing the
+    // point are pruned. If the point is the start point all allowed directions are returned.
+    // Return value is the number of directions filled to the directions array.
+    size_t get_pruned_directions(const size_t x,
+                                 const size_t y,
+                                 const bool is_start,
+                                 const Direction& direction,
+                                 Directions& directions) const;
+
+    // Step from x, y in the given direction until a jump point is found. A jump point is the end point, a point with a
+    // forced neighbor or, for diagonal directions, a point from which a horizontal or vertical jump finds a jump point.
+    // Returns false if a blocked point or the grid border is reached before any jump point is found. The number of
+    // steps taken to the jump point is returned in steps.
+    bool jump(const size_t x,
+              const size_t y,
+              const Direction& direction,
+              const Coord_point_2D& end,
+              Coord_point_2D& jump_point,
+              size_t& steps) const;
+
+    // The cost of a jump with a number of steps. The same calculation is used when the path is reconstructed, so the
+    // path costs match exactly.
+    static float get_jump_cost(const size_t steps, const bool is_diagonal)
+    {
+        // A horizontal or vertical step costs one and a diagonal step costs sqrt(1^2 + 1^2) ~= 1.4142136, just as in
+        // the A_star_planner
+        return steps * (is_diagonal ? 1.4142136f : 1.0f);
+    }
+
+    // Reconstruct the path from start point to end point by using the previous points. Since the previous points are
+    // jump points, the horizontal, vertical or diagonal line between two jump points is added to the path.
+    bool reconstruct_jump_path(const Coord_point_2D& start,
+                               const Coord_point_2D& end,
+                               std::vector<Coord_point_2D>& path_vector) const;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_JPS_JPS_PLANNER_H_
@@ -0,0 +1,213 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <JPS_planner.h>
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Path_planner_test_helpers.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(JPS_planner, Simple_open_area)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(2, 2);
+
+    JPS_planner jps_planner(availability_grid);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(jps_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(1, 1), path));
+
+    ASSERT_EQ(path.size(),  size_t(2));
+    EXPECT_EQ(path.front(), Coord_point_2D(0, 0));
+    EXPECT_EQ(path.back(),  Coord_point_2D(1, 1));
+}
+
+TEST(JPS_planner, Normal_sized_open_area)
+{
+    const size_t grid_width  = 600;
+    const size_t grid_height = grid_width;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+
+    JPS_planner jps_planner(availability_grid);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(jps_planner.get_path(start_point, end_point, path));
+
+    // Best path would be to go diagonal to end point
+    ASSERT_EQ(path.size(), size_t(grid_width));
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        EXPECT_EQ(path.at(i), Coord_point_2D(i, i));
+    }
+}
+
+TEST(JPS_planner, Large_area_with_diagonal_block)
+{
+    const size_t grid_width  = 2000;
+    const size_t grid_height = grid_width;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+
+    // Create a diagonal with only one possible point to pass through like this (scaled down)
+    // S A A X
+    // A A X A   S = Start, E = End, X = Block, A = Available
+    // A X A A
+    // A A A E
+    for (size_t x = 1; x < grid_width; x++)
+    {
+        const size_t y = grid_width-x-1;
+        availability_grid->set_blocked(x, y);
+    }
+
+    JPS_planner jps_planner(availability_grid);
+
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(jps_planner.get_path(start_point, end_point, path));
+
+    // Same path as for the A_star_planner, straight down, one diagonal step and then straight right
+    ASSERT_EQ(path.size(), size_t(grid_height + grid_width - 2));
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        if (i < grid_height - 1)
+        {
+            EXPECT_EQ(path.at(i), Coord_point_2D(0, i));
+        }
+        else if (i == grid_height-1)
+        {
+            EXPECT_EQ(path.at(i), Coord_point_2D(1, grid_height-1));
+        }
+        else
+        {
+            EXPECT_EQ(path.at(i), Coord_point_2D(i-grid_height+2, grid_height-1));
+        }
+    }
+}
+
+TEST(JPS_planner, Impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+
+    JPS_planner jps_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    availability_grid->set_blocked(98,98);
+    availability_grid->set_blocked(99,98);
+    availability_grid->set_blocked(98,99);
+
+    EXPECT_FALSE(jps_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+}
+
+TEST(JPS_planner, End_point_trapped_in_the_middle)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+
+    // X X X
+    // X E X   E = End, X = Block
+    // X X X
+    availability_grid->set_blocked(49, 49);
+    availability_grid->set_blocked(49, 50);
+    availability_grid->set_blocked(49, 51);
+    availability_grid->set_blocked(50, 51);
+    availability_grid->set_blocked(51, 51);
+    availability_grid->set_blocked(51, 50);
+    availability_grid->set_blocked(51, 49);
+    availability_grid->set_blocked(50, 49);
+
+    JPS_planner jps_planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    EXPECT_FALSE(jps_planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(50, 50), path));
+}
+
+// Route between random points on grids with random obstacles and check that the JPS_planner finds a path exactly when
+// the A_star_planner does and that the paths have the same cost
+TEST(JPS_planner, Same_cost_as_A_star_planner)
+{
+    const size_t grid_width  = 64;
+    const size_t grid_height = 48;
+    const size_t number_of_grids = 20;
+    const size_t number_of_queries = 25;
+
+    std::mt19937 random_generator(1234);
+
+    for (size_t grid = 0; grid < number_of_grids; grid++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                         grid_height);
+        // Block between 0 and 38 percent of the points
+        block_random_points(*availability_grid, (grid * 2) % 40, random_generator);
+
+        A_star_planner a_star_planner(availability_grid);
+        JPS_planner jps_planner(availability_grid);
+
+        for (size_t query = 0; query < number_of_queries; query++)
+        {
+            const Coord_point_2D start = get_random_available_point(*availability_grid, random_generator);
+            const Coord_point_2D end = get_random_available_point(*availability_grid, random_generator);
+            expect_same_cost_as_a_star(jps_planner, a_star_planner, start, end);
+        }
+    }
+}
+
+TEST(JPS_planner, Search_statistics)
+{
+    const size_t grid_width  = 100;
+    const size_t grid_height = grid_width;
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(grid_width,
+                                                                                                     grid_height);
+    for (size_t x = 1; x < grid_width; x++)
+    {
+        availability_grid->set_blocked(x, grid_width-x-1);
+    }
+
+    A_star_planner a_star_planner(availability_grid);
+    JPS_planner jps_planner(availability_grid);
+    a_star_planner.set_search_statistics_enabled(true);
+    jps_planner.set_search_statistics_enabled(true);
+    if (not search_statistics_compiled_in)
+    {
+        return;
+    }
+
+    const Coord_point_2D start_point(0, 0);
+    const Coord_point_2D end_point(grid_width-1, grid_height-1);
+    std::vector<Coord_point_2D> path;
+    ASSERT_TRUE(a_star_planner.get_path(start_point, end_point, path));
+    ASSERT_TRUE(jps_planner.get_path(start_point, end_point, path));
+
+    // Only the jump points are expanded
+    const Search_statistics& statistics = jps_planner.get_search_statistics();
+    EXPECT_GT(statistics.number_of_expanded_points, size_t(0));
+    EXPECT_LT(statistics.number_of_expanded_points,
+              a_star_planner.get_search_statistics().number_of_expanded_points);
+    EXPECT_EQ(statistics.number_of_heap_pops, statistics.number_of_expanded_points);
+    EXPECT_EQ(statistics.number_of_stale_pops, size_t(0));
+    EXPECT_GE(statistics.number_of_visited_points, statistics.number_of_expanded_points);
+    EXPECT_GT(statistics.scratch_bytes_touched, size_t(0));
+
+    // The trace holds the expanded jump points
+    jps_planner.set_expansion_trace_enabled(true);
+    ASSERT_TRUE(jps_planner.get_path(start_point, end_point, path));
+    EXPECT_EQ(jps_planner.get_expansion_trace().size(), statistics.number_of_expanded_points);
+}
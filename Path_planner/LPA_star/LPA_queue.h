@@ -0,0 +1,234 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_QUEUE_H_
+#define LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_QUEUE_H_
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The priority queue of the LPA_star_planner. It is a 4-ary min heap of points with a 64-bit key, where the heap index
+// of every point is kept in a position map indexed by flat index like in Indexed_d_ary_heap. Unlike that heap the key
+// of a point in the queue can be both raised and lowered and any point can be removed, which LPA* needs when a point
+// becomes consistent again or its key changes after a change of the grid.
+// The stored heap index is only trusted if the heap entry at that index is the same point, so the position map never
+// needs to be reset.
+class LPA_queue
+{
+public:
+    LPA_queue() : number_of_pushes(0),
+                  number_of_pops(0)
+    {
+    }
+
+    virtual ~LPA_queue()
+    {
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    // Remove all points. The allocated memory is kept.
+    void clear()
+    {
+        heap.clear();
+    }
+
+    // Remove all points and size the position map for number_of_points flat indices
+    void resize(const size_t number_of_points)
+    {
+        heap.clear();
+        positions.assign(number_of_points, 0);
+    }
+
+    // Number of bytes allocated for the position map. The heap is not counted since it grows with the number of points
+    // in it.
+    size_t get_number_of_position_bytes() const
+    {
+        return positions.capacity() * sizeof(uint32_t);
+    }
+
+    // Reset the counters
+    void reset_counters()
+    {
+        number_of_pushes = 0;
+        number_of_pops = 0;
+    }
+
+    // Check if the point with flat_index is in the queue
+    bool contains(const size_t flat_index) const
+    {
+        const size_t heap_index = positions[flat_index];
+        return heap_index < heap.size() && heap[heap_index].flat_index == flat_index;
+    }
+
+    // Add the point to the queue or change its key if it is already there
+    void push_or_update(const size_t flat_index, const uint64_t key)
+    {
+        if (not contains(flat_index))
+        {
+            number_of_pushes++;
+            const Entry entry = {key, flat_index};
+            heap.push_back(entry);
+            move_up(heap.size() - 1);
+            return;
+        }
+
+        const size_t heap_index = positions[flat_index];
+        const uint64_t old_key = heap[heap_index].key;
+        heap[heap_index].key = key;
+        if (key < old_key)
+        {
+            move_up(heap_index);
+        }
+        else
+        {
+            move_down(heap_index);
+        }
+    }
+
+    // Remove the point from the queue if it is there
+    void remove(const size_t flat_index)
+    {
+        if (not contains(flat_index))
+        {
+            return;
+        }
+
+        const size_t heap_index = positions[flat_index];
+        const uint64_t removed_key = heap[heap_index].key;
+        heap[heap_index] = heap.back();
+        heap.pop_back();
+        if (heap_index < heap.size())
+        {
+            positions[heap[heap_index].flat_index] = heap_index;
+            if (heap[heap_index].key < removed_key)
+            {
+                move_up(heap_index);
+            }
+            else
+            {
+                move_down(heap_index);
+            }
+        }
+    }
+
+    // Get the flat index and the key of the point with the lowest key
+    size_t top() const
+    {
+        return heap.front().flat_index;
+    }
+
+    uint64_t top_key() const
+    {
+        return heap.front().key;
+    }
+
+    // Remove the point with the lowest key
+    void pop()
+    {
+        number_of_pops++;
+        remove(heap.front().flat_index);
+    }
+
+    // Counters since the last reset of them
+    size_t get_number_of_pushes() const
+    {
+        return number_of_pushes;
+    }
+
+    size_t get_number_of_pops() const
+    {
+        return number_of_pops;
+    }
+
+private:
+    static const size_t arity = 4;
+
+    struct Entry
+    {
+        uint64_t key;
+        size_t flat_index;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<uint32_t> positions;
+
+    size_t number_of_pushes;
+    size_t number_of_pops;
+
+    // Move the entry at heap_index towards the root until its parent has a lower or equal key
+    void move_up(size_t heap_index)
+    {
+        const Entry entry = heap[heap_index];
+        while (heap_index > 0)
+        {
+            const size_t parent_index = (heap_index - 1) / arity;
+            if (not (entry.key < heap[parent_index].key))
+            {
+                break;
+            }
+
+            heap[heap_index] = heap[parent_index];
+            positions[heap[heap_index].flat_index] = heap_index;
+            heap_index = parent_index;
+        }
+
+        heap[heap_index] = entry;
+        positions[entry.flat_index] = heap_index;
+    }
+
+    // Move the entry at heap_index towards the leaves until all its children have a higher or equal key
+    void move_down(size_t heap_index)
+    {
+        const Entry entry = heap[heap_index];
+        const size_t heap_size = heap.size();
+        while (true)
+        {
+            const size_t first_child_index = heap_index * arity + 1;
+            if (first_child_index >= heap_size)
+            {
+                break;
+            }
+
+            const size_t last_child_index = first_child_index + arity < heap_size ? first_child_index + arity
+                                                                                  : heap_size;
+            size_t cheapest_child_index = first_child_index;
+            for (size_t child_index = first_child_index + 1; child_index < last_child_index; child_index++)
+            {
+                if (heap[child_index].key < heap[cheapest_child_index].key)
+                {
+                    cheapest_child_index = child_index;
+                }
+            }
+
+            if (not (heap[cheapest_child_index].key < entry.key))
+            {
+                break;
+            }
+
+            heap[heap_index] = heap[cheapest_child_index];
+            positions[heap[heap_index].flat_index] = heap_index;
+            heap_index = cheapest_child_index;
+        }
+
+        heap[heap_index] = entry;
+        positions[entry.flat_index] = heap_index;
+    }
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_QUEUE_H_
@@ -0,0 +1,545 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <LPA_star_planner.h>
+#include <A_star_planner.h>
+#include <Coord_rectangle_2D.h>
+#include <Cost_model.h>
+#include <Flat_point_2D.h>
+#include <LPA_queue.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// The constants are passed by reference in comparisons so they need a definition
+const LPA_star_planner::Cost LPA_star_planner::infinite_cost;
+
+namespace
+{
+    // Get the x and y distance between two points
+    size_t get_distance(const size_t a, const size_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+
+    // Get the cost of a move
+    uint32_t get_move_cost(const bool is_diagonal)
+    {
+        return is_diagonal ? Fixed_point_octile_cost_model::get_diagonal_cost()
+                           : Fixed_point_octile_cost_model::get_straight_cost();
+    }
+}
+
+LPA_star_planner::LPA_star_planner(std::shared_ptr<Availability_grid> availability_grid) :
+                                                                                 A_star_planner(availability_grid),
+                                                                                 generation(0),
+                                                                                 has_search(false),
+                                                                                 number_of_grid_changes(0)
+{
+}
+
+LPA_star_planner::LPA_star_planner(const size_t width, const size_t height) :
+                                                    LPA_star_planner(std::make_shared<Availability_grid>(width, height))
+{
+}
+
+LPA_star_planner::~LPA_star_planner()
+{
+}
+
+bool LPA_star_planner::get_path(const Coord_point_2D& start,
+                                const Coord_point_2D& end,
+                                std::vector<Coord_point_2D>& path)
+{
+    const bool collect_statistics = is_collecting_search_statistics();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect_statistics);
+
+    if (not check_end_points(start, end))
+    {
+        return false;
+    }
+
+    // Only the counters are cleared, the points to visit are kept for the next query
+    lpa_points_to_visit.reset_counters();
+
+    if (start == end)
+    {
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
+    }
+
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_available(end.get_x(), end.get_y()))
+    {
+        // A move always goes to an available point, so a blocked end point can not be reached
+        print_failure(start, end);
+        return false;
+    }
+
+    if (not availability_grid->is_reachable(start, end))
+    {
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
+        return false;
+    }
+
+    // Keep the search if it is for the same end points and all changes since it are known, otherwise start over
+    if (has_search && start == search_start && end == search_end && is_search_up_to_date() &&
+        point_states.size() == width * height)
+    {
+        repair_changed_points();
+    }
+    else
+    {
+        start_new_search(start, end);
+    }
+    changed_rectangles.clear();
+    number_of_grid_changes = availability_grid->get_number_of_changes();
+
+    if (collect_statistics)
+    {
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
+    }
+
+    const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect_statistics);
+    bool path_found = compute_shortest_path();
+    if (collect_statistics)
+    {
+        search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time);
+    }
+
+    if (path_found)
+    {
+        const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect_statistics);
+        path_found = reconstruct_lpa_path(path);
+        if (collect_statistics)
+        {
+            search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
+        }
+    }
+
+    if (not path_found)
+    {
+        print_failure(start, end);
+    }
+
+    return path_found;
+}
+
+void LPA_star_planner::start_new_search(const Coord_point_2D& start, const Coord_point_2D& end)
+{
+    if (point_states.size() != width * height)
+    {
+        const Point_state unvisited_state = {0, infinite_cost, infinite_cost};
+        point_states.assign(width * height, unvisited_state);
+        lpa_points_to_visit.resize(width * height);
+        generation = 0;
+    }
+    else
+    {
+        lpa_points_to_visit.clear();
+    }
+
+    // All points of older generations have infinite costs, so the grid only needs to be reset when the generation
+    // counter wraps around
+    generation++;
+    if (generation == 0)
+    {
+        for (Point_state& state : point_states)
+        {
+            state.generation = 0;
+        }
+        generation = 1;
+    }
+
+    has_search = true;
+    search_start = start;
+    search_end = end;
+
+    // The start point is the only inconsistent point
+    const size_t start_index = start.get_flat_index(width);
+    set_costs(start_index, infinite_cost, 0);
+    lpa_points_to_visit.push_or_update(start_index, get_key(start_index));
+}
+
+void LPA_star_planner::repair_changed_points()
+{
+    for (const Coord_rectangle_2D& rectangle : changed_rectangles)
+    {
+        // The moves to the points next to a changed point may have changed too
+        const size_t min_x = rectangle.get_min_x() > 0 ? rectangle.get_min_x() - 1 : 0;
+        const size_t min_y = rectangle.get_min_y() > 0 ? rectangle.get_min_y() - 1 : 0;
+        const size_t max_x = std::min(rectangle.get_max_x() + 1, width - 1);
+        const size_t max_y = std::min(rectangle.get_max_y() + 1, height - 1);
+        for (size_t y = min_y; y <= max_y; y++)
+        {
+            for (size_t x = min_x; x <= max_x; x++)
+            {
+                update_point(x + y * width);
+            }
+        }
+    }
+}
+
+bool LPA_star_planner::compute_shortest_path()
+{
+    const bool collect = is_collecting_search_statistics();
+    const bool trace = is_recording_expansion_trace();
+
+    const size_t start_index = search_start.get_flat_index(width);
+    const size_t end_index = search_end.get_flat_index(width);
+
+    Neighbors neighbors;
+
+    size_t number_of_iterations = 0;
+    while (not lpa_points_to_visit.empty() &&
+           (lpa_points_to_visit.top_key() < get_key(end_index) ||
+            get_look_ahead_cost(end_index) != get_path_cost(end_index)))
+    {
+        // The points to visit are left as they are when cancelled, so a later query goes on from here
+        if (should_stop(number_of_iterations))
+        {
+            return false;
+        }
+        number_of_iterations++;
+
+        const size_t current_index = lpa_points_to_visit.top();
+        lpa_points_to_visit.pop();
+
+        const Cost path_cost = get_path_cost(current_index);
+        const Cost look_ahead_cost = get_look_ahead_cost(current_index);
+
+        if (collect)
+        {
+            search_statistics.number_of_expanded_points++;
+        }
+
+        if (trace)
+        {
+            // The path cost in units of a horizontal or vertical move
+            const float trace_cost = static_cast<float>(std::min(path_cost, look_ahead_cost)) /
+                                     static_cast<float>(Fixed_point_octile_cost_model::get_straight_cost());
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index), trace_cost};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        const size_t number_of_neighbors = get_neighbors(Flat_point_2D(current_index), neighbors);
+        if (path_cost > look_ahead_cost)
+        {
+            // The point got cheaper, the neighbors may get cheaper through it
+            set_costs(current_index, look_ahead_cost, look_ahead_cost);
+            for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+            {
+                const size_t neighbor_index = neighbors[neighbor_number].first.get_flat_index();
+                const Cost cost = look_ahead_cost + get_move_cost(neighbors[neighbor_number].second);
+                if (neighbor_index != start_index && cost < get_look_ahead_cost(neighbor_index))
+                {
+                    set_costs(neighbor_index, get_path_cost(neighbor_index), cost);
+                    update_points_to_visit(neighbor_index);
+                    if (collect)
+                    {
+                        search_statistics.number_of_generated_points++;
+                    }
+                }
+            }
+        }
+        else
+        {
+            // The point got more expensive, it and the neighbors that got their look-ahead cost through it are
+            // calculated again
+            set_costs(current_index, infinite_cost, look_ahead_cost);
+            update_point(current_index);
+            for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+            {
+                const size_t neighbor_index = neighbors[neighbor_number].first.get_flat_index();
+                if (path_cost != infinite_cost &&
+                    get_look_ahead_cost(neighbor_index) == path_cost + get_move_cost(neighbors[neighbor_number].second))
+                {
+                    update_point(neighbor_index);
+                    if (collect)
+                    {
+                        search_statistics.number_of_generated_points++;
+                    }
+                }
+            }
+        }
+
+        if (collect)
+        {
+            search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                              lpa_points_to_visit.size());
+        }
+    }
+
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = lpa_points_to_visit.get_number_of_pushes();
+        search_statistics.number_of_heap_pops = lpa_points_to_visit.get_number_of_pops();
+        search_statistics.scratch_bytes_touched = search_statistics.number_of_expanded_points * sizeof(Point_state) +
+                                                  search_statistics.peak_points_to_visit * sizeof(uint64_t);
+    }
+
+    return get_path_cost(end_index) != infinite_cost;
+}
+
+bool LPA_star_planner::reconstruct_lpa_path(std::vector<Coord_point_2D>& path) const
+{
+    const size_t start_index = search_start.get_flat_index(width);
+    size_t current_index = search_end.get_flat_index(width);
+    path.clear();
+    path.push_back(search_end);
+
+    // Every point on the cheapest path has a neighbor that it got its path cost from. It shouldn't take more than
+    // width x height steps to reach the start point.
+    Neighbors neighbors;
+    const size_t max_iterations = width * height;
+    size_t number_of_iterations = 0;
+    while (current_index != start_index && number_of_iterations < max_iterations)
+    {
+        number_of_iterations++;
+
+        size_t previous_index = current_index;
+        Cost previous_cost = infinite_cost;
+        const size_t number_of_neighbors = get_neighbors(Flat_point_2D(current_index), neighbors);
+        for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+        {
+            const size_t neighbor_index = neighbors[neighbor_number].first.get_flat_index();
+            const Cost neighbor_path_cost = get_path_cost(neighbor_index);
+            if (neighbor_path_cost == infinite_cost)
+            {
+                continue;
+            }
+
+            const Cost cost = neighbor_path_cost + get_move_cost(neighbors[neighbor_number].second);
+            if (cost < previous_cost)
+            {
+                previous_cost = cost;
+                previous_index = neighbor_index;
+            }
+        }
+
+        // A blocked start point is not a neighbor of the points it can move to. It is the previous point only if it
+        // can move to this point and that move is the cheapest way here, the same way as in calculate_look_ahead_cost.
+        if (not availability_grid->is_available(start_index) &&
+            get_distance(current_index % width, search_start.get_x()) <= 1 &&
+            get_distance(current_index / width, search_start.get_y()) <= 1)
+        {
+            const size_t number_of_start_neighbors = get_neighbors(Flat_point_2D(start_index), neighbors);
+            for (size_t neighbor_number = 0; neighbor_number < number_of_start_neighbors; neighbor_number++)
+            {
+                if (neighbors[neighbor_number].first.get_flat_index() == current_index &&
+                    get_move_cost(neighbors[neighbor_number].second) < previous_cost)
+                {
+                    previous_cost = get_move_cost(neighbors[neighbor_number].second);
+                    previous_index = start_index;
+                }
+            }
+        }
+
+        if (previous_index == current_index)
+        {
+            std::cerr << "ERROR: LPA_star_planner: No previous point found when reconstructing the path" << std::endl;
+            return false;
+        }
+
+        current_index = previous_index;
+        path.push_back(Coord_point_2D(Flat_point_2D(current_index), width));
+    }
+
+    if (number_of_iterations >= max_iterations)
+    {
+        std::cerr << "ERROR: Maximum iterations to reconstruct the path from start to end reached" << std::endl;
+        return false;
+    }
+
+    // Reverse the order so that the start point is first and end point is last
+    std::reverse(path.begin(), path.end());
+
+    return true;
+}
+
+LPA_star_planner::Cost LPA_star_planner::calculate_look_ahead_cost(const size_t flat_index) const
+{
+    const size_t start_index = search_start.get_flat_index(width);
+    if (flat_index == start_index)
+    {
+        return 0;
+    }
+
+    if (not availability_grid->is_available(flat_index))
+    {
+        // No move goes to a blocked point
+        return infinite_cost;
+    }
+
+    // The moves between available points are symmetric, so the points that can move to this point are the points it
+    // can move to
+    Neighbors neighbors;
+    Cost look_ahead_cost = infinite_cost;
+    const size_t number_of_neighbors = get_neighbors(Flat_point_2D(flat_index), neighbors);
+    for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+    {
+        const Cost neighbor_path_cost = get_path_cost(neighbors[neighbor_number].first.get_flat_index());
+        if (neighbor_path_cost != infinite_cost)
+        {
+            look_ahead_cost = std::min(look_ahead_cost,
+                                       neighbor_path_cost + get_move_cost(neighbors[neighbor_number].second));
+        }
+    }
+
+    // A blocked start point can still be left, but it is not among the points this point can move to
+    if (not availability_grid->is_available(start_index) &&
+        get_distance(flat_index % width, search_start.get_x()) <= 1 &&
+        get_distance(flat_index / width, search_start.get_y()) <= 1)
+    {
+        const size_t number_of_start_neighbors = get_neighbors(Flat_point_2D(start_index), neighbors);
+        for (size_t neighbor_number = 0; neighbor_number < number_of_start_neighbors; neighbor_number++)
+        {
+            if (neighbors[neighbor_number].first.get_flat_index() == flat_index)
+            {
+                look_ahead_cost = std::min(look_ahead_cost, get_move_cost(neighbors[neighbor_number].second));
+            }
+        }
+    }
+
+    return look_ahead_cost;
+}
+
+void LPA_star_planner::update_point(const size_t flat_index)
+{
+    set_costs(flat_index, get_path_cost(flat_index), calculate_look_ahead_cost(flat_index));
+    update_points_to_visit(flat_index);
+}
+
+void LPA_star_planner::update_points_to_visit(const size_t flat_index)
+{
+    if (get_path_cost(flat_index) != get_look_ahead_cost(flat_index))
+    {
+        lpa_points_to_visit.push_or_update(flat_index, get_key(flat_index));
+    }
+    else
+    {
+        lpa_points_to_visit.remove(flat_index);
+    }
+}
+
+uint64_t LPA_star_planner::get_key(const size_t flat_index) const
+{
+    const Cost cost = std::min(get_path_cost(flat_index), get_look_ahead_cost(flat_index));
+    if (cost == infinite_cost)
+    {
+        return UINT64_MAX;
+    }
+
+    // The octile cost to the end point is a consistent estimate, see Cost_model.h
+    const size_t dx = get_distance(flat_index % width, search_end.get_x());
+    const size_t dy = get_distance(flat_index / width, search_end.get_y());
+    const uint64_t cheapest_cost_to_end_point = Fixed_point_octile_cost_model::get_cheapest_cost_to_target(dx, dy);
+    return ((cost + cheapest_cost_to_end_point) << 32) | cost;
+}
+
+size_t LPA_star_planner::get_number_of_heap_pushes() const
+{
+    return lpa_points_to_visit.get_number_of_pushes();
+}
+
+size_t LPA_star_planner::get_number_of_heap_pops() const
+{
+    return lpa_points_to_visit.get_number_of_pops();
+}
+
+size_t LPA_star_planner::get_number_of_bytes() const
+{
+    return A_star_planner::get_number_of_bytes() + point_states.capacity() * sizeof(Point_state)
+           + lpa_points_to_visit.get_number_of_position_bytes();
+}
+
+void LPA_star_planner::set_grid_size(const size_t width, const size_t height)
+{
+    A_star_planner::set_grid_size(width, height);
+    has_search = false;
+}
+
+void LPA_star_planner::set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid)
+{
+    A_star_planner::set_availability_grid(availability_grid);
+    has_search = false;
+}
+
+void LPA_star_planner::set_available(const size_t x, const size_t y)
+{
+    const bool up_to_date = is_search_up_to_date();
+    A_star_planner::set_available(x, y);
+    if (up_to_date)
+    {
+        add_changed_rectangle(Coord_rectangle_2D(x, y, x, y));
+    }
+}
+
+void LPA_star_planner::set_available(const Coord_point_2D& point)
+{
+    set_available(point.get_x(), point.get_y());
+}
+
+void LPA_star_planner::set_blocked(const size_t x, size_t y)
+{
+    const bool up_to_date = is_search_up_to_date();
+    A_star_planner::set_blocked(x, y);
+    if (up_to_date)
+    {
+        add_changed_rectangle(Coord_rectangle_2D(x, y, x, y));
+    }
+}
+
+void LPA_star_planner::set_blocked(const Coord_point_2D& point)
+{
+    set_blocked(point.get_x(), point.get_y());
+}
+
+Coord_rectangle_2D LPA_star_planner::commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius)
+{
+    const bool up_to_date = is_search_up_to_date();
+    const Coord_rectangle_2D dirty_rectangle = A_star_planner::commit_path(path, halo_radius);
+
+    // Only keep the squares around the path points, the bounding rectangle of a long diagonal path covers most of the
+    // grid
+    for (size_t i = 0; i < path.size() && up_to_date; i++)
+    {
+        const size_t x = path[i].get_x();
+        const size_t y = path[i].get_y();
+        add_changed_rectangle(Coord_rectangle_2D(x > halo_radius ? x - halo_radius : 0,
+                                                 y > halo_radius ? y - halo_radius : 0,
+                                                 std::min(x + halo_radius, width - 1),
+                                                 std::min(y + halo_radius, height - 1)));
+    }
+
+    return dirty_rectangle;
+}
+
+bool LPA_star_planner::is_search_up_to_date() const
+{
+    return has_search && availability_grid && availability_grid->get_number_of_changes() == number_of_grid_changes;
+}
+
+void LPA_star_planner::add_changed_rectangle(const Coord_rectangle_2D& rectangle)
+{
+    changed_rectangles.push_back(rectangle);
+    number_of_grid_changes = availability_grid->get_number_of_changes();
+}
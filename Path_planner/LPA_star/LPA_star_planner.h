@@ -0,0 +1,159 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_STAR_PLANNER_H_
+#define LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_STAR_PLANNER_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <LPA_queue.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// This class finds a cheapest path like the A_star_planner with Lifelong Planning A* (LPA*), which keeps its
+// search state between queries for the same start and end point. When the same pair is asked for again after some
+// points have changed, only the points whose path cost is no longer consistent with their neighbors are searched again,
+// so re-routing after a small local change costs time in proportion to the change and not to the whole search.
+// Every point has its path cost g from the start point and a one step look-ahead rhs, the cheapest g of a neighbor
+// plus the cost of the move from it. A point is consistent if g equals rhs. The points to visit are the inconsistent
+// points, sorted by the key [min(g, rhs) + h, min(g, rhs)] where h is the octile cost to the end point. A point with
+// g > rhs gets g = rhs and its neighbors get a new rhs. A point with g < rhs has become more expensive, its g is set to
+// infinite and it is visited again later. The search stops when the end point is consistent and no point to visit has
+// a lower key than the end point. The path is then followed back from the end point to the neighbor with the cheapest
+// g plus move cost.
+// A change of a point only changes the moves within one point of it, so the rhs of those points is calculated again
+// at the next query. The changes must be made through the planner, i.e. set_blocked, set_available and commit_path. If
+// the availability grid has been changed directly, see Availability_grid::get_number_of_changes, or the start or end
+// point is another one than in the last query, the search starts from scratch.
+// The LPA_star_planner always uses the fixed point octile costs, 5 for a straight move and 7 for a diagonal move, since
+// the path costs are compared for equality. The cost mode of the A_star_planner is ignored. The path therefore has the
+// same cost as the path of the A_star_planner only in the fixed point octile cost mode. With the floating point costs
+// the paths can differ, since 7/5 only approximates the square root of two and paths that tie in one cost model do not
+// have to tie in the other. The search state takes 12 bytes per point on top of the A_star_planner.
+// This class is intended to be accessed by one thread since it is not thread safe.
+class LPA_star_planner : public A_star_planner
+{
+public:
+    // Create a LPA_star_planner with an already existing availability grid. The availability grid must have been
+    // initialized before calling this. The grid size will be fetched from the availability grid.
+    LPA_star_planner(std::shared_ptr<Availability_grid> availability_grid);
+    // Create a LPA_star_planner with a grid size of width x height. It will also initialize an all available
+    // width x height availability grid.
+    LPA_star_planner(const size_t width, const size_t height);
+
+    virtual ~LPA_star_planner();
+
+    // Get a path from start point to end point
+    // Returns a vector with path where first element is the start point and last is the end point
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override;
+
+    // Set a new grid size (could be costly if the grid is large). The next query starts from scratch.
+    void set_grid_size(const size_t width, const size_t height) override;
+
+    // Set a new availability grid. The next query starts from scratch.
+    void set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid) override;
+
+    // Change points and keep the changed area to repair the search state in the next query
+    void set_available(const size_t x, const size_t y) override;
+    void set_available(const Coord_point_2D& point) override;
+    void set_blocked(const size_t x, size_t y) override;
+    void set_blocked(const Coord_point_2D& point) override;
+    Coord_rectangle_2D commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius) override;
+
+    // Number of points pushed to and popped from the points to visit in the last call to get_path
+    size_t get_number_of_heap_pushes() const override;
+    size_t get_number_of_heap_pops() const override;
+
+    // Number of bytes of the grids including the LPA* state and the queue position of every point
+    size_t get_number_of_bytes() const override;
+
+private:
+    typedef uint32_t Cost;
+
+    // The path cost of a point that can not be reached
+    static const Cost infinite_cost = UINT32_MAX;
+
+    // The LPA* state of a point, only valid if the generation is the one of the current search
+    struct Point_state
+    {
+        uint32_t generation;
+        Cost path_cost;
+        Cost look_ahead_cost;
+    };
+
+    std::vector<Point_state> point_states;
+    uint32_t generation;
+    LPA_queue lpa_points_to_visit;
+
+    // The start and end point of the kept search, and if there is one
+    bool has_search;
+    Coord_point_2D search_start;
+    Coord_point_2D search_end;
+
+    // The search state is up to date with the availability grid after this many changes of it, apart from the
+    // changed rectangles that are kept to be repaired in the next query
+    size_t number_of_grid_changes;
+    std::vector<Coord_rectangle_2D> changed_rectangles;
+
+    // Start a new search from scratch for start and end
+    void start_new_search(const Coord_point_2D& start, const Coord_point_2D& end);
+
+    // Calculate the look-ahead cost of every point within one point of the changed rectangles again
+    void repair_changed_points();
+
+    // Visit the inconsistent points until the cheapest path to the end point is known. Returns false if the search was
+    // cancelled or the end point can not be reached.
+    bool compute_shortest_path();
+
+    // Follow the cheapest neighbors back from the end point to the start point
+    bool reconstruct_lpa_path(std::vector<Coord_point_2D>& path) const;
+
+    // Calculate the look-ahead cost of a point from the path costs of the points that can move to it
+    Cost calculate_look_ahead_cost(const size_t flat_index) const;
+
+    // Calculate the look-ahead cost of a point again and add or remove it from the points to visit
+    void update_point(const size_t flat_index);
+
+    // Add the point to the points to visit if it is inconsistent, otherwise remove it
+    void update_points_to_visit(const size_t flat_index);
+
+    // Get the key of a point, see LPA_star_planner. The two parts of the key are packed into one 64-bit integer.
+    uint64_t get_key(const size_t flat_index) const;
+
+    Cost get_path_cost(const size_t flat_index) const
+    {
+        const Point_state& state = point_states[flat_index];
+        return state.generation == generation ? state.path_cost : infinite_cost;
+    }
+
+    Cost get_look_ahead_cost(const size_t flat_index) const
+    {
+        const Point_state& state = point_states[flat_index];
+        return state.generation == generation ? state.look_ahead_cost : infinite_cost;
+    }
+
+    void set_costs(const size_t flat_index, const Cost path_cost, const Cost look_ahead_cost)
+    {
+        const Point_state state = {generation, path_cost, look_ahead_cost};
+        point_states[flat_index] = state;
+    }
+
+    // Check if the search state is up to date with the availability grid, see number_of_grid_changes
+    bool is_search_up_to_date() const;
+
+    // Keep a rectangle of changed points to repair and take the new number of grid changes
+    void add_changed_rectangle(const Coord_rectangle_2D& rectangle);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_LPA_STAR_LPA_STAR_PLANNER_H_
@@ -0,0 +1,246 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <LPA_star_planner.h>
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Path_planner_test_helpers.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(LPA_star_planner, Simple_open_area)
+{
+    LPA_star_planner planner(2, 2);
+    std::vector<Coord_point_2D> path;
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(2));
+    EXPECT_EQ(path.front(), Coord_point_2D(0, 0));
+    EXPECT_EQ(path.back(), Coord_point_2D(1, 1));
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(1, 1), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(1));
+}
+
+TEST(LPA_star_planner, Impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    LPA_star_planner planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    availability_grid->set_blocked(98, 98);
+    availability_grid->set_blocked(99, 98);
+    availability_grid->set_blocked(98, 99);
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+
+    // A blocked end point can not be reached
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(98, 98), path));
+
+    // A blocked start point can be left
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(98, 98), Coord_point_2D(0, 0), path));
+    EXPECT_EQ(path.front(), Coord_point_2D(98, 98));
+    EXPECT_EQ(path.back(), Coord_point_2D(0, 0));
+    expect_valid_path(*availability_grid, path);
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(98 * 7));
+}
+
+TEST(LPA_star_planner, Same_cost_as_A_star_planner)
+{
+    std::mt19937 random_generator(2019);
+
+    for (size_t grid_number = 0; grid_number < 4; grid_number++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(150, 120);
+        block_random_points(*availability_grid, 30, random_generator);
+
+        LPA_star_planner planner(availability_grid);
+        A_star_planner a_star_planner(availability_grid);
+        a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+        for (size_t query = 0; query < 30; query++)
+        {
+            const Coord_point_2D start_point = get_random_available_point(*availability_grid, random_generator);
+            const Coord_point_2D end_point = get_random_available_point(*availability_grid, random_generator);
+            expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+        }
+    }
+}
+
+// A blocked start point can be left, but only with the moves A_star_planner allows from it. The point after the start
+// must be one of them and the cheapest way to it, also when it is replanned after a change.
+TEST(LPA_star_planner, Blocked_start_same_cost_as_A_star_planner)
+{
+    std::mt19937 random_generator(2019);
+
+    for (size_t grid_number = 0; grid_number < 4; grid_number++)
+    {
+        const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(60, 50);
+        block_random_points(*availability_grid, 40, random_generator);
+
+        LPA_star_planner planner(availability_grid);
+        A_star_planner a_star_planner(availability_grid);
+        a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+        for (size_t query = 0; query < 50; query++)
+        {
+            const Coord_point_2D start_point = get_random_blocked_point(*availability_grid, random_generator);
+            const Coord_point_2D end_point = get_random_available_point(*availability_grid, random_generator);
+            expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+
+            // Block a point next to the start point through the planner and replan
+            std::uniform_int_distribution<size_t> offset_distribution(0, 2);
+            const size_t x = start_point.get_x() + offset_distribution(random_generator);
+            const size_t y = start_point.get_y() + offset_distribution(random_generator);
+            if (x >= 1 && y >= 1 && x - 1 < availability_grid->get_width() && y - 1 < availability_grid->get_height() &&
+                Coord_point_2D(x - 1, y - 1) != end_point)
+            {
+                planner.set_blocked(x - 1, y - 1);
+                expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+            }
+        }
+    }
+}
+
+TEST(LPA_star_planner, Replan_after_changes)
+{
+    std::mt19937 random_generator(2019);
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(200, 200);
+    block_random_points(*availability_grid, 20, random_generator);
+
+    LPA_star_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    const Coord_point_2D start_point(5, 5);
+    const Coord_point_2D end_point(190, 180);
+    planner.set_available(start_point);
+    planner.set_available(end_point);
+
+    // Block and free points on and next to the current path, the same start and end point are kept
+    std::uniform_int_distribution<size_t> offset_distribution(0, 2);
+    for (size_t change = 0; change < 60; change++)
+    {
+        std::vector<Coord_point_2D> path;
+        if (not planner.get_path(start_point, end_point, path))
+        {
+            break;
+        }
+        ASSERT_GT(path.size(), size_t(2));
+
+        const Coord_point_2D& path_point = path.at(1 + change * 7 % (path.size() - 2));
+        const Coord_point_2D point(path_point.get_x() + offset_distribution(random_generator) - 1,
+                                   path_point.get_y() + offset_distribution(random_generator) - 1);
+        if (point == start_point || point == end_point)
+        {
+            continue;
+        }
+
+        if (change % 3 == 2)
+        {
+            planner.set_available(point);
+        }
+        else
+        {
+            planner.set_blocked(point);
+        }
+        expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+    }
+}
+
+TEST(LPA_star_planner, Replan_expands_fewer_points)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(400, 400);
+    LPA_star_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    // A wall with an opening that the path has to go through
+    for (size_t y = 0; y < 400; y++)
+    {
+        if (y < 300 || y > 305)
+        {
+            planner.set_blocked(200, y);
+        }
+    }
+
+    const Coord_point_2D start_point(10, 390);
+    const Coord_point_2D end_point(390, 390);
+    std::vector<Coord_point_2D> path;
+    EXPECT_TRUE(planner.get_path(start_point, end_point, path));
+    const size_t first_number_of_pops = planner.get_number_of_heap_pops();
+
+    // A point far from the path is changed, nothing has to be searched again
+    planner.set_blocked(390, 10);
+    EXPECT_TRUE(planner.get_path(start_point, end_point, path));
+    EXPECT_LT(planner.get_number_of_heap_pops() * 20, first_number_of_pops);
+
+    // A point behind the end point is changed, only a few points have to be searched again
+    planner.set_blocked(20, 395);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+    EXPECT_LT(planner.get_number_of_heap_pops() * 20, first_number_of_pops);
+
+    // A committed path that doesn't cross the current path
+    std::vector<Coord_point_2D> committed_path;
+    for (size_t x = 250; x < 350; x++)
+    {
+        committed_path.push_back(Coord_point_2D(x, 100));
+    }
+    planner.commit_path(committed_path, 1);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+    EXPECT_LT(planner.get_number_of_heap_pops() * 5, first_number_of_pops);
+
+    // Narrowing the opening makes the path more expensive but is still repaired from the kept search
+    planner.set_blocked(200, 300);
+    planner.set_blocked(200, 305);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+
+    // Closing the opening makes the end point impossible to reach
+    for (size_t y = 301; y < 305; y++)
+    {
+        planner.set_blocked(200, y);
+    }
+    EXPECT_FALSE(planner.get_path(start_point, end_point, path));
+
+    // Opening it again finds the path again
+    planner.set_available(200, 302);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+}
+
+TEST(LPA_star_planner, New_end_points_and_change_outside_of_planner)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(256, 256);
+    LPA_star_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 0), Coord_point_2D(255, 0));
+
+    // Other end points start from scratch
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 10), Coord_point_2D(255, 0));
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 10), Coord_point_2D(200, 200));
+
+    // A wall changed directly in the availability grid is found since the search starts from scratch
+    for (size_t y = 0; y < 255; y++)
+    {
+        availability_grid->set_blocked(128, y);
+    }
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 10), Coord_point_2D(200, 200));
+
+    // A new availability grid of another size
+    planner.set_availability_grid(std::make_shared<Availability_grid>(50, 60));
+    a_star_planner.set_availability_grid(planner.get_availability_grid());
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 10), Coord_point_2D(49, 59));
+}
@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Legal_move_table.h>
+#include <Bit_grid_2D.h>
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+std::array<Legal_move_table::Legal_moves, 256> Legal_move_table::create_table(const Diagonal_rule diagonal_rule)
+{
+    std::array<Legal_moves, 256> table;
+
+    for (size_t mask = 0; mask < table.size(); mask++)
+    {
+        Legal_moves& legal_moves = table[mask];
+        legal_moves.number_of_moves = 0;
+        legal_moves.directions.fill(0);
+        legal_moves.legal_mask = 0;
+
+        const auto is_available = [mask](const uint8_t bit) { return ((mask >> bit) & 1) != 0; };
+
+        // A diagonal neighbor also needs one or both of the two horizontal or vertical neighbors next to it
+        const auto is_legal_diagonal = [diagonal_rule, &is_available](const uint8_t diagonal_bit,
+                                                                       const uint8_t first_side_bit,
+                                                                       const uint8_t second_side_bit)
+        {
+            switch (diagonal_rule)
+            {
+                case Diagonal_rule::no_diagonal_moves:
+                    return false;
+                case Diagonal_rule::one_side_available:
+                    return is_available(diagonal_bit) && (is_available(first_side_bit) ||
+                                                          is_available(second_side_bit));
+                case Diagonal_rule::both_sides_available:
+                    return is_available(diagonal_bit) && is_available(first_side_bit) &&
+                           is_available(second_side_bit);
+            }
+            return false;
+        };
+
+        std::array<bool, 8> is_legal;
+        is_legal[Bit_grid_2D::left_bit]  = is_available(Bit_grid_2D::left_bit);
+        is_legal[Bit_grid_2D::up_bit]    = is_available(Bit_grid_2D::up_bit);
+        is_legal[Bit_grid_2D::right_bit] = is_available(Bit_grid_2D::right_bit);
+        is_legal[Bit_grid_2D::down_bit]  = is_available(Bit_grid_2D::down_bit);
+        is_legal[Bit_grid_2D::upper_left_bit] = is_legal_diagonal(Bit_grid_2D::upper_left_bit,
+                                                                  Bit_grid_2D::up_bit,
+                                                                  Bit_grid_2D::left_bit);
+        is_legal[Bit_grid_2D::upper_right_bit] = is_legal_diagonal(Bit_grid_2D::upper_right_bit,
+                                                                   Bit_grid_2D::up_bit,
+                                                                   Bit_grid_2D::right_bit);
+        is_legal[Bit_grid_2D::lower_right_bit] = is_legal_diagonal(Bit_grid_2D::lower_right_bit,
+                                                                   Bit_grid_2D::down_bit,
+                                                                   Bit_grid_2D::right_bit);
+        is_legal[Bit_grid_2D::lower_left_bit] = is_legal_diagonal(Bit_grid_2D::lower_left_bit,
+                                                                  Bit_grid_2D::down_bit,
+                                                                  Bit_grid_2D::left_bit);
+
+        for (uint8_t direction = 0; direction < is_legal.size(); direction++)
+        {
+            if (is_legal[direction])
+            {
+                legal_moves.directions[legal_moves.number_of_moves] = direction;
+                legal_moves.number_of_moves++;
+                legal_moves.legal_mask |= uint8_t(1) << direction;
+            }
+        }
+    }
+
+    return table;
+}
+
+const std::array<Legal_move_table::Legal_moves, 256> Legal_move_table::table =
+                                                               create_table(Diagonal_rule::one_side_available);
@@ -0,0 +1,68 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_LEGAL_MOVE_TABLE_H_
+#define LINE_ROUTER_PATH_PLANNER_LEGAL_MOVE_TABLE_H_
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The legal moves from a point for every one of the 256 possible neighbor masks from
+// Availability_grid::get_neighbor_mask. A horizontal or vertical move is legal if the neighbor is available. A diagonal
+// move is legal if the diagonal neighbor is available and at least one of the two nearest horizontal or vertical
+// neighbors is available, i.e. the same rule as A_star_planner::get_neighbors.
+// The moves are given as directions which are the same as the bit numbers in Bit_grid_2D::Neighbor_bit, so directions
+// 0-3 are horizontal or vertical moves and 4-7 are diagonal moves. They are listed in increasing direction order.
+// The legal moves are also given as a mask with one bit per legal direction. A legal mask used as a neighbor mask gives
+// the same legal moves, so the table can be used with both kinds of masks.
+// Tables for other rules of the diagonal moves can be created with create_table, see Connectivity.h.
+class Legal_move_table
+{
+public:
+    struct Legal_moves
+    {
+        uint8_t number_of_moves;
+        std::array<uint8_t, 8> directions;
+        uint8_t legal_mask;
+    };
+
+    // When a diagonal move is legal
+    // no_diagonal_moves:     Never, only horizontal and vertical moves are legal.
+    // one_side_available:    The diagonal neighbor and at least one of the two nearest horizontal or vertical neighbors
+    //                        are available. This is the rule of get.
+    // both_sides_available:  The diagonal neighbor and both of the two nearest horizontal or vertical neighbors are
+    //                        available, i.e. the move does not cut the corner of a blocked point.
+    enum class Diagonal_rule
+    {
+        no_diagonal_moves,
+        one_side_available,
+        both_sides_available
+    };
+
+    // Create the legal moves of all 256 neighbor masks for a diagonal rule
+    static std::array<Legal_moves, 256> create_table(const Diagonal_rule diagonal_rule);
+
+    // Get the legal moves for a neighbor mask
+    static const Legal_moves& get(const uint8_t neighbor_mask)
+    {
+        return table[neighbor_mask];
+    }
+
+    // Check if a direction is a diagonal move
+    static bool is_diagonal(const uint8_t direction)
+    {
+        return direction >= 4;
+    }
+
+private:
+    static const std::array<Legal_moves, 256> table;
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_LEGAL_MOVE_TABLE_H_
@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_NEIGHBOR_MASK_SOURCE_H_
+#define LINE_ROUTER_PATH_PLANNER_NEIGHBOR_MASK_SOURCE_H_
+
+#include <Availability_grid.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+
+// The neighbor mask source policies decide where the neighbor mask of an expanded point is read from, see
+// Connectivity.h for how the mask is turned into legal moves. A_star_planner picks the policy once per query from
+// Availability_grid::is_legal_move_cache_enabled, so the search loop reads the mask without any runtime branching:
+// - Cached_neighbor_mask: One byte load from the legal move cache of the Availability_grid, which must be enabled.
+// - Bitboard_neighbor_mask: The availability of all eight neighbors read at once from the bitboard. Neighbors outside
+//   the border are blocked so no limit checks are needed.
+
+class Cached_neighbor_mask
+{
+public:
+    template<typename Width_policy>
+    static uint8_t get_neighbor_mask(const Availability_grid& availability_grid,
+                                     const size_t flat_index,
+                                     const Width_policy&)
+    {
+        return availability_grid.get_cached_legal_move_mask(flat_index);
+    }
+
+    static const char* get_name()
+    {
+        return "cached";
+    }
+};
+
+class Bitboard_neighbor_mask
+{
+public:
+    template<typename Width_policy>
+    static uint8_t get_neighbor_mask(const Availability_grid& availability_grid,
+                                     const size_t flat_index,
+                                     const Width_policy& grid_width)
+    {
+        return availability_grid.get_neighbor_mask(grid_width.get_x(flat_index), grid_width.get_y(flat_index));
+    }
+
+    static const char* get_name()
+    {
+        return "bitboard";
+    }
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_NEIGHBOR_MASK_SOURCE_H_
@@ -10,7 +10,11 @@
 #define LINE_ROUTER_PATH_PLANNER_PATH_PLANNER_H_
 
 #include <Availability_grid.h>
+#include <Cancellation_token.h>
 #include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Expansion_trace.h>
+#include <Search_statistics.h>
 
 // Standard library headers
 #include <cstddef>
@@ -53,6 +57,30 @@ public:
     // Set point to blocked, i.e. a path cannot pass through this point
     virtual void set_blocked(const size_t x, size_t y) = 0;
     virtual void set_blocked(const Coord_point_2D& point) = 0;
+
+    // Commit a found path, i.e. block all its points and all points within halo_radius of them so that later paths
+    // keep a distance to it. This is done in one pass over the availability grid. Returns the rectangle of points that
+    // may have changed.
+    virtual Coord_rectangle_2D commit_path(const std::vector<Coord_point_2D>& path, const size_t halo_radius) = 0;
+
+    // Set a token that is polled during get_path. If the token is cancelled or its time budget runs out get_path stops
+    // and returns false. An empty pointer removes the token.
+    virtual void set_cancellation_token(const std::shared_ptr<const Cancellation_token> cancellation_token) = 0;
+
+    // Enable or disable collecting search statistics in get_path, see Search_statistics. It is disabled by default
+    // since the counters and clock reads cost a little time per query.
+    virtual void set_search_statistics_enabled(const bool enabled) = 0;
+    virtual bool is_search_statistics_enabled() const = 0;
+
+    // Get the statistics of the last call to get_path. All values are zero if collecting them was disabled.
+    virtual const Search_statistics& get_search_statistics() const = 0;
+
+    // Enable or disable recording the points expanded by get_path, see Expansion_trace. It is disabled by default.
+    virtual void set_expansion_trace_enabled(const bool enabled) = 0;
+    virtual bool is_expansion_trace_enabled() const = 0;
+
+    // Get the points expanded by the last call to get_path. It is empty if recording them was disabled.
+    virtual const Expansion_trace& get_expansion_trace() const = 0;
 };
 
 #endif // LINE_ROUTER_PATH_PLANNER_PATH_PLANNER_H_
@@ -0,0 +1,274 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Preview_tree_planner.h>
+#include <A_star_planner.h>
+#include <Cost_model.h>
+#include <Flat_point_2D.h>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+Preview_tree_planner::Preview_tree_planner(std::shared_ptr<Availability_grid> availability_grid) :
+                                                                                 A_star_planner(availability_grid),
+                                                                                 has_tree(false),
+                                                                                 number_of_grid_changes(0),
+                                                                                 number_of_tree_points(0),
+                                                                                 number_of_pushes_before_query(0),
+                                                                                 number_of_pops_before_query(0)
+{
+}
+
+Preview_tree_planner::Preview_tree_planner(const size_t width, const size_t height) :
+                                                Preview_tree_planner(std::make_shared<Availability_grid>(width, height))
+{
+}
+
+Preview_tree_planner::~Preview_tree_planner()
+{
+}
+
+bool Preview_tree_planner::get_path(const Coord_point_2D& start,
+                                    const Coord_point_2D& end,
+                                    std::vector<Coord_point_2D>& path)
+{
+    const bool collect_statistics = is_collecting_search_statistics();
+    search_statistics = Search_statistics();
+    expansion_trace.clear();
+    const std::chrono::steady_clock::time_point reset_start_time = get_statistics_time(collect_statistics);
+
+    if (not check_end_points(start, end))
+    {
+        return false;
+    }
+
+    // The counters are kept with the tree, the last query only counts from here
+    number_of_pushes_before_query = fixed_point_points_to_visit.get_number_of_pushes();
+    number_of_pops_before_query = fixed_point_points_to_visit.get_number_of_pops();
+
+    if (start == end)
+    {
+        // Already at end point from the beginning
+        path.clear();
+        path.push_back(start);
+
+        return true;
+    }
+
+    // Clear the output path vector
+    path.clear();
+
+    if (not availability_grid->is_available(end.get_x(), end.get_y()))
+    {
+        // A move always goes to an available point, so a blocked end point can not be reached
+        print_failure(start, end);
+        return false;
+    }
+
+    if (not availability_grid->is_reachable(start, end))
+    {
+        // The end point is in another component than the start point, see Availability_grid::is_reachable
+        print_failure(start, end);
+        return false;
+    }
+
+    if (not has_tree || start != tree_start || availability_grid->get_number_of_changes() != number_of_grid_changes)
+    {
+        start_new_tree(start);
+    }
+
+    if (collect_statistics)
+    {
+        search_statistics.reset_time_ms = get_statistics_time_ms_since(reset_start_time);
+    }
+
+    const size_t end_index = end.get_flat_index(width);
+    bool path_found = search_state_grid.is_closed(end_index);
+    if (not path_found)
+    {
+        const std::chrono::steady_clock::time_point search_start_time = get_statistics_time(collect_statistics);
+        path_found = grow_tree(end_index);
+        if (collect_statistics)
+        {
+            search_statistics.search_time_ms = get_statistics_time_ms_since(search_start_time);
+        }
+    }
+
+    if (path_found)
+    {
+        // The path is in the previous points of the tree
+        const std::chrono::steady_clock::time_point reconstruct_start_time = get_statistics_time(collect_statistics);
+        path_found = reconstruct_path(start, Flat_point_2D(end_index), path);
+        if (collect_statistics)
+        {
+            search_statistics.reconstruct_time_ms = get_statistics_time_ms_since(reconstruct_start_time);
+        }
+    }
+
+    if (not path_found)
+    {
+        print_failure(start, end);
+    }
+
+    return path_found;
+}
+
+void Preview_tree_planner::start_new_tree(const Coord_point_2D& start)
+{
+    // Mark all points as unvisited without touching the grid, see Search_state_grid
+    search_state_grid.start_new_query();
+    fixed_point_points_to_visit.clear();
+    number_of_pushes_before_query = 0;
+    number_of_pops_before_query = 0;
+
+    has_tree = true;
+    tree_start = start;
+    number_of_grid_changes = availability_grid->get_number_of_changes();
+    number_of_tree_points = 0;
+
+    // The start point has zero cost
+    const size_t start_index = start.get_flat_index(width);
+    search_state_grid.set(start_index, uint32_t(0), start_index);
+    fixed_point_points_to_visit.push(start_index, 0);
+}
+
+bool Preview_tree_planner::grow_tree(const size_t end_index)
+{
+    const bool collect = is_collecting_search_statistics();
+    const bool trace = is_recording_expansion_trace();
+
+    Neighbors neighbors;
+
+    size_t number_of_iterations = 0;
+    while (not fixed_point_points_to_visit.empty())
+    {
+        // The points to visit are left as they are when cancelled, so the next query goes on growing the tree
+        if (should_stop(number_of_iterations))
+        {
+            return false;
+        }
+        number_of_iterations++;
+
+        // The tree is grown in the order of the path cost, there is no estimate of the cost to the end point since the
+        // tree is used for every end point
+        const size_t current_index = fixed_point_points_to_visit.top();
+        fixed_point_points_to_visit.pop();
+
+        if (search_state_grid.is_closed(current_index))
+        {
+            // An old entry of a point that has been pushed again with a lower cost, see Bucket_queue
+            if (collect)
+            {
+                search_statistics.number_of_stale_pops++;
+            }
+            continue;
+        }
+
+        // The path cost of the current point can not be lowered any more so it is closed
+        search_state_grid.set_closed(current_index);
+        number_of_tree_points++;
+
+        const uint32_t path_cost_current_point = search_state_grid.get_path_cost<uint32_t>(current_index);
+
+        if (collect)
+        {
+            search_statistics.number_of_expanded_points++;
+        }
+
+        if (trace)
+        {
+            // The path cost in units of a horizontal or vertical move
+            const float path_cost = static_cast<float>(path_cost_current_point) /
+                                    static_cast<float>(Fixed_point_octile_cost_model::get_straight_cost());
+            const Expanded_point expanded_point = {static_cast<uint32_t>(current_index), path_cost};
+            expansion_trace.push_back(expanded_point);
+        }
+
+        const size_t number_of_neighbors = get_neighbors(Flat_point_2D(current_index), neighbors);
+        for (size_t neighbor_number = 0; neighbor_number < number_of_neighbors; neighbor_number++)
+        {
+            const size_t neighbor_index = neighbors[neighbor_number].first.get_flat_index();
+            if (search_state_grid.is_closed(neighbor_index))
+            {
+                // The cheapest path to a closed point has already been found
+                continue;
+            }
+
+            const uint32_t path_cost = path_cost_current_point +
+                                       (neighbors[neighbor_number].second ?
+                                                                  Fixed_point_octile_cost_model::get_diagonal_cost() :
+                                                                  Fixed_point_octile_cost_model::get_straight_cost());
+            if (path_cost < search_state_grid.get_path_cost<uint32_t>(neighbor_index))
+            {
+                if (collect)
+                {
+                    search_statistics.number_of_generated_points++;
+                    search_statistics.number_of_visited_points +=
+                                                               search_state_grid.is_visited(neighbor_index) ? 0 : 1;
+                }
+
+                search_state_grid.set(neighbor_index, path_cost, current_index);
+                fixed_point_points_to_visit.push(neighbor_index, path_cost);
+            }
+        }
+
+        if (collect)
+        {
+            search_statistics.peak_points_to_visit = std::max(search_statistics.peak_points_to_visit,
+                                                              fixed_point_points_to_visit.size());
+        }
+
+        if (current_index == end_index)
+        {
+            // The rest of the points to visit are kept to grow the tree further in the next query
+            break;
+        }
+    }
+
+    if (collect)
+    {
+        search_statistics.number_of_heap_pushes = get_number_of_heap_pushes();
+        search_statistics.number_of_heap_pops = get_number_of_heap_pops();
+        search_statistics.scratch_bytes_touched =
+                               search_statistics.number_of_visited_points * Search_state_grid::get_bytes_per_point() +
+                               search_statistics.peak_points_to_visit * sizeof(size_t);
+    }
+
+    return search_state_grid.is_closed(end_index);
+}
+
+void Preview_tree_planner::set_grid_size(const size_t width, const size_t height)
+{
+    A_star_planner::set_grid_size(width, height);
+    has_tree = false;
+}
+
+void Preview_tree_planner::set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid)
+{
+    A_star_planner::set_availability_grid(availability_grid);
+    has_tree = false;
+}
+
+size_t Preview_tree_planner::get_number_of_heap_pushes() const
+{
+    return fixed_point_points_to_visit.get_number_of_pushes() - number_of_pushes_before_query;
+}
+
+size_t Preview_tree_planner::get_number_of_heap_pops() const
+{
+    return fixed_point_points_to_visit.get_number_of_pops() - number_of_pops_before_query;
+}
+
+size_t Preview_tree_planner::get_number_of_tree_points() const
+{
+    return number_of_tree_points;
+}
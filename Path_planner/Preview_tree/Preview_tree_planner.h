@@ -0,0 +1,86 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_PREVIEW_TREE_PREVIEW_TREE_PLANNER_H_
+#define LINE_ROUTER_PATH_PLANNER_PREVIEW_TREE_PREVIEW_TREE_PLANNER_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// This class is for the live preview of a route while the mouse moves after the start point has been set. Many end
+// points are asked for with the same start point, so instead of one A* search per end point it grows one Dijkstra
+// search tree from the start point and keeps it between queries. The points are closed in the order of their path cost
+// from the start point, which does not depend on the end point. If the end point is already closed its path is read
+// straight from the previous points of the search state, which costs time in proportion to the path length. Otherwise
+// the tree is grown until the end point is closed, which only closes the points that are cheaper than the end point and
+// are not in the tree yet.
+// A new start point, a new availability grid or any change of the availability grid, see
+// Availability_grid::get_number_of_changes, starts a new tree in the next query. A cancelled query keeps the tree and
+// its points to visit, so the next query continues growing it.
+// The tree always uses the fixed point octile costs, i.e. the bucket queue of the A_star_planner, and the path has the
+// same cost as the A_star_planner path with Cost_mode::fixed_point_octile. The cost mode is not used.
+// This class is intended to be accessed by one thread since it is not thread safe.
+class Preview_tree_planner : public A_star_planner
+{
+public:
+    // Create a Preview_tree_planner with an already existing availability grid. The availability grid must have been
+    // initialized before calling this. The grid size will be fetched from the availability grid.
+    Preview_tree_planner(std::shared_ptr<Availability_grid> availability_grid);
+    // Create a Preview_tree_planner with a grid size of width x height. It will also initialize an all available
+    // width x height availability grid.
+    Preview_tree_planner(const size_t width, const size_t height);
+
+    virtual ~Preview_tree_planner();
+
+    // Get a path from start point to end point. The search tree of the start point is kept for the next query.
+    // Returns a vector with path where first element is the start point and last is the end point
+    bool get_path(const Coord_point_2D& start, const Coord_point_2D& end, std::vector<Coord_point_2D>& path) override;
+
+    // Set a new grid size (could be costly if the grid is large). The next query starts a new tree.
+    void set_grid_size(const size_t width, const size_t height) override;
+
+    // Set a new availability grid. The next query starts a new tree.
+    void set_availability_grid(const std::shared_ptr<Availability_grid> availability_grid) override;
+
+    // Number of points pushed to and popped from the points to visit in the last call to get_path, i.e. the growth of
+    // the tree for that query
+    size_t get_number_of_heap_pushes() const override;
+    size_t get_number_of_heap_pops() const override;
+
+    // Number of closed points in the tree
+    size_t get_number_of_tree_points() const;
+
+private:
+    // The start point of the kept tree, and if there is one
+    bool has_tree;
+    Coord_point_2D tree_start;
+
+    // The tree is up to date with the availability grid after this many changes of it
+    size_t number_of_grid_changes;
+
+    size_t number_of_tree_points;
+
+    // The counters of the points to visit when the last query started
+    size_t number_of_pushes_before_query;
+    size_t number_of_pops_before_query;
+
+    // Start a new tree with only the start point in the points to visit
+    void start_new_tree(const Coord_point_2D& start);
+
+    // Close points in the order of their path cost until the end point is closed. Returns false if the search was
+    // cancelled or the end point can not be reached.
+    bool grow_tree(const size_t end_index);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_PREVIEW_TREE_PREVIEW_TREE_PLANNER_H_
@@ -0,0 +1,165 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Preview_tree_planner.h>
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Cancellation_token.h>
+#include <Coord_point_2D.h>
+#include <Path_planner_test_helpers.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(Preview_tree_planner, Simple_open_area)
+{
+    Preview_tree_planner planner(2, 2);
+    std::vector<Coord_point_2D> path;
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(2));
+    EXPECT_EQ(path.front(), Coord_point_2D(0, 0));
+    EXPECT_EQ(path.back(), Coord_point_2D(1, 1));
+
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(1, 1), Coord_point_2D(1, 1), path));
+    ASSERT_EQ(path.size(), size_t(1));
+}
+
+TEST(Preview_tree_planner, Impossible_to_reach_end_point)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(100, 100);
+    Preview_tree_planner planner(availability_grid);
+    std::vector<Coord_point_2D> path;
+
+    availability_grid->set_blocked(98, 98);
+    availability_grid->set_blocked(99, 98);
+    availability_grid->set_blocked(98, 99);
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+    EXPECT_EQ(planner.get_number_of_tree_points(), size_t(100 * 100 - 4));
+
+    // The tree is complete, so another point that can not be reached fails without growing it
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(99, 99), path));
+    EXPECT_EQ(planner.get_number_of_heap_pops(), size_t(0));
+
+    // A blocked end point can not be reached
+    EXPECT_FALSE(planner.get_path(Coord_point_2D(0, 0), Coord_point_2D(98, 98), path));
+
+    // A blocked start point can be left
+    EXPECT_TRUE(planner.get_path(Coord_point_2D(98, 98), Coord_point_2D(0, 0), path));
+    EXPECT_EQ(path.front(), Coord_point_2D(98, 98));
+    expect_valid_path(*availability_grid, path);
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(98 * 7));
+}
+
+TEST(Preview_tree_planner, Same_cost_as_A_star_planner)
+{
+    std::mt19937 random_generator(2019);
+
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(150, 120);
+    block_random_points(*availability_grid, 30, random_generator);
+
+    Preview_tree_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    // A few start points with many end points each, like a mouse that moves around after the first click
+    for (size_t start_number = 0; start_number < 4; start_number++)
+    {
+        const Coord_point_2D start_point = get_random_available_point(*availability_grid, random_generator);
+        for (size_t query = 0; query < 40; query++)
+        {
+            const Coord_point_2D end_point = get_random_available_point(*availability_grid, random_generator);
+            expect_same_cost_as_a_star(planner, a_star_planner, start_point, end_point);
+        }
+    }
+}
+
+TEST(Preview_tree_planner, Tree_is_reused)
+{
+    Preview_tree_planner planner(500, 500);
+    std::vector<Coord_point_2D> path;
+
+    const Coord_point_2D start_point(250, 250);
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(350, 250), path));
+    const size_t first_number_of_pops = planner.get_number_of_heap_pops();
+    const size_t first_number_of_tree_points = planner.get_number_of_tree_points();
+    EXPECT_GT(first_number_of_pops, size_t(10000));
+
+    // A closer end point is read from the tree without growing it
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(300, 280), path));
+    EXPECT_EQ(planner.get_number_of_heap_pops(), size_t(0));
+    EXPECT_EQ(planner.get_number_of_tree_points(), first_number_of_tree_points);
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(30 * 7 + 20 * 5));
+
+    // A mouse move one step further out only grows the tree by the points of about the same path cost
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(351, 250), path));
+    EXPECT_LT(planner.get_number_of_heap_pops() * 20, first_number_of_pops);
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(101 * 5));
+}
+
+TEST(Preview_tree_planner, New_tree_after_changes)
+{
+    const std::shared_ptr<Availability_grid> availability_grid = std::make_shared<Availability_grid>(200, 200);
+    Preview_tree_planner planner(availability_grid);
+    A_star_planner a_star_planner(availability_grid);
+    a_star_planner.set_cost_mode(A_star_planner::Cost_mode::fixed_point_octile);
+
+    const Coord_point_2D start_point(10, 100);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, Coord_point_2D(190, 100));
+
+    // A committed line through the planner
+    std::vector<Coord_point_2D> line;
+    for (size_t y = 20; y < 180; y++)
+    {
+        line.push_back(Coord_point_2D(100, y));
+    }
+    planner.commit_path(line, 1);
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, Coord_point_2D(190, 100));
+
+    // A wall changed directly in the availability grid
+    for (size_t x = 0; x < 199; x++)
+    {
+        availability_grid->set_blocked(x, 150);
+    }
+    expect_same_cost_as_a_star(planner, a_star_planner, start_point, Coord_point_2D(190, 190));
+
+    // Another start point
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(190, 10), Coord_point_2D(190, 190));
+
+    // A new availability grid of another size
+    planner.set_availability_grid(std::make_shared<Availability_grid>(50, 60));
+    a_star_planner.set_availability_grid(planner.get_availability_grid());
+    expect_same_cost_as_a_star(planner, a_star_planner, Coord_point_2D(0, 10), Coord_point_2D(49, 59));
+}
+
+TEST(Preview_tree_planner, Cancelled_growth_is_continued)
+{
+    Preview_tree_planner planner(300, 300);
+    std::vector<Coord_point_2D> path;
+
+    const Coord_point_2D start_point(0, 0);
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(50, 50), path));
+
+    // A cancelled query keeps the tree and its points to visit
+    const std::shared_ptr<Cancellation_token> cancellation_token = std::make_shared<Cancellation_token>();
+    cancellation_token->cancel();
+    planner.set_cancellation_token(cancellation_token);
+    EXPECT_FALSE(planner.get_path(start_point, Coord_point_2D(299, 299), path));
+
+    planner.set_cancellation_token(nullptr);
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(299, 299), path));
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(299 * 7));
+    EXPECT_TRUE(planner.get_path(start_point, Coord_point_2D(50, 50), path));
+    EXPECT_EQ(get_fixed_point_path_cost(path), size_t(50 * 7));
+}
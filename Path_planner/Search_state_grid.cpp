@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Search_state_grid.h>
+#include <Flat_grid_2D.h>
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+Search_state_grid::Search_state_grid(const size_t width, const size_t height) :
+                                                                      generation(0),
+                                                                      runtime_width(width),
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+                                                                      point_records(width, height, Point_record())
+#else
+                                                                      generation_grid(width, height, 0),
+                                                                      path_cost_grid(width, height, 0),
+                                                                      direction_grid(width, height, 0),
+                                                                      heap_index_grid(width, height, 0)
+#endif
+{
+    check_size(width, height);
+    set_direction_offsets(width);
+}
+
+Search_state_grid::~Search_state_grid()
+{
+}
+
+size_t Search_state_grid::get_width() const
+{
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+    return point_records.get_width();
+#else
+    return generation_grid.get_width();
+#endif
+}
+
+size_t Search_state_grid::get_height() const
+{
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+    return point_records.get_height();
+#else
+    return generation_grid.get_height();
+#endif
+}
+
+void Search_state_grid::resize(const size_t width, const size_t height)
+{
+    check_size(width, height);
+    set_direction_offsets(width);
+    runtime_width = Runtime_width(width);
+
+    // Points kept from before the resize could have a stamp that matches a later generation, reset all of them
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+    point_records.resize(width, height, Point_record());
+    point_records.fill(Point_record());
+#else
+    generation_grid.resize(width, height, 0);
+    path_cost_grid.resize(width, height, 0);
+    direction_grid.resize(width, height, 0);
+    heap_index_grid.resize(width, height, 0);
+
+    generation_grid.fill(0);
+#endif
+    generation = 0;
+}
+
+void Search_state_grid::start_new_query()
+{
+    generation++;
+
+    // The generation is stored shifted up by one bit so only 31 bits are available
+    if (generation == (uint32_t(1) << 31))
+    {
+        // The generation counter has wrapped around. Old stamps could now match the new generations, reset all of them.
+        // This happens once every 2^31 queries.
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        point_records.fill(Point_record());
+#else
+        generation_grid.fill(0);
+#endif
+        generation = 1;
+    }
+}
+
+void Search_state_grid::check_size(const size_t width, const size_t height)
+{
+    if (width * height > get_max_number_of_points())
+    {
+        throw "Search_state_grid::check_size: The grid has more points than the search state layout can hold";
+    }
+}
+
+void Search_state_grid::set_direction_offsets(const size_t width)
+{
+    signed_width = static_cast<ptrdiff_t>(width);
+    for (size_t direction = 0; direction < direction_offsets.size(); direction++)
+    {
+        // The offset is dx + dy * width with dx and dy in [-1, 1], the unsigned wrap around gives the negative offsets
+        direction_offsets[direction] = (direction % 3) + (direction / 3) * width - 1 - width;
+    }
+}
@@ -0,0 +1,365 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_SEARCH_STATE_GRID_H_
+#define LINE_ROUTER_PATH_PLANNER_SEARCH_STATE_GRID_H_
+
+#include <Flat_grid_2D.h>
+#include <Grid_layout.h>
+#include <Grid_width.h>
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// This grid keeps the search state of every point for one path planning query, i.e. the path cost from the start point,
+// the previous point on the path, if the point is closed and its index in the points to visit heap. The path cost is
+// stored as 32 bits which is either a float or a fixed point uint32_t cost, see Cost_model.h. The previous point is
+// always one of the eight neighbors of the point, or the point itself for the start point, so it is stored as a one
+// byte direction code and the flat index of the previous point is found by subtracting the flat index offset of the
+// direction. Every point is stamped with the generation of the query that last wrote to it. A point counts as unvisited
+// unless its stamp matches the current generation, so starting a new query only increases the generation instead of
+// resetting the whole grid. The cost of a query then scales with the number of points visited and not with the grid
+// size.
+// The state is stored in one of two layouts, chosen at compile time:
+// - One grid per field (structure of arrays), the default, 13 bytes per point. Expanding a point reads the stamp, the
+//   path cost and the direction of every neighbor from three grids, i.e. three cache lines per neighbor on a large
+//   grid.
+// - One 16 byte record per point with all the fields (array of structures) if LINE_ROUTER_SEARCH_STATE_RECORDS is
+//   defined, which is controlled by the CMake option with the same name. The fields of a neighbor are then in one cache
+//   line.
+// The heap index is stored as 32 bits, so the grid can have at most 2^32 points.
+// Where the grids store the points is decided by the grid layout, see Grid_layout.h, which is chosen at compile time
+// with the CMake option LINE_ROUTER_GRID_LAYOUT. The default is the range checked row major layout. The accessors take
+// the width policy of the path planner, so a tiled layout finds the tile without a division for the widths the planner
+// is specialized for.
+// The layouts can be compared with the benchmarks, see README.md.
+// See Flat_grid_2D for more information about the flattened grid.
+class Search_state_grid
+{
+public:
+    // The grid layout of the search state, see the class description
+#if defined(LINE_ROUTER_GRID_LAYOUT_UNCHECKED_ROW_MAJOR)
+    typedef Unchecked_row_major Layout;
+#elif defined(LINE_ROUTER_GRID_LAYOUT_TILE_SIZE)
+    typedef Tiled<LINE_ROUTER_GRID_LAYOUT_TILE_SIZE> Layout;
+#else
+    typedef Checked_row_major Layout;
+#endif
+
+    // Creates a width x height grid where all points are unvisited
+    Search_state_grid(const size_t width, const size_t height);
+    virtual ~Search_state_grid();
+
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Number of bytes of search state stored per point, i.e. the generation, path cost, heap index and direction to the
+    // previous point
+    static size_t get_bytes_per_point()
+    {
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        return sizeof(Point_record);
+#else
+        return 3 * sizeof(uint32_t) + sizeof(uint8_t);
+#endif
+    }
+
+    // Number of bytes of search state stored for all points, including the padding of a tiled layout
+    size_t get_number_of_bytes() const
+    {
+        return Layout(get_width(), get_height()).get_storage_size() * get_bytes_per_point();
+    }
+
+    // The maximum number of points of the grid, limited by the 32 bit heap index
+    static size_t get_max_number_of_points()
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    // The name of the layout that is compiled in, for the benchmark output
+    static const char* get_layout_name()
+    {
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        return "point records";
+#else
+        return "separate grids";
+#endif
+    }
+
+    // The name of the grid layout that is compiled in, for the benchmark output
+    static const char* get_grid_layout_name()
+    {
+        return Layout::get_name();
+    }
+
+    // Resize the grid. All points will be unvisited after a resize.
+    void resize(const size_t width, const size_t height);
+
+    // Start a new query, all points will count as unvisited. The whole grid is only reset when the generation counter
+    // wraps around.
+    void start_new_query();
+
+    // The accessors of a point below take the width policy of the flat index as an optional last argument, see
+    // Grid_width.h. A tiled layout needs the x and y coordinates of the point on every access, so a path planner that
+    // is specialized for a width passes its policy instead of dividing by the width. Without it the width is only known
+    // at runtime. The storage index of the point is calculated once for all the fields.
+
+    // Check if the point has been visited in the current query
+    template<typename Width_policy>
+    bool is_visited(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return (get_generation_bits(get_storage_index(flat_index, grid_width)) >> 1) == generation;
+    }
+    bool is_visited(const size_t flat_index) const
+    {
+        return is_visited(flat_index, runtime_width);
+    }
+
+    // Check if the point has been closed in the current query, i.e. it has been visited with the cheapest path cost and
+    // will not be visited again
+    template<typename Width_policy>
+    bool is_closed(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return get_generation_bits(get_storage_index(flat_index, grid_width)) == ((generation << 1) | 1);
+    }
+    bool is_closed(const size_t flat_index) const
+    {
+        return is_closed(flat_index, runtime_width);
+    }
+
+    // Get the path cost from the start point to the point. The path cost is infinite, or the maximum value for integer
+    // costs, if the point has not been visited in the current query. Cost must be the same type as it was set with.
+    template<typename Cost = float, typename Width_policy>
+    Cost get_path_cost(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        static_assert(sizeof(Cost) == sizeof(uint32_t), "Search_state_grid: Path cost must be 32 bits");
+
+        const size_t storage_index = get_storage_index(flat_index, grid_width);
+        if ((get_generation_bits(storage_index) >> 1) != generation)
+        {
+            return std::numeric_limits<Cost>::has_infinity ? std::numeric_limits<Cost>::infinity()
+                                                           : std::numeric_limits<Cost>::max();
+        }
+
+        const uint32_t path_cost_bits = get_path_cost_bits(storage_index);
+        Cost path_cost;
+        std::memcpy(&path_cost, &path_cost_bits, sizeof(path_cost));
+        return path_cost;
+    }
+    template<typename Cost = float>
+    Cost get_path_cost(const size_t flat_index) const
+    {
+        return get_path_cost<Cost>(flat_index, runtime_width);
+    }
+
+    // Get the flat index of the previous point on the path. Only valid if the point has been visited in the current
+    // query.
+    size_t get_previous(const size_t flat_index) const
+    {
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        return flat_index - direction_offsets[point_records.get(flat_index).direction];
+#else
+        return flat_index - direction_offsets[direction_grid.get(flat_index)];
+#endif
+    }
+
+    // Set the path cost and the previous point of the point and mark it as visited, but not closed, in the current
+    // query. The previous point must be one of the eight neighbors of the point or the point itself.
+    template<typename Width_policy>
+    void set(const size_t flat_index,
+             const float path_cost,
+             const size_t previous_index,
+             const Width_policy& grid_width)
+    {
+        uint32_t path_cost_bits;
+        std::memcpy(&path_cost_bits, &path_cost, sizeof(path_cost_bits));
+        set_bits(get_storage_index(flat_index, grid_width), get_direction(flat_index, previous_index), path_cost_bits);
+    }
+    template<typename Width_policy>
+    void set(const size_t flat_index,
+             const uint32_t path_cost,
+             const size_t previous_index,
+             const Width_policy& grid_width)
+    {
+        set_bits(get_storage_index(flat_index, grid_width), get_direction(flat_index, previous_index), path_cost);
+    }
+    void set(const size_t flat_index, const float path_cost, const size_t previous_index)
+    {
+        set(flat_index, path_cost, previous_index, runtime_width);
+    }
+    void set(const size_t flat_index, const uint32_t path_cost, const size_t previous_index)
+    {
+        set(flat_index, path_cost, previous_index, runtime_width);
+    }
+
+    // Mark a visited point as closed
+    template<typename Width_policy>
+    void set_closed(const size_t flat_index, const Width_policy& grid_width)
+    {
+        const size_t storage_index = get_storage_index(flat_index, grid_width);
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        Point_record point_record = point_records.get_stored(storage_index);
+        point_record.generation = (generation << 1) | 1;
+        point_records.set_stored(storage_index, point_record);
+#else
+        generation_grid.set_stored(storage_index, (generation << 1) | 1);
+#endif
+    }
+    void set_closed(const size_t flat_index)
+    {
+        set_closed(flat_index, runtime_width);
+    }
+
+    // Position map for Indexed_d_ary_heap. The heap index is only valid while the point is in the heap.
+    template<typename Width_policy>
+    size_t get_heap_index(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        const size_t storage_index = get_storage_index(flat_index, grid_width);
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        return point_records.get_stored(storage_index).heap_index;
+#else
+        return heap_index_grid.get_stored(storage_index);
+#endif
+    }
+    size_t get_heap_index(const size_t flat_index) const
+    {
+        return get_heap_index(flat_index, runtime_width);
+    }
+
+    template<typename Width_policy>
+    void set_heap_index(const size_t flat_index, const size_t heap_index, const Width_policy& grid_width)
+    {
+        const size_t storage_index = get_storage_index(flat_index, grid_width);
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+        Point_record point_record = point_records.get_stored(storage_index);
+        point_record.heap_index = static_cast<uint32_t>(heap_index);
+        point_records.set_stored(storage_index, point_record);
+#else
+        heap_index_grid.set_stored(storage_index, static_cast<uint32_t>(heap_index));
+#endif
+    }
+    void set_heap_index(const size_t flat_index, const size_t heap_index)
+    {
+        set_heap_index(flat_index, heap_index, runtime_width);
+    }
+
+private:
+    // The generation of the current query. Zero is never used as a current generation so a newly created grid has no
+    // visited points.
+    uint32_t generation;
+
+    // The flat index offset from the previous point to the point for each direction code, see get_direction. The
+    // unsigned wrap around gives the right index when the offset is subtracted.
+    std::array<size_t, 9> direction_offsets;
+    ptrdiff_t signed_width;
+
+    // The width of the grid for the accessors that are not given a width policy
+    Runtime_width runtime_width;
+
+#ifdef LINE_ROUTER_SEARCH_STATE_RECORDS
+    // All the search state of a point. Four records fit in a 64 byte cache line, the fields are the same as the grids
+    // of the other layout.
+    struct alignas(16) Point_record
+    {
+        uint32_t generation;
+        uint32_t path_cost;
+        uint32_t heap_index;
+        uint8_t direction;
+    };
+
+    Flat_grid_2D<Point_record, Runtime_width, Layout> point_records;
+
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return point_records.get_storage_index(flat_index, grid_width);
+    }
+
+    uint32_t get_generation_bits(const size_t storage_index) const
+    {
+        return point_records.get_stored(storage_index).generation;
+    }
+
+    uint32_t get_path_cost_bits(const size_t storage_index) const
+    {
+        return point_records.get_stored(storage_index).path_cost;
+    }
+
+    void set_bits(const size_t storage_index, const uint8_t direction, const uint32_t path_cost_bits)
+    {
+        Point_record point_record = point_records.get_stored(storage_index);
+        point_record.generation = generation << 1;
+        point_record.path_cost = path_cost_bits;
+        point_record.direction = direction;
+        point_records.set_stored(storage_index, point_record);
+    }
+#else
+    // The generation of the query that last visited the point shifted up by one bit. The lowest bit is set if the point
+    // is closed. This way the closed flag is reset together with the generation.
+    Flat_grid_2D<uint32_t, Runtime_width, Layout> generation_grid;
+
+    // This grid is used to keep track of the cost from start point to the the point in the grid. Start point has
+    // a cost of zero. The bits are either a float or an uint32_t cost.
+    Flat_grid_2D<uint32_t, Runtime_width, Layout> path_cost_grid;
+
+    // This grid consists of the direction codes from the previous neighbor point visited. When the end point has been
+    // reached this grid can be used to backtrack the path to the start point.
+    Flat_grid_2D<uint8_t, Runtime_width, Layout> direction_grid;
+
+    // The index of the point in the points to visit heap
+    Flat_grid_2D<uint32_t, Runtime_width, Layout> heap_index_grid;
+
+    // All the grids have the same size and layout, so they store a point at the same index
+    template<typename Width_policy>
+    size_t get_storage_index(const size_t flat_index, const Width_policy& grid_width) const
+    {
+        return generation_grid.get_storage_index(flat_index, grid_width);
+    }
+
+    uint32_t get_generation_bits(const size_t storage_index) const
+    {
+        return generation_grid.get_stored(storage_index);
+    }
+
+    uint32_t get_path_cost_bits(const size_t storage_index) const
+    {
+        return path_cost_grid.get_stored(storage_index);
+    }
+
+    void set_bits(const size_t storage_index, const uint8_t direction, const uint32_t path_cost_bits)
+    {
+        generation_grid.set_stored(storage_index, generation << 1);
+        path_cost_grid.set_stored(storage_index, path_cost_bits);
+        direction_grid.set_stored(storage_index, direction);
+    }
+#endif
+
+    // Get the direction code (dy + 1) * 3 + (dx + 1) of the move from the previous point to the point, where code 4 is
+    // the point itself. The y step is found from the size of the flat index difference, which is more than one only for
+    // a move to another row, and then the x step from what is left. For grids narrower than three points some
+    // differences can be more than one move, but then they have the same offset so the previous point is still right.
+    uint8_t get_direction(const size_t flat_index, const size_t previous_index) const
+    {
+        const ptrdiff_t difference = static_cast<ptrdiff_t>(flat_index - previous_index);
+        const ptrdiff_t dy = (difference > 1) - (difference < -1);
+        const ptrdiff_t dx = difference - dy * signed_width;
+        return static_cast<uint8_t>((dy + 1) * 3 + dx + 1);
+    }
+
+    // Calculate the direction offsets and the signed width for the grid width
+    void set_direction_offsets(const size_t width);
+
+    // Check that the grid is not too large for the layout
+    static void check_size(const size_t width, const size_t height);
+};
+
+#endif // LINE_ROUTER_PATH_PLANNER_SEARCH_STATE_GRID_H_
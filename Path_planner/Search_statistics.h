@@ -0,0 +1,68 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_SEARCH_STATISTICS_H_
+#define LINE_ROUTER_PATH_PLANNER_SEARCH_STATISTICS_H_
+
+// Standard library headers
+#include <chrono>
+#include <cstddef>
+
+// The statistics are only collected if LINE_ROUTER_SEARCH_STATISTICS is defined, which is controlled by the CMake
+// option with the same name. Without it the counters are removed from the search loops at compile time and
+// Path_planner::get_search_statistics always returns zeros.
+#ifdef LINE_ROUTER_SEARCH_STATISTICS
+const bool search_statistics_compiled_in = true;
+#else
+const bool search_statistics_compiled_in = false;
+#endif
+
+// Statistics of one path planning query, filled by Path_planner::get_path when collecting them has been enabled with
+// Path_planner::set_search_statistics_enabled. They show where the time of a slow query goes.
+struct Search_statistics
+{
+    // Points popped from the points to visit and closed
+    size_t number_of_expanded_points = 0;
+    // Neighbors, or jump points for JPS, that got a new or lower path cost
+    size_t number_of_generated_points = 0;
+    // Distinct points written to the search state in the query
+    size_t number_of_visited_points = 0;
+
+    size_t number_of_heap_pushes = 0;
+    size_t number_of_heap_pops = 0;
+    // The largest number of points to visit at any time in the query
+    size_t peak_points_to_visit = 0;
+    // Stale entries popped from the points to visit, i.e. old entries of points that were pushed again with a lower
+    // cost and had already been closed when the old entry was popped. They are skipped and not expanded again, see
+    // Bucket_queue. A* with a consistent heuristic never expands a point twice.
+    size_t number_of_stale_pops = 0;
+
+    // Wall time split into starting the query (end point checks, clearing the points to visit and the search state),
+    // the search itself and reconstructing the path
+    double reset_time_ms = 0;
+    double search_time_ms = 0;
+    double reconstruct_time_ms = 0;
+
+    // Estimated bytes of scratch memory written by the query, i.e. the search state of the visited points and the
+    // points to visit at their peak
+    size_t scratch_bytes_touched = 0;
+};
+
+// Read the clock for the statistics only if they are collected
+inline std::chrono::steady_clock::time_point get_statistics_time(const bool collect)
+{
+    return collect ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+}
+
+// Get the time since start_time in milliseconds
+inline double get_statistics_time_ms_since(const std::chrono::steady_clock::time_point& start_time)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+#endif // LINE_ROUTER_PATH_PLANNER_SEARCH_STATISTICS_H_
@@ -0,0 +1,411 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Availability_grid.h>
+#include <Bit_grid_2D.h>
+#include <Component_index.h>
+#include <Coord_point_2D.h>
+#include <Legal_move_table.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+// Label the connected components of the available points with a flood fill over the whole grid
+std::vector<uint32_t> get_reference_components(const Availability_grid& grid)
+{
+    const int direction_dx[8] = {-1,  0, 1, 0, -1,  1, 1, -1};
+    const int direction_dy[8] = { 0, -1, 0, 1, -1, -1, 1,  1};
+
+    const size_t width = grid.get_width();
+    std::vector<uint32_t> components(width * grid.get_height(), Component_index::no_component);
+    uint32_t number_of_components = 0;
+    for (size_t start = 0; start < components.size(); start++)
+    {
+        if (components[start] != Component_index::no_component || not grid.is_available(start % width, start / width))
+        {
+            continue;
+        }
+
+        std::vector<size_t> points_to_fill(1, start);
+        components[start] = number_of_components;
+        while (not points_to_fill.empty())
+        {
+            const size_t x = points_to_fill.back() % width;
+            const size_t y = points_to_fill.back() / width;
+            points_to_fill.pop_back();
+
+            const Legal_move_table::Legal_moves& legal_moves = Legal_move_table::get(grid.get_neighbor_mask(x, y));
+            for (size_t move = 0; move < legal_moves.number_of_moves; move++)
+            {
+                const uint8_t direction = legal_moves.directions[move];
+                const size_t neighbor = (x + direction_dx[direction]) + (y + direction_dy[direction]) * width;
+                if (components[neighbor] == Component_index::no_component)
+                {
+                    components[neighbor] = number_of_components;
+                    points_to_fill.push_back(neighbor);
+                }
+            }
+        }
+        number_of_components++;
+    }
+
+    return components;
+}
+
+// Check that the component index splits the available points into the same components as a flood fill
+void expect_same_components(Availability_grid& grid)
+{
+    const std::vector<uint32_t> reference_components = get_reference_components(grid);
+
+    // The components must map one to one, in both directions
+    std::map<uint32_t, uint32_t> index_to_reference;
+    std::map<uint32_t, uint32_t> reference_to_index;
+    for (size_t y = 0; y < grid.get_height(); y++)
+    {
+        for (size_t x = 0; x < grid.get_width(); x++)
+        {
+            const uint32_t component = grid.get_component(x, y);
+            const uint32_t reference_component = reference_components[x + y * grid.get_width()];
+            ASSERT_EQ(component == Component_index::no_component,
+                      reference_component == Component_index::no_component) << "x: " << x << " y: " << y;
+            if (component == Component_index::no_component)
+            {
+                continue;
+            }
+
+            ASSERT_EQ(index_to_reference.insert(std::make_pair(component, reference_component)).first->second,
+                      reference_component) << "x: " << x << " y: " << y;
+            ASSERT_EQ(reference_to_index.insert(std::make_pair(reference_component, component)).first->second,
+                      component) << "x: " << x << " y: " << y;
+        }
+    }
+}
+
+// Check that the cached legal move masks are the same as the ones calculated from the neighbors
+void expect_same_legal_move_masks(const Availability_grid& cached_grid, const Availability_grid& grid)
+{
+    ASSERT_TRUE(cached_grid.is_legal_move_cache_enabled());
+    ASSERT_FALSE(grid.is_legal_move_cache_enabled());
+    for (size_t y = 0; y < grid.get_height(); y++)
+    {
+        for (size_t x = 0; x < grid.get_width(); x++)
+        {
+            ASSERT_EQ(cached_grid.get_legal_move_mask(x, y), grid.get_legal_move_mask(x, y)) << "x: " << x
+                                                                                             << " y: " << y;
+            ASSERT_EQ(cached_grid.get_cached_legal_move_mask(x + y * grid.get_width()), grid.get_legal_move_mask(x, y));
+        }
+    }
+}
+
+} // namespace
+
+TEST(Availability_grid, Flat_index_and_coordinates)
+{
+    Availability_grid availability_grid(10, 5);
+
+    EXPECT_TRUE(availability_grid.is_available(9, 4));
+    availability_grid.set_blocked(23);
+    EXPECT_FALSE(availability_grid.is_available(3, 2));
+    EXPECT_FALSE(availability_grid.is_available(Coord_point_2D(3, 2)));
+    availability_grid.set_available(Coord_point_2D(3, 2));
+    EXPECT_TRUE(availability_grid.is_available(23));
+
+    EXPECT_THROW(availability_grid.is_available(50), std::out_of_range);
+    EXPECT_THROW(availability_grid.set_blocked(10, 0), std::out_of_range);
+}
+
+TEST(Availability_grid, Legal_move_mask)
+{
+    // P = point, X = blocked, A = Available
+    //   A X A
+    //   A P X
+    //   A X A
+    // Only left, upper left and lower left are legal moves, the diagonals to the right are cut by the blocked corners
+    Availability_grid availability_grid(3, 3);
+    availability_grid.set_blocked(1, 0);
+    availability_grid.set_blocked(2, 1);
+    availability_grid.set_blocked(1, 2);
+
+    const uint8_t expected_mask = (1 << Bit_grid_2D::left_bit) |
+                                  (1 << Bit_grid_2D::upper_left_bit) |
+                                  (1 << Bit_grid_2D::lower_left_bit);
+    EXPECT_EQ(availability_grid.get_legal_move_mask(1, 1), expected_mask);
+
+    availability_grid.set_legal_move_cache_enabled(true);
+    EXPECT_EQ(availability_grid.get_legal_move_mask(1, 1), expected_mask);
+
+    const Legal_move_table::Legal_moves& legal_moves = Legal_move_table::get(expected_mask);
+    ASSERT_EQ(legal_moves.number_of_moves, 3);
+    EXPECT_EQ(legal_moves.directions[0], Bit_grid_2D::left_bit);
+    EXPECT_EQ(legal_moves.directions[1], Bit_grid_2D::upper_left_bit);
+    EXPECT_EQ(legal_moves.directions[2], Bit_grid_2D::lower_left_bit);
+    EXPECT_EQ(legal_moves.legal_mask, expected_mask);
+}
+
+// Randomly block and free points and check that the cache is updated the same way as if it was rebuilt every time
+TEST(Availability_grid, Legal_move_cache_is_updated_incrementally)
+{
+    const size_t grid_width  = 67;
+    const size_t grid_height = 31;
+
+    Availability_grid cached_grid(grid_width, grid_height);
+    Availability_grid grid(grid_width, grid_height);
+    cached_grid.set_legal_move_cache_enabled(true);
+
+    std::mt19937 random_generator(4711);
+    std::uniform_int_distribution<size_t> random_x(0, grid_width-1);
+    std::uniform_int_distribution<size_t> random_y(0, grid_height-1);
+    std::bernoulli_distribution random_blocked(0.6);
+
+    for (size_t round = 0; round < 20; round++)
+    {
+        for (size_t change = 0; change < 200; change++)
+        {
+            const size_t x = random_x(random_generator);
+            const size_t y = random_y(random_generator);
+            if (random_blocked(random_generator))
+            {
+                cached_grid.set_blocked(x, y);
+                grid.set_blocked(x, y);
+            }
+            else
+            {
+                cached_grid.set_available(x + y * grid_width);
+                grid.set_available(x + y * grid_width);
+            }
+        }
+        expect_same_legal_move_masks(cached_grid, grid);
+    }
+
+    // Resize and fill rebuild the cache
+    cached_grid.resize(40, 50);
+    grid.resize(40, 50);
+    expect_same_legal_move_masks(cached_grid, grid);
+
+    cached_grid.fill(false);
+    grid.fill(false);
+    expect_same_legal_move_masks(cached_grid, grid);
+}
+
+// Blocking a path with a halo must give the same grid and legal move cache as blocking every point and its neighbors
+// one by one
+TEST(Availability_grid, Block_path)
+{
+    const size_t grid_width  = 90;
+    const size_t grid_height = 60;
+
+    Availability_grid cached_grid(grid_width, grid_height);
+    Availability_grid grid(grid_width, grid_height);
+    cached_grid.set_legal_move_cache_enabled(true);
+
+    // A staircase path from the upper left corner to the lower right corner
+    std::vector<Coord_point_2D> path;
+    for (size_t i = 0; i < grid_height; i++)
+    {
+        path.push_back(Coord_point_2D(i, i));
+        path.push_back(Coord_point_2D(i+1, i));
+    }
+
+    const Coord_rectangle_2D dirty_rectangle = cached_grid.block_path(path, 1);
+    EXPECT_EQ(dirty_rectangle, Coord_rectangle_2D(0, 0, grid_height + 1, grid_height - 1));
+
+    for (const Coord_point_2D& point : path)
+    {
+        for (size_t y = point.get_y() > 0 ? point.get_y() - 1 : 0; y <= point.get_y() + 1 && y < grid_height; y++)
+        {
+            for (size_t x = point.get_x() > 0 ? point.get_x() - 1 : 0; x <= point.get_x() + 1 && x < grid_width; x++)
+            {
+                grid.set_blocked(x, y);
+            }
+        }
+    }
+
+    for (size_t y = 0; y < grid_height; y++)
+    {
+        for (size_t x = 0; x < grid_width; x++)
+        {
+            ASSERT_EQ(cached_grid.is_available(x, y), grid.is_available(x, y)) << "x: " << x << " y: " << y;
+        }
+    }
+    expect_same_legal_move_masks(cached_grid, grid);
+}
+
+// A halo radius larger than the grid blocks the whole grid. The limits of the halo must be clamped before the radius is
+// added, the largest radius would otherwise wrap around to a small square.
+TEST(Availability_grid, Block_path_with_halo_larger_than_grid)
+{
+    const size_t grid_width  = 90;
+    const size_t grid_height = 60;
+
+    for (const size_t halo_radius : {size_t(grid_width), std::numeric_limits<size_t>::max()})
+    {
+        Availability_grid cached_grid(grid_width, grid_height);
+        Availability_grid grid(grid_width, grid_height);
+        cached_grid.set_legal_move_cache_enabled(true);
+        cached_grid.set_component_index_enabled(true);
+
+        const std::vector<Coord_point_2D> path = {Coord_point_2D(grid_width - 1, grid_height - 1)};
+        const Coord_rectangle_2D dirty_rectangle = cached_grid.block_path(path, halo_radius);
+        EXPECT_EQ(dirty_rectangle, Coord_rectangle_2D(0, 0, grid_width - 1, grid_height - 1));
+
+        grid.fill(false);
+        for (size_t y = 0; y < grid_height; y++)
+        {
+            for (size_t x = 0; x < grid_width; x++)
+            {
+                ASSERT_FALSE(cached_grid.is_available(x, y)) << "x: " << x << " y: " << y;
+            }
+        }
+        expect_same_legal_move_masks(cached_grid, grid);
+
+        cached_grid.update_component_index();
+        EXPECT_FALSE(cached_grid.get_component_index().is_dirty());
+    }
+}
+
+TEST(Availability_grid, Component_index_is_updated_incrementally)
+{
+    // Not a multiple of the tile size
+    const size_t width = 150;
+    const size_t height = 100;
+    Availability_grid grid(width, height);
+
+    std::mt19937 random_generator(2019);
+    std::uniform_int_distribution<size_t> percent_distribution(0, 99);
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            if (percent_distribution(random_generator) < 35)
+            {
+                grid.set_blocked(x, y);
+            }
+        }
+    }
+
+    EXPECT_THROW(grid.get_component(0, 0), const char*);
+    grid.set_component_index_enabled(true);
+    EXPECT_TRUE(grid.is_component_index_enabled());
+    expect_same_components(grid);
+
+    // Change single points and block paths, the index follows every change
+    std::uniform_int_distribution<size_t> x_distribution(0, width - 1);
+    std::uniform_int_distribution<size_t> y_distribution(0, height - 1);
+    for (size_t change = 0; change < 20; change++)
+    {
+        for (size_t point = 0; point < 50; point++)
+        {
+            const size_t x = x_distribution(random_generator);
+            const size_t y = y_distribution(random_generator);
+            if (percent_distribution(random_generator) < 50)
+            {
+                grid.set_available(x, y);
+            }
+            else
+            {
+                grid.set_blocked(x, y);
+            }
+        }
+
+        std::vector<Coord_point_2D> path;
+        const size_t y = y_distribution(random_generator);
+        for (size_t x = 0; x < width; x += 2)
+        {
+            path.push_back(Coord_point_2D(x, y));
+        }
+        grid.block_path(path, change % 2);
+
+        expect_same_components(grid);
+    }
+
+    grid.resize(200, 130);
+    expect_same_components(grid);
+}
+
+TEST(Availability_grid, Component_index_relabels_locally)
+{
+    const size_t width = 1024;
+    Availability_grid grid(width, width);
+    grid.set_component_index_enabled(true);
+
+    // The first use labels all tiles
+    const Coord_point_2D start(10, 10);
+    const Coord_point_2D end(1000, 1000);
+    EXPECT_TRUE(grid.is_reachable(start, end));
+    const size_t number_of_tiles = (width / Component_index::tile_size) * (width / Component_index::tile_size);
+    EXPECT_EQ(grid.get_component_index().get_number_of_relabelled_tiles(), number_of_tiles);
+
+    // A closed loop around the end point splits the grid. Only the tiles along the loop are labelled again.
+    std::vector<Coord_point_2D> loop;
+    for (size_t i = 900; i <= 1010; i++)
+    {
+        loop.push_back(Coord_point_2D(i, 900));
+        loop.push_back(Coord_point_2D(i, 1010));
+        loop.push_back(Coord_point_2D(900, i));
+        loop.push_back(Coord_point_2D(1010, i));
+    }
+    grid.block_path(loop, 1);
+    EXPECT_FALSE(grid.is_reachable(start, end));
+    EXPECT_FALSE(grid.is_reachable(end, start));
+    EXPECT_TRUE(grid.is_reachable(Coord_point_2D(950, 950), end));
+    const size_t number_of_relabelled_tiles = grid.get_component_index().get_number_of_relabelled_tiles() -
+                                              number_of_tiles;
+    EXPECT_GT(number_of_relabelled_tiles, size_t(0));
+    EXPECT_LE(number_of_relabelled_tiles, size_t(9));
+
+    // Nothing is labelled if nothing has changed
+    EXPECT_FALSE(grid.is_reachable(start, end));
+    EXPECT_EQ(grid.get_component_index().get_number_of_relabelled_tiles(),
+              number_of_tiles + number_of_relabelled_tiles);
+
+    // A blocked end point can not be reached but a blocked start point can be left
+    grid.set_blocked(20, 20);
+    EXPECT_FALSE(grid.is_reachable(start, Coord_point_2D(20, 20)));
+    EXPECT_TRUE(grid.is_reachable(Coord_point_2D(20, 20), start));
+    EXPECT_FALSE(grid.is_reachable(Coord_point_2D(900, 900), end));
+
+    // The index is always true when disabled
+    grid.set_component_index_enabled(false);
+    EXPECT_TRUE(grid.is_reachable(start, end));
+}
+
+TEST(Availability_grid, Number_of_bytes)
+{
+    const size_t width = 1024;
+    Availability_grid grid(width, width);
+
+    // One bit per point and the border
+    const size_t bitboard_bytes = grid.get_number_of_bytes();
+    EXPECT_GE(bitboard_bytes, width * width / 8);
+    EXPECT_LE(bitboard_bytes, (width + 128) * (width + 2) / 8 + (width + 128) / 8);
+
+    // One byte per point for the legal move cache, freed when it is disabled
+    grid.set_legal_move_cache_enabled(true);
+    EXPECT_EQ(grid.get_number_of_bytes(), bitboard_bytes + width * width);
+    grid.set_legal_move_cache_enabled(false);
+    EXPECT_EQ(grid.get_number_of_bytes(), bitboard_bytes);
+
+    // At least two bytes per point for the component labels
+    grid.set_component_index_enabled(true);
+    EXPECT_TRUE(grid.is_reachable(Coord_point_2D(0, 0), Coord_point_2D(width - 1, width - 1)));
+    EXPECT_GE(grid.get_number_of_bytes(), bitboard_bytes + 2 * width * width);
+    grid.set_component_index_enabled(false);
+    EXPECT_EQ(grid.get_number_of_bytes(), bitboard_bytes);
+}
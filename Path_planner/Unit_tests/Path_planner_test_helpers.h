@@ -0,0 +1,159 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_PATH_PLANNER_UNIT_TESTS_PATH_PLANNER_TEST_HELPERS_H_
+#define LINE_ROUTER_PATH_PLANNER_UNIT_TESTS_PATH_PLANNER_TEST_HELPERS_H_
+
+#include <A_star_planner.h>
+#include <Availability_grid.h>
+#include <Coord_point_2D.h>
+#include <Path_planner.h>
+
+// Google test header
+#include <gtest/gtest.h>
+
+// Standard library headers
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Helpers shared by the unit tests of the path planners, i.e. path checks, random boards and the comparison of a path
+// planner with the A_star_planner
+
+// Calculate the cost of a path, a horizontal or vertical step costs one and a diagonal step sqrt(2)
+inline double get_path_cost(const std::vector<Coord_point_2D>& path)
+{
+    double cost = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        const bool is_diagonal = path.at(i).get_x() != path.at(i-1).get_x() &&
+                                 path.at(i).get_y() != path.at(i-1).get_y();
+        cost += is_diagonal ? 1.4142136 : 1;
+    }
+    return cost;
+}
+
+// Calculate the fixed point cost of a path, a horizontal or vertical step costs 5 and a diagonal step 7, see
+// Fixed_point_octile_cost_model
+inline size_t get_fixed_point_path_cost(const std::vector<Coord_point_2D>& path)
+{
+    size_t cost = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        const bool is_diagonal = path.at(i).get_x() != path.at(i-1).get_x() &&
+                                 path.at(i).get_y() != path.at(i-1).get_y();
+        cost += is_diagonal ? 7 : 5;
+    }
+    return cost;
+}
+
+// Check that every step in the path is a move that A_star_planner::get_neighbors would allow
+inline void expect_valid_path(const Availability_grid& availability_grid, const std::vector<Coord_point_2D>& path)
+{
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        const Coord_point_2D& from = path.at(i-1);
+        const Coord_point_2D& to = path.at(i);
+
+        const size_t dx = from.get_x() > to.get_x() ? from.get_x() - to.get_x() : to.get_x() - from.get_x();
+        const size_t dy = from.get_y() > to.get_y() ? from.get_y() - to.get_y() : to.get_y() - from.get_y();
+        ASSERT_LE(dx, size_t(1));
+        ASSERT_LE(dy, size_t(1));
+        ASSERT_TRUE(dx != 0 || dy != 0);
+        ASSERT_TRUE(availability_grid.is_available(to));
+
+        if (dx != 0 && dy != 0)
+        {
+            EXPECT_TRUE(availability_grid.is_available(to.get_x(), from.get_y()) ||
+                        availability_grid.is_available(from.get_x(), to.get_y()));
+        }
+    }
+}
+
+// Block a random share of the points in percent
+inline void block_random_points(Availability_grid& availability_grid,
+                                const size_t percent_blocked,
+                                std::mt19937& random_generator)
+{
+    std::uniform_int_distribution<size_t> percent_distribution(0, 99);
+    for (size_t y = 0; y < availability_grid.get_height(); y++)
+    {
+        for (size_t x = 0; x < availability_grid.get_width(); x++)
+        {
+            if (percent_distribution(random_generator) < percent_blocked)
+            {
+                availability_grid.set_blocked(x, y);
+            }
+        }
+    }
+}
+
+// Get a random available point
+inline Coord_point_2D get_random_available_point(const Availability_grid& availability_grid,
+                                                 std::mt19937& random_generator)
+{
+    std::uniform_int_distribution<size_t> x_distribution(0, availability_grid.get_width() - 1);
+    std::uniform_int_distribution<size_t> y_distribution(0, availability_grid.get_height() - 1);
+    while (true)
+    {
+        const Coord_point_2D point(x_distribution(random_generator), y_distribution(random_generator));
+        if (availability_grid.is_available(point))
+        {
+            return point;
+        }
+    }
+}
+
+// Get a random blocked point
+inline Coord_point_2D get_random_blocked_point(const Availability_grid& availability_grid,
+                                               std::mt19937& random_generator)
+{
+    std::uniform_int_distribution<size_t> x_distribution(0, availability_grid.get_width() - 1);
+    std::uniform_int_distribution<size_t> y_distribution(0, availability_grid.get_height() - 1);
+    while (true)
+    {
+        const Coord_point_2D point(x_distribution(random_generator), y_distribution(random_generator));
+        if (not availability_grid.is_available(point))
+        {
+            return point;
+        }
+    }
+}
+
+// Get a path with both planners and check that they both find a path or both fail and that the paths have the same
+// cost. The cost is calculated like in the cost mode of the A_star_planner, fixed point paths only need to tie in the
+// fixed point cost.
+inline void expect_same_cost_as_a_star(Path_planner& planner,
+                                       A_star_planner& a_star_planner,
+                                       const Coord_point_2D& start_point,
+                                       const Coord_point_2D& end_point)
+{
+    std::vector<Coord_point_2D> path;
+    std::vector<Coord_point_2D> a_star_path;
+    const bool path_found = planner.get_path(start_point, end_point, path);
+    ASSERT_EQ(path_found, a_star_planner.get_path(start_point, end_point, a_star_path)) << "From " << start_point
+                                                                                         << " to " << end_point;
+    if (path_found)
+    {
+        ASSERT_EQ(path.front(), start_point);
+        ASSERT_EQ(path.back(), end_point);
+        expect_valid_path(*planner.get_availability_grid(), path);
+        if (a_star_planner.get_cost_mode() == A_star_planner::Cost_mode::fixed_point_octile)
+        {
+            EXPECT_EQ(get_fixed_point_path_cost(path), get_fixed_point_path_cost(a_star_path)) << "From " << start_point
+                                                                                               << " to " << end_point;
+        }
+        else
+        {
+            EXPECT_NEAR(get_path_cost(path), get_path_cost(a_star_path), 1e-3) << "From " << start_point << " to "
+                                                                               << end_point;
+        }
+    }
+}
+
+#endif // LINE_ROUTER_PATH_PLANNER_UNIT_TESTS_PATH_PLANNER_TEST_HELPERS_H_
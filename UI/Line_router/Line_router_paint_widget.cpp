@@ -7,55 +7,128 @@
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include <Line_router_paint_widget.h>
+#include <Line_router_worker.h>
 #include <Path_planner.h>
-#include <Coord_point_2D.h>
+#include <Cancellation_token.h>
+#include <Search_statistics.h>
 
 // QT headers
 #include <QWidget>
+#include <QMetaType>
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QColor>
+#include <QImage>
 #include <QPen>
 #include <QPoint>
+#include <QRect>
+#include <QRgb>
+#include <QString>
+#include <QThread>
+#include <QVector>
 
 // Standard library headers
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <memory>
-#include <vector>
 #include <iostream>
 
+// The time budget is passed by reference to std::chrono::milliseconds so it needs a definition
+const int Line_router_paint_widget::route_time_budget_ms;
+
 Line_router_paint_widget::Line_router_paint_widget(const std::shared_ptr<Path_planner> path_planner,
                                                    QWidget* parent) : QWidget(parent),
-                                                                      // zero indexed coordinates
-                                                                      x_lower_bound(0),
-                                                                      y_lower_bound(0),
-                                                                      x_upper_bound(path_planner->get_width() - 1),
-                                                                      y_upper_bound(path_planner->get_height() - 1),
                                                                       start_point_set(false),
-                                                                      end_point_set(false),
-                                                                      start_point_marked(false),
-                                                                      path_planner(path_planner),
-                                                                      pixmap(path_planner->get_width(),
-                                                                             path_planner->get_height())
+                                                                      board(path_planner->get_width(),
+                                                                            path_planner->get_height(),
+                                                                            QImage::Format_RGB32),
+                                                                      line_color(Qt::lightGray),
+                                                                      worker(nullptr),
+                                                                      request_id(0),
+                                                                      search_heatmap_visible(false),
+                                                                      search_heatmap_color_by_path_cost(false),
+                                                                      search_statistics_set(false),
+                                                                      route_preview_enabled(false),
+                                                                      preview_id(0),
+                                                                      preview_pending(false)
 {
-    // Fill pixmap background
-    pixmap.fill(Qt::black);
+    // Fill board background
+    board.fill(Qt::black);
 
-    if (not this->path_planner)
+    if (not path_planner)
     {
         throw "Line_router_paint_widget::Line_router_paint_widget: Path planner is not set";
     }
+
+    // The board is opaque, Qt does not need to erase the background before a repaint
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    // Move the path planning to the worker thread. From now on the path planner is only used by the worker. The signals
+    // between the widget and the worker are queued since they live in different threads.
+    qRegisterMetaType<std::shared_ptr<const Cancellation_token>>();
+    qRegisterMetaType<QVector<QPoint>>();
+    qRegisterMetaType<Search_statistics>();
+    worker = new Line_router_worker(path_planner, line_halo_radius);
+    worker->moveToThread(&worker_thread);
+    connect(&worker_thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(this, &Line_router_paint_widget::route_requested, worker, &Line_router_worker::route);
+    connect(worker, &Line_router_worker::route_finished, this, &Line_router_paint_widget::draw_routed_line);
+    connect(this, &Line_router_paint_widget::preview_requested, worker, &Line_router_worker::preview);
+    connect(worker, &Line_router_worker::preview_finished, this, &Line_router_paint_widget::draw_route_preview);
+    connect(this, &Line_router_paint_widget::search_heatmap_changed, worker, &Line_router_worker::set_search_heatmap);
+    connect(worker, &Line_router_worker::search_profiled, this, &Line_router_paint_widget::show_search_profile);
+    worker_thread.start();
 }
 
 Line_router_paint_widget::~Line_router_paint_widget()
 {
+    // Stop a running search and wait for the worker thread to finish, the worker is deleted when it has finished
+    cancel_routing();
+    clear_route_preview();
+    worker_thread.quit();
+    worker_thread.wait();
+}
+
+void Line_router_paint_widget::set_search_heatmap_visible(const bool visible)
+{
+    search_heatmap_visible = visible;
+    emit search_heatmap_changed(search_heatmap_visible, search_heatmap_color_by_path_cost);
+
+    if (not visible)
+    {
+        // Remove the heatmap and the HUD
+        search_heatmap = QImage();
+        search_statistics_set = false;
+        update();
+    }
+}
+
+void Line_router_paint_widget::set_search_heatmap_color_by_path_cost(const bool color_by_path_cost)
+{
+    search_heatmap_color_by_path_cost = color_by_path_cost;
+    emit search_heatmap_changed(search_heatmap_visible, search_heatmap_color_by_path_cost);
+}
+
+void Line_router_paint_widget::set_route_preview_enabled(const bool enabled)
+{
+    route_preview_enabled = enabled;
+
+    // The mouse moves are only sent to the widget without a pressed button if the mouse is tracked
+    setMouseTracking(enabled);
+
+    if (not enabled)
+    {
+        clear_route_preview();
+    }
 }
 
 void Line_router_paint_widget::mousePressEvent(QMouseEvent* mouse_event)
 {
     // Maximum coordinate is one less than width and height
-    if (mouse_event->pos().x() < 0 || mouse_event->pos().x() > pixmap.width() - 1 ||
-        mouse_event->pos().y() < 0 || mouse_event->pos().y() > pixmap.height() - 1)
+    if (mouse_event->pos().x() < 0 || mouse_event->pos().x() > board.width() - 1 ||
+        mouse_event->pos().y() < 0 || mouse_event->pos().y() > board.height() - 1)
     {
         std::cout << "WARNING: Position out of bounds" << std::endl;
         return;
@@ -63,91 +136,189 @@ void Line_router_paint_widget::mousePressEvent(QMouseEvent* mouse_event)
 
     if (not start_point_set)
     {
-        // If start point is not set, do it now and run a paintEvent
+        // A new line is started, there is no need to finish the previous search
+        cancel_routing();
+
+        // Set the start point and repaint the marker
         line_start = mouse_event->pos();
         start_point_set = true;
-        update(); // This runs a paintEvent
+        update(get_marker_rect(line_start)); // This runs a paintEvent for the marker only
     }
     else
     {
-        // If start point is set, set the end point and run a paintEvent
-        line_end = mouse_event->pos();
-        end_point_set = true;
-        update(); // This runs a paintEvent
+        // The routed line replaces the preview
+        clear_route_preview();
+
+        // Ask the worker to route the line to the end point. The line is drawn when the worker is done.
+        request_id++;
+        cancellation_token = std::make_shared<Cancellation_token>(std::chrono::milliseconds(route_time_budget_ms));
+        emit route_requested(request_id, line_start, mouse_event->pos(), cancellation_token);
+
+        // Remove the start point marker
+        start_point_set = false;
+        update(get_marker_rect(line_start));
     }
 }
 
-void Line_router_paint_widget::paintEvent(QPaintEvent*)
+void Line_router_paint_widget::mouseMoveEvent(QMouseEvent* mouse_event)
 {
-    if (not path_planner)
+    if (not route_preview_enabled || not start_point_set)
+    {
+        return;
+    }
+
+    // The mouse is often moved outside of the board, so there is no warning
+    if (mouse_event->pos().x() < 0 || mouse_event->pos().x() > board.width() - 1 ||
+        mouse_event->pos().y() < 0 || mouse_event->pos().y() > board.height() - 1)
     {
-        std::cout << "ERROR: Path planner not set" << std::endl;
         return;
     }
 
+    // Only one preview is searched at a time, a pending preview asks for the latest end point when it is done
+    preview_end = mouse_event->pos();
+    if (not preview_pending)
+    {
+        request_route_preview();
+    }
+}
+
+void Line_router_paint_widget::paintEvent(QPaintEvent* paint_event)
+{
     QPainter painter(this);
 
-    if (start_point_set && not start_point_marked)
+    // Only draw the part of the board that needs to be repainted
+    const QRect dirty_rect = paint_event->rect();
+    painter.drawImage(dirty_rect, board, dirty_rect);
+
+    if (not search_heatmap.isNull())
     {
-        // Draw current pixmap
-        painter.drawPixmap(0, 0, pixmap);
+        // The heatmap is translucent and blended on top of the board
+        painter.drawImage(dirty_rect, search_heatmap, dirty_rect);
+    }
 
-        // Mark first start point, this will not be stored in the pixmap
+    if (not preview_line.isEmpty() && dirty_rect.intersects(preview_rect))
+    {
+        // The preview is not written to the board since it is removed again on the next mouse move
+        painter.setPen(QColor(255, 255, 255, preview_alpha));
+        painter.drawPoints(preview_line.constData(), preview_line.size());
+    }
+
+    if (start_point_set && dirty_rect.intersects(get_marker_rect(line_start)))
+    {
+        // Mark the start point if start point is set
         mark_point(painter, line_start);
+    }
 
-        start_point_marked = true;
+    if (search_statistics_set && dirty_rect.intersects(get_hud_rect()))
+    {
+        draw_hud(painter);
     }
-    else if (end_point_set)
+}
+
+void Line_router_paint_widget::draw_routed_line(const int request_id,
+                                                const QVector<QPoint>& path,
+                                                const QRect& dirty_rect)
+{
+    if (request_id == this->request_id)
     {
-        // End point set, draw the line if possible to find a clear path
+        // The latest request is done
+        cancellation_token.reset();
+    }
 
-        QPainter pixmap_painter(&pixmap);
+    // A path is drawn even if it belongs to an older request since it has already been committed to the path planner
+    if (path.isEmpty())
+    {
+        return;
+    }
 
-        // Rotate the colors
-        static Qt::GlobalColor color = Qt::lightGray;
-        color = Qt::GlobalColor(3 + ((color-2) % 16));
-        QPen pen(color);
-        pixmap_painter.setPen(pen);
+    // Rotate the colors
+    line_color = Qt::GlobalColor(3 + ((line_color-2) % 16));
+    draw_path(path, QColor(line_color).rgb());
 
-        // Set the start and end coordinates
-        const Coord_point_2D start(line_start.x(), line_start.y());
-        const Coord_point_2D end(line_end.x(), line_end.y());
+    update(dirty_rect);
+}
 
-        // Run path planning to find the path
-        std::vector<Coord_point_2D> path;
-        if (path_planner->get_path(start, end, path))
-        {
-            // If successful, draw all points in path
-            for (const Coord_point_2D& point : path)
-            {
-                // Set point to blocked
-                path_planner->set_blocked(point.get_x(), point.get_y());
-                // Also set neighbor points to blocked to make it clear that the lines are not intersecting
-                block_neighbors(point);
+void Line_router_paint_widget::draw_route_preview(const int preview_id, const QVector<QPoint>& path)
+{
+    // A preview of an older start point or one that has been cleared is dropped
+    if (preview_id != this->preview_id || not preview_pending)
+    {
+        return;
+    }
 
-                // Draw point, this will update the pixmap
-                pixmap_painter.drawPoint(point.get_x(), point.get_y());
-            }
-        }
+    preview_pending = false;
+    preview_cancellation_token.reset();
 
-        // Draw the pixmap here to reset the marked point if the path planning were unsuccessful
-        painter.drawPixmap(0, 0, pixmap);
+    // Repaint where the old preview was and where the new one is
+    update(preview_rect);
+    preview_line = path;
+    preview_rect = get_bounding_rect(preview_line);
+    update(preview_rect);
 
-        // Reset the states to wait for the first point to be set again
-        start_point_set = false;
-        end_point_set = false;
-        start_point_marked = false;
+    if (preview_end != requested_preview_end)
+    {
+        // The mouse has moved while the preview was searched
+        request_route_preview();
     }
-    else
+}
+
+void Line_router_paint_widget::show_search_profile(const int /* request_id */,
+                                                   const QImage& heatmap,
+                                                   const Search_statistics& search_statistics)
+{
+    // A profile can arrive after the heatmap has been hidden, it is then dropped
+    if (not search_heatmap_visible)
+    {
+        return;
+    }
+
+    // The heatmap covers the whole board
+    search_heatmap = heatmap;
+    this->search_statistics = search_statistics;
+    search_statistics_set = true;
+    update();
+}
+
+void Line_router_paint_widget::cancel_routing()
+{
+    if (cancellation_token)
+    {
+        cancellation_token->cancel();
+        cancellation_token.reset();
+    }
+}
+
+void Line_router_paint_widget::request_route_preview()
+{
+    preview_id++;
+    preview_pending = true;
+    requested_preview_end = preview_end;
+    preview_cancellation_token = std::make_shared<Cancellation_token>();
+    emit preview_requested(preview_id, line_start, requested_preview_end, preview_cancellation_token);
+}
+
+void Line_router_paint_widget::clear_route_preview()
+{
+    if (preview_cancellation_token)
     {
-        // Keep the pixmap even if there is a mouse click outside of the window
-        painter.drawPixmap(0, 0, pixmap);
+        preview_cancellation_token->cancel();
+        preview_cancellation_token.reset();
+    }
+    preview_pending = false;
 
-        if (start_point_set)
-        {
-            // Mark the start point if start point is set
-            mark_point(painter, line_start);
-        }
+    update(preview_rect);
+    preview_line.clear();
+    preview_rect = QRect();
+}
+
+void Line_router_paint_widget::draw_path(const QVector<QPoint>& path, const QRgb color)
+{
+    // Write the pixels directly through the scanline pointers of the board. This does not detach or convert the image
+    // as long as it is not shared.
+    for (const QPoint& point : path)
+    {
+        QRgb* const scanline = reinterpret_cast<QRgb*>(board.scanLine(point.y()));
+        scanline[point.x()] = color;
     }
 }
 
@@ -156,7 +327,7 @@ void Line_router_paint_widget::mark_point(QPainter& painter, const QPoint& point
     // Create a red round pen to mark the point
     QPen pen;
     pen.setBrush(Qt::red);
-    pen.setWidth(10);
+    pen.setWidth(marker_width);
     pen.setCapStyle(Qt::RoundCap);
     pen.setJoinStyle(Qt::RoundJoin);
 
@@ -167,52 +338,59 @@ void Line_router_paint_widget::mark_point(QPainter& painter, const QPoint& point
     painter.drawPoint(point);
 }
 
-void Line_router_paint_widget::block_neighbors(const Coord_point_2D& point)
+QRect Line_router_paint_widget::get_marker_rect(const QPoint& point) const
 {
-    if (point.get_x() > x_lower_bound)
-    {
-        // x is within lower bound, block left neighbor
-        path_planner->set_blocked(point.get_x()-1, point.get_y());
+    // Add one pixel on each side for the antialiasing of the round cap
+    const int half_size = marker_width / 2 + 1;
+    return QRect(point.x() - half_size, point.y() - half_size, 2 * half_size + 1, 2 * half_size + 1);
+}
 
-        if (point.get_y() > y_lower_bound)
-        {
-            // y is also within lower bound, block upper left neighbor
-            path_planner->set_blocked(point.get_x()-1, point.get_y()-1);
-        }
-        if (point.get_y() < y_upper_bound)
-        {
-            // y is within upper bound, block lower left neighbor
-            path_planner->set_blocked(point.get_x()-1, point.get_y()+1);
-        }
-    }
+void Line_router_paint_widget::draw_hud(QPainter& painter) const
+{
+    const QRect hud_rect = get_hud_rect();
+    painter.fillRect(hud_rect, QColor(0, 0, 0, 180));
 
-    if (point.get_y() > y_lower_bound)
-    {
-        // y is within lower bound, block upper neighbor
-        path_planner->set_blocked(point.get_x(), point.get_y()-1);
+    const QString text = QString("Expanded: %1  Generated: %2  Visited: %3\n"
+                                 "Heap pushes: %4  Pops: %5  Peak: %6\n"
+                                 "Reset: %7 ms  Search: %8 ms  Path: %9 ms")
+                                 .arg(search_statistics.number_of_expanded_points)
+                                 .arg(search_statistics.number_of_generated_points)
+                                 .arg(search_statistics.number_of_visited_points)
+                                 .arg(search_statistics.number_of_heap_pushes)
+                                 .arg(search_statistics.number_of_heap_pops)
+                                 .arg(search_statistics.peak_points_to_visit)
+                                 .arg(search_statistics.reset_time_ms, 0, 'f', 3)
+                                 .arg(search_statistics.search_time_ms, 0, 'f', 3)
+                                 .arg(search_statistics.reconstruct_time_ms, 0, 'f', 3);
 
-        if (point.get_x() < x_upper_bound)
-        {
-            // x is within upper bound, block upper right neighbor
-            path_planner->set_blocked(point.get_x()+1, point.get_y()-1);
-        }
-    }
+    painter.setPen(Qt::white);
+    painter.drawText(hud_rect.adjusted(hud_margin, hud_margin, -hud_margin, -hud_margin),
+                     Qt::AlignLeft | Qt::AlignTop, text);
+}
 
-    if (point.get_x() < x_upper_bound)
-    {
-        // x is within upper bound, block right neighbor
-        path_planner->set_blocked(point.get_x()+1, point.get_y());
+QRect Line_router_paint_widget::get_hud_rect() const
+{
+    return QRect(hud_margin, hud_margin, hud_width, hud_height);
+}
 
-        if (point.get_y() < y_upper_bound)
-        {
-            // y is also within upper bound, block lower right neighbor
-            path_planner->set_blocked(point.get_x()+1, point.get_y()+1);
-        }
+QRect Line_router_paint_widget::get_bounding_rect(const QVector<QPoint>& path)
+{
+    if (path.isEmpty())
+    {
+        return QRect();
     }
 
-    if (point.get_y() < y_upper_bound)
+    int min_x = path.front().x();
+    int min_y = path.front().y();
+    int max_x = min_x;
+    int max_y = min_y;
+    for (const QPoint& point : path)
     {
-        // y is within upper bound, block lower neighbor
-        path_planner->set_blocked(point.get_x(), point.get_y()+1);
+        min_x = std::min(min_x, point.x());
+        min_y = std::min(min_y, point.y());
+        max_x = std::max(max_x, point.x());
+        max_y = std::max(max_y, point.y());
     }
+
+    return QRect(QPoint(min_x, min_y), QPoint(max_x, max_y));
 }
@@ -10,27 +10,43 @@
 #define LINE_ROUTER_UI_LINE_ROUTER_LINE_ROUTER_PAINT_WIDGET_H_
 
 #include <Path_planner.h>
-#include <Coord_point_2D.h>
+#include <Cancellation_token.h>
+#include <Line_router_worker.h>
+#include <Search_statistics.h>
 
 // QT headers
 #include <QWidget>
 #include <QMouseEvent>
 #include <QPaintEvent>
-#include <QPixmap>
+#include <QImage>
 #include <QPoint>
 #include <QPainter>
+#include <QRect>
+#include <QRgb>
+#include <QThread>
+#include <QVector>
 
 // Standard library headers
 #include <cstddef>
 #include <memory>
 
-// The Line_router_paint_widget sets up the pixel map environment where it is possible to draw lines. It will wait for a
-// mouse click on a point that is inside of the pixel map and set that point to be the start point. Then the start point
-// is marked with a red dot on the pixel map. The second mouse click inside the pixel map will set the end point and
-// will pass the start and end point to the Path_planner. If the Path_planner is successful in finding a path from start
-// to end a line will be drawn on the given path and all the points passed will be set to blocked in the Path_planner.
+// The Line_router_paint_widget sets up the board image where it is possible to draw lines. It will wait for a mouse
+// click on a point that is inside of the board and set that point to be the start point. Then the start point is
+// marked with a red dot on the board. The second mouse click inside the board will set the end point and will pass the
+// start and end point to the Path_planner. If the Path_planner is successful in finding a path from start to end a line
+// will be drawn on the given path and the path will be committed to the Path_planner.
 // If the Path_planner is unsuccessful in finding a path it will just unmark the first point and wait for the first
 // mouse click again.
+// The path planning is done by a Line_router_worker on a worker thread, so the GUI is never blocked by a search. A
+// search that takes longer than the time budget is given up, and a new click cancels a search that is still running.
+// The lines are written directly to the pixels of the board image and only the rectangles that have changed, i.e. the
+// bounding rectangle of a new line and the start point marker, are repainted.
+// For profiling, the points expanded by the last search can be shown as a translucent heatmap on top of the board,
+// together with a HUD in the upper left corner with the number of expanded points and the search times.
+// With the route preview enabled, the route from the start point to the mouse is shown while the mouse moves. Only one
+// preview is searched at a time: the mouse moves while it is searched are merged and the latest end point is
+// previewed when it is done. The previews of one start point reuse one search tree in the worker, see
+// Preview_tree_planner.
 class Line_router_paint_widget : public QWidget
 {
     Q_OBJECT
@@ -39,41 +55,133 @@ public:
                                       QWidget* parent = 0);
     ~Line_router_paint_widget();
 
+signals:
+    // Ask the worker to route a line
+    void route_requested(const int request_id,
+                         const QPoint& start,
+                         const QPoint& end,
+                         const std::shared_ptr<const Cancellation_token>& cancellation_token);
+
+    // Ask the worker to preview a route without committing it
+    void preview_requested(const int preview_id,
+                           const QPoint& start,
+                           const QPoint& end,
+                           const std::shared_ptr<const Cancellation_token>& cancellation_token);
+
+    // Ask the worker to record the search heatmap or to stop recording it
+    void search_heatmap_changed(const bool enabled, const bool color_by_path_cost);
+
+public slots:
+    // Show or hide the heatmap of the points expanded by the last search. It is shown from the next search.
+    void set_search_heatmap_visible(const bool visible);
+
+    // Color the heatmap by the path cost from the start point instead of by the expansion order
+    void set_search_heatmap_color_by_path_cost(const bool color_by_path_cost);
+
+    // Show the route from the start point to the mouse while the mouse moves
+    void set_route_preview_enabled(const bool enabled);
+
 protected:
     // Enter this function when a mouse click happens
     void mousePressEvent(QMouseEvent* mouse_event) override;
 
-    // Trigger paint event based on mouse clicks
+    // Enter this function when the mouse moves, only tracked while the route preview is enabled
+    void mouseMoveEvent(QMouseEvent* mouse_event) override;
+
+    // Repaint the part of the board that has changed
     void paintEvent(QPaintEvent* paint_event) override;
 
+private slots:
+    // Draw a line routed by the worker. The path is empty if no path was found or if the request was cancelled.
+    void draw_routed_line(const int request_id, const QVector<QPoint>& path, const QRect& dirty_rect);
+
+    // Draw a route preview from the worker and ask for the next one if the mouse has moved since it was asked for
+    void draw_route_preview(const int preview_id, const QVector<QPoint>& path);
+
+    // Show the heatmap and the statistics of the last search
+    void show_search_profile(const int request_id, const QImage& heatmap, const Search_statistics& search_statistics);
+
 private:
-    // Lower and upper bounds of the pixmap
-    size_t x_lower_bound;
-    size_t y_lower_bound;
-    size_t x_upper_bound;
-    size_t y_upper_bound;
+    // The number of points around a drawn line that are blocked for later lines
+    static const size_t line_halo_radius = 1;
+
+    // The time a search may take before it is given up
+    static const int route_time_budget_ms = 5000;
+
+    // The width in pixels of the start point marker
+    static const int marker_width = 10;
+
+    // The alpha of the route preview, the board is seen through it
+    static const int preview_alpha = 160;
 
-    // Bools to keep track on what state the widget is in
+    // The position and size in pixels of the search statistics HUD
+    static const int hud_margin = 4;
+    static const int hud_width = 300;
+    static const int hud_height = 56;
+
+    // Bool to keep track on what state the widget is in
     bool start_point_set;
-    bool end_point_set;
-    bool start_point_marked;
 
-    std::shared_ptr<Path_planner> path_planner;
+    // Board image will contain the drawn lines, one pixel per grid point
+    QImage board;
 
-    // Pixmap will contain the drawn lines
-    QPixmap pixmap;
+    // The color of the last drawn line, the colors are rotated for every line
+    Qt::GlobalColor line_color;
 
-    // Start and end points that will be set by mouse clicks
+    // Start point that will be set by mouse clicks
     QPoint line_start;
-    QPoint line_end;
 
-    // This will mark a point on the Widget. NOTE: It will not be on the pixmap.
+    // The worker lives in the worker thread and owns the Path_planner
+    QThread worker_thread;
+    Line_router_worker* worker;
+
+    // The id and the token of the latest route request
+    int request_id;
+    std::shared_ptr<Cancellation_token> cancellation_token;
+
+    // The heatmap of the last search and its statistics, only set while the heatmap is visible
+    bool search_heatmap_visible;
+    bool search_heatmap_color_by_path_cost;
+    QImage search_heatmap;
+    bool search_statistics_set;
+    Search_statistics search_statistics;
+
+    // The route preview. The end point is the latest mouse position and the requested end point the one of the preview
+    // being searched, if a preview is pending.
+    bool route_preview_enabled;
+    int preview_id;
+    bool preview_pending;
+    QPoint preview_end;
+    QPoint requested_preview_end;
+    std::shared_ptr<Cancellation_token> preview_cancellation_token;
+    QVector<QPoint> preview_line;
+    QRect preview_rect;
+
+    // Cancel the latest route request if it is still running
+    void cancel_routing();
+
+    // Ask the worker to preview the route from the start point to the latest mouse position
+    void request_route_preview();
+
+    // Cancel a pending preview and remove the shown one
+    void clear_route_preview();
+
+    // Write the points of a path directly to the board pixels
+    void draw_path(const QVector<QPoint>& path, const QRgb color);
+
+    // This will mark a point on the Widget. NOTE: It will not be on the board.
     void mark_point(QPainter& painter, const QPoint& point);
 
-    // Block horizontal, vertical and diagonal neighbors for a given point. This is used to make it more clear that the
-    // lines does not intersect. The side-effect is that the path planner will not find a path in a one pixel width
-    // corridor.
-    void block_neighbors(const Coord_point_2D& point);
+    // The rectangle covered by the marker of a point
+    QRect get_marker_rect(const QPoint& point) const;
+
+    // Draw the statistics of the last search
+    void draw_hud(QPainter& painter) const;
+
+    QRect get_hud_rect() const;
+
+    // The bounding rectangle of the points of a path
+    static QRect get_bounding_rect(const QVector<QPoint>& path);
 };
 
 #endif // LINE_ROUTER_UI_LINE_ROUTER_LINE_ROUTER_PAINT_WIDGET_H_
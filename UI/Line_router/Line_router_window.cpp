@@ -16,7 +16,9 @@
 // QT headers
 #include <QWidget>
 #include <QMainWindow>
+#include <QAction>
 #include <QHBoxLayout>
+#include <QMenuBar>
 
 // Standard library headers
 #include <cstddef>
@@ -33,10 +35,19 @@ Line_router_window::Line_router_window(std::shared_ptr<Path_planner> path_planne
 
     // Make the window a bit bigger than the grid
     const size_t window_width = path_planner->get_width() + 20;
-    const size_t window_height = path_planner->get_height() + 20;
+    const size_t window_height = path_planner->get_height() + 20 + ui->menuBar->sizeHint().height();
     setGeometry(0, 0, window_width, window_height);
 
-    hbox->addWidget(new Line_router_paint_widget(path_planner));
+    Line_router_paint_widget* paint_widget = new Line_router_paint_widget(path_planner);
+    hbox->addWidget(paint_widget);
+
+    // The View menu toggles the search heatmap and the route preview of the paint widget
+    connect(ui->actionShow_search_heatmap, &QAction::toggled,
+            paint_widget, &Line_router_paint_widget::set_search_heatmap_visible);
+    connect(ui->actionColor_heatmap_by_path_cost, &QAction::toggled,
+            paint_widget, &Line_router_paint_widget::set_search_heatmap_color_by_path_cost);
+    connect(ui->actionShow_route_preview, &QAction::toggled,
+            paint_widget, &Line_router_paint_widget::set_route_preview_enabled);
 }
 
 Line_router_window::~Line_router_window()
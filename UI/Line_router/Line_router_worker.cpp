@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <Line_router_worker.h>
+#include <Path_planner.h>
+#include <Cancellation_token.h>
+#include <Coord_point_2D.h>
+#include <Coord_rectangle_2D.h>
+#include <Expansion_trace.h>
+#include <Preview_tree_planner.h>
+
+// QT headers
+#include <QColor>
+#include <QImage>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <QRgb>
+#include <QVector>
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+Line_router_worker::Line_router_worker(const std::shared_ptr<Path_planner> path_planner,
+                                       const size_t line_halo_radius) : QObject(),
+                                                                        path_planner(path_planner),
+                                                                        preview_planner(nullptr),
+                                                                        line_halo_radius(line_halo_radius),
+                                                                        search_heatmap_enabled(false),
+                                                                        color_by_path_cost(false)
+{
+    if (not this->path_planner)
+    {
+        throw "Line_router_worker::Line_router_worker: Path planner is not set";
+    }
+
+    // The preview planner shares the availability grid, so it sees every committed line
+    preview_planner.reset(new Preview_tree_planner(this->path_planner->get_availability_grid()));
+}
+
+Line_router_worker::~Line_router_worker()
+{
+}
+
+void Line_router_worker::route(const int request_id,
+                               const QPoint& start,
+                               const QPoint& end,
+                               const std::shared_ptr<const Cancellation_token>& cancellation_token)
+{
+    QVector<QPoint> line;
+    QRect dirty_rect;
+
+    // A request that was cancelled while it was queued is not started at all
+    if (not cancellation_token->is_cancelled())
+    {
+        path_planner->set_cancellation_token(cancellation_token);
+
+        std::vector<Coord_point_2D> path;
+        if (path_planner->get_path(Coord_point_2D(start.x(), start.y()), Coord_point_2D(end.x(), end.y()), path))
+        {
+            // Block the path and its neighbor points to make it clear that the lines are not intersecting. The
+            // side-effect is that the path planner will not find a path in a one pixel width corridor.
+            const Coord_rectangle_2D rectangle = path_planner->commit_path(path, line_halo_radius);
+            dirty_rect = QRect(rectangle.get_min_x(), rectangle.get_min_y(),
+                               rectangle.get_width(), rectangle.get_height());
+
+            line.reserve(path.size());
+            for (const Coord_point_2D& point : path)
+            {
+                line.push_back(QPoint(point.get_x(), point.get_y()));
+            }
+        }
+
+        path_planner->set_cancellation_token(nullptr);
+
+        if (search_heatmap_enabled)
+        {
+            emit search_profiled(request_id, create_search_heatmap(), path_planner->get_search_statistics());
+        }
+    }
+
+    emit route_finished(request_id, line, dirty_rect);
+}
+
+void Line_router_worker::preview(const int preview_id,
+                                 const QPoint& start,
+                                 const QPoint& end,
+                                 const std::shared_ptr<const Cancellation_token>& cancellation_token)
+{
+    QVector<QPoint> line;
+
+    // A preview that was cancelled while it was queued is not started at all
+    if (not cancellation_token->is_cancelled())
+    {
+        // The path planner may have been given a new availability grid
+        if (preview_planner->get_availability_grid() != path_planner->get_availability_grid())
+        {
+            preview_planner->set_availability_grid(path_planner->get_availability_grid());
+        }
+
+        preview_planner->set_cancellation_token(cancellation_token);
+
+        std::vector<Coord_point_2D> path;
+        if (preview_planner->get_path(Coord_point_2D(start.x(), start.y()), Coord_point_2D(end.x(), end.y()), path))
+        {
+            line.reserve(path.size());
+            for (const Coord_point_2D& point : path)
+            {
+                line.push_back(QPoint(point.get_x(), point.get_y()));
+            }
+        }
+
+        preview_planner->set_cancellation_token(nullptr);
+    }
+
+    emit preview_finished(preview_id, line);
+}
+
+void Line_router_worker::set_search_heatmap(const bool enabled, const bool color_by_path_cost)
+{
+    search_heatmap_enabled = enabled;
+    this->color_by_path_cost = color_by_path_cost;
+
+    // The trace and the statistics are only collected while the heatmap is shown, so the searches are not slowed
+    // down otherwise
+    path_planner->set_expansion_trace_enabled(enabled);
+    path_planner->set_search_statistics_enabled(enabled);
+}
+
+QImage Line_router_worker::create_search_heatmap() const
+{
+    const size_t width = path_planner->get_width();
+    QImage heatmap(width, path_planner->get_height(), QImage::Format_ARGB32_Premultiplied);
+    heatmap.fill(Qt::transparent);
+
+    const Expansion_trace& expansion_trace = path_planner->get_expansion_trace();
+    if (expansion_trace.empty())
+    {
+        return heatmap;
+    }
+
+    // Scale the expansion order or the path cost to [0, 1]
+    float max_path_cost = 0.0f;
+    for (const Expanded_point& expanded_point : expansion_trace)
+    {
+        max_path_cost = std::max(max_path_cost, expanded_point.path_cost);
+    }
+    const float max_value = color_by_path_cost ? max_path_cost : static_cast<float>(expansion_trace.size() - 1);
+
+    for (size_t order = 0; order < expansion_trace.size(); order++)
+    {
+        const Expanded_point& expanded_point = expansion_trace[order];
+        const float value = color_by_path_cost ? expanded_point.path_cost : static_cast<float>(order);
+        const float scaled_value = max_value > 0.0f ? value / max_value : 0.0f;
+        const QColor color = QColor::fromHsvF(heatmap_max_hue * (1.0f - scaled_value), 1.0f, 1.0f, heatmap_alpha);
+
+        // Write the pixels directly like the lines of the board
+        QRgb* const scanline = reinterpret_cast<QRgb*>(heatmap.scanLine(expanded_point.flat_index / width));
+        scanline[expanded_point.flat_index % width] = qPremultiply(color.rgba());
+    }
+
+    return heatmap;
+}
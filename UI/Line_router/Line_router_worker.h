@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ *  Created on: Apr 21, 2019
+ *      Author: Jakob Almqvist
+ *
+ *  Copyright (C) 2019 Jakob Almqvist. All rights reserved.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef LINE_ROUTER_UI_LINE_ROUTER_LINE_ROUTER_WORKER_H_
+#define LINE_ROUTER_UI_LINE_ROUTER_LINE_ROUTER_WORKER_H_
+
+#include <Path_planner.h>
+#include <Cancellation_token.h>
+#include <Preview_tree_planner.h>
+#include <Search_statistics.h>
+
+// QT headers
+#include <QImage>
+#include <QMetaType>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+
+// The Line_router_worker runs the path planning on a worker thread so that the GUI thread is never blocked by a search.
+// It owns the Path_planner once it has been moved to its thread: it routes a line, commits the found path to the
+// Path_planner and emits the path with a queued signal. Every request has a Cancellation_token with a time budget that
+// the GUI thread can cancel at any time, e.g. when the user starts a new line.
+// When the search heatmap is enabled the worker also records the points expanded by every search and emits them as a
+// translucent heatmap image together with the search statistics, so the image is created off the GUI thread.
+// The route preview, shown while the mouse moves after the start point has been set, is searched by a
+// Preview_tree_planner on the same availability grid. It keeps the search tree of the start point, so most previews
+// only read the path from the tree. A committed line changes the availability grid and the next preview starts a new
+// tree.
+class Line_router_worker : public QObject
+{
+    Q_OBJECT
+public:
+    Line_router_worker(const std::shared_ptr<Path_planner> path_planner, const size_t line_halo_radius);
+    ~Line_router_worker();
+
+public slots:
+    // Route a line from start to end. route_finished is always emitted with the same request_id, with an empty path if
+    // no path was found or if the request was cancelled.
+    void route(const int request_id,
+               const QPoint& start,
+               const QPoint& end,
+               const std::shared_ptr<const Cancellation_token>& cancellation_token);
+
+    // Get the preview of a route from start to end without committing it. preview_finished is always emitted with the
+    // same preview_id, with an empty path if no path was found or if the preview was cancelled.
+    void preview(const int preview_id,
+                 const QPoint& start,
+                 const QPoint& end,
+                 const std::shared_ptr<const Cancellation_token>& cancellation_token);
+
+    // Enable or disable the search heatmap. The expanded points are colored by their expansion order, from blue for
+    // the first to red for the last, or by their path cost from the start point if color_by_path_cost is set.
+    void set_search_heatmap(const bool enabled, const bool color_by_path_cost);
+
+signals:
+    // The routed path and the rectangle of the committed path and its halo
+    void route_finished(const int request_id, const QVector<QPoint>& path, const QRect& dirty_rect);
+
+    // The previewed path
+    void preview_finished(const int preview_id, const QVector<QPoint>& path);
+
+    // The heatmap of the points expanded by the search of a request and its statistics. Only emitted if the search
+    // heatmap is enabled and the request was searched, before route_finished of the same request.
+    void search_profiled(const int request_id, const QImage& heatmap, const Search_statistics& search_statistics);
+
+private:
+    // The alpha of the heatmap colors, the board is seen through the heatmap
+    static constexpr float heatmap_alpha = 0.55f;
+
+    // The hue of the first expanded point or the point with the lowest path cost, the hue goes down to red
+    static constexpr float heatmap_max_hue = 0.66f;
+
+    std::shared_ptr<Path_planner> path_planner;
+
+    // Keeps the search tree of the start point of the previews
+    std::unique_ptr<Preview_tree_planner> preview_planner;
+
+    // The number of points around a routed line that are blocked for later lines
+    const size_t line_halo_radius;
+
+    bool search_heatmap_enabled;
+    bool color_by_path_cost;
+
+    // Create the heatmap of the points expanded by the last search
+    QImage create_search_heatmap() const;
+};
+
+// Needed to pass the token with a queued signal to the worker thread
+Q_DECLARE_METATYPE(std::shared_ptr<const Cancellation_token>)
+Q_DECLARE_METATYPE(Search_statistics)
+
+#endif // LINE_ROUTER_UI_LINE_ROUTER_LINE_ROUTER_WORKER_H_